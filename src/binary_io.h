@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+/**
+ * Writes fixed-size little-endian integers and length-prefixed strings, for save
+ * data where parsing JSON is too slow.
+ */
+class binary_writer
+{
+    public:
+        explicit binary_writer( std::ostream &out ) : out( out ) {}
+
+        template<typename T>
+        void write( const T value ) {
+            static_assert( std::is_integral_v<T>, "only integers can be written" );
+            using unsigned_t = std::make_unsigned_t<T>;
+            const unsigned_t bits = static_cast<unsigned_t>( value );
+            char bytes[sizeof( T )];
+            for( size_t i = 0; i < sizeof( T ); i++ ) {
+                bytes[i] = static_cast<char>( ( bits >> ( 8 * i ) ) & 0xff );
+            }
+            out.write( bytes, sizeof( T ) );
+        }
+
+        void write_string( const std::string &str ) {
+            write<uint32_t>( str.size() );
+            out.write( str.data(), str.size() );
+        }
+
+        void write_bytes( const char *data, size_t size ) {
+            out.write( data, size );
+        }
+
+    private:
+        std::ostream &out;
+};
+
+/**
+ * Reads what @ref binary_writer wrote. Running out of data throws, so truncated
+ * files can't be mistaken for valid ones.
+ */
+class binary_reader
+{
+    public:
+        explicit binary_reader( std::istream &in ) : in( in ) {}
+
+        template<typename T>
+        T read() {
+            static_assert( std::is_integral_v<T>, "only integers can be read" );
+            using unsigned_t = std::make_unsigned_t<T>;
+            unsigned char bytes[sizeof( T )];
+            read_bytes( reinterpret_cast<char *>( bytes ), sizeof( T ) );
+            unsigned_t bits = 0;
+            for( size_t i = 0; i < sizeof( T ); i++ ) {
+                bits |= static_cast<unsigned_t>( bytes[i] ) << ( 8 * i );
+            }
+            return static_cast<T>( bits );
+        }
+
+        std::string read_string() {
+            std::string str( read<uint32_t>(), '\0' );
+            read_bytes( str.data(), str.size() );
+            return str;
+        }
+
+        void read_bytes( char *data, size_t size ) {
+            if( !in.read( data, size ) ) {
+                throw std::runtime_error( "unexpected end of binary data" );
+            }
+        }
+
+    private:
+        std::istream &in;
+};
@@ -17,6 +17,9 @@ bool fov_3d;
 bool static_z_effect = false;
 bool overmap_transparency = true;
 int fov_3d_z_range;
+bool parallel_map_cache = true;
+unsigned map_cache_task_count = 0;
+bool simd_shadowcasting = true;
 bool tile_iso;
 bool pixel_minimap_option = false;
 int PICKUP_RANGE;
@@ -59,6 +59,20 @@ extern bool fov_3d;
 /** 3D FoV range, in Z levels, in both directions. */
 extern int fov_3d_z_range;
 
+/** Rebuild the map caches of separate z-levels concurrently. */
+extern bool parallel_map_cache;
+/**
+ * How many tasks rebuild the map caches when @ref parallel_map_cache is set, or 0 for one per
+ * hardware thread. Does not correspond to any game option, tests set it to split the work
+ * even on a single core.
+ */
+extern unsigned map_cache_task_count;
+/**
+ * Scan rows of shadowcasting tiles with SSE2 where the target has it. Does not correspond to
+ * any game option, tests clear it to compare against the scalar scan.
+ */
+extern bool simd_shadowcasting;
+
 /** Using isometric tileset. */
 extern bool tile_iso;
 
@@ -403,6 +403,7 @@ void cata_tiles::load_tileset(
     loader.load( tileset_id, precheck, /*pump_events=*/pump_events );
     tileset_ptr = std::move( new_tileset_ptr );
     tileset_mod_list_stamp = mod_list;
+    clear_looks_like_cache();
 
     set_draw_scale( 16 );
 
@@ -413,6 +414,8 @@ void cata_tiles::reinit()
 {
     set_draw_scale( 16 );
     RenderClear( renderer );
+    // Game data might have been reloaded, which can change the looks_like chains
+    clear_looks_like_cache();
 }
 
 static void get_tile_information( const std::string &config_path, std::string &json_path,
@@ -1129,7 +1132,7 @@ void cata_tiles::set_draw_scale( float scale )
 std::optional<tile_search_result> cata_tiles::tile_type_search( const tile_search_params &tile )
 {
     auto [id, category, subcategory, subtile, rota] = tile;
-    std::optional<tile_lookup_res> res = find_tile_looks_like( id, category );
+    std::optional<tile_lookup_res> res = find_tile_looks_like_cached( id, category );
     const tile_type *tt = nullptr;
     if( res ) {
         tt = &( res->tile() );
@@ -2640,6 +2643,26 @@ cata_tiles::find_tile_looks_like_by_string_id( const std::string &id, TILE_CATEG
     return find_tile_looks_like( obj.looks_like, category, looks_like_jumps_limit - 1 );
 }
 
+auto cata_tiles::find_tile_looks_like_cached( const std::string &id,
+        TILE_CATEGORY category ) const -> std::optional<tile_lookup_res>
+{
+    auto &cache = looks_like_cache[season_of_year( calendar::turn )][category];
+    const auto iter = cache.find( id );
+    if( iter != cache.end() ) {
+        return iter->second;
+    }
+    return cache.emplace( id, find_tile_looks_like( id, category ) ).first->second;
+}
+
+void cata_tiles::clear_looks_like_cache()
+{
+    for( auto &season_cache : looks_like_cache ) {
+        for( auto &category_cache : season_cache ) {
+            category_cache.clear();
+        }
+    }
+}
+
 auto cata_tiles::find_tile_looks_like( const std::string &id, TILE_CATEGORY category,
                                        const int looks_like_jumps_limit ) const -> std::optional<tile_lookup_res>
 {
@@ -3315,7 +3338,7 @@ auto get_map_memory_of_at( const tripoint &p ) -> std::optional<memorized_terrai
     }
 
     const memorized_terrain_tile t = g->u.get_memorized_tile( get_map().getabs( p ) );
-    if( !string_id<T>( t.tile ).is_valid() ) {
+    if( !string_id<T>( t.tile.str() ).is_valid() ) {
         return std::nullopt;
     }
 
@@ -3330,11 +3353,11 @@ auto get_map_memory_of_at<vpart_info>( const tripoint &p ) -> std::optional<memo
     }
 
     const memorized_terrain_tile t = g->u.get_memorized_tile( get_map().getabs( p ) );
-    if( !t.tile.starts_with( "vp_" ) ) {
+    if( !t.tile.str().starts_with( "vp_" ) ) {
         return std::nullopt;
     }
 
-    const auto actual_part = t.tile.substr( 3 );
+    const auto actual_part = t.tile.str().substr( 3 );
     if( !string_id<vpart_info>( actual_part ).is_valid() ) {
         return std::nullopt;
     }
@@ -3496,7 +3519,7 @@ bool cata_tiles::draw_terrain( const tripoint &p, const lit_level ll, int &heigh
         const auto ret = get_ter_memory_at( p );
         if( ret.has_value() ) {
             const auto& [tile_id, subtile, rotation] = ret.value();
-            const tile_search_params tile { tile_id, C_TERRAIN, empty_string, subtile, rotation };
+            const tile_search_params tile { tile_id.str(), C_TERRAIN, empty_string, subtile, rotation };
             return draw_from_id_string(
                        tile, p, bgCol, fgCol,
                        lit_level::MEMORIZED, true, z_drop, false, height_3d );
@@ -3597,7 +3620,7 @@ bool cata_tiles::draw_furniture( const tripoint &p, const lit_level ll, int &hei
         const auto ret = get_furn_memory_at( p );
         if( ret.has_value() ) {
             const auto& [tile_id, subtile, rotation] = ret.value();
-            const tile_search_params tile { tile_id, C_FURNITURE, empty_string, subtile, rotation };
+            const tile_search_params tile { tile_id.str(), C_FURNITURE, empty_string, subtile, rotation };
             return draw_from_id_string(
                        tile, p, bgCol, fgCol,
                        lit_level::MEMORIZED, true, z_drop, false, height_3d );
@@ -3684,7 +3707,7 @@ bool cata_tiles::draw_trap( const tripoint &p, const lit_level ll, int &height_3
         const auto ret = get_trap_memory_at( p );
         if( ret.has_value() ) {
             const auto& [tile_id, subtile, rotation] = ret.value();
-            const tile_search_params tile2 { tile_id, C_TRAP, empty_string, subtile, rotation };
+            const tile_search_params tile2 { tile_id.str(), C_TRAP, empty_string, subtile, rotation };
             return draw_from_id_string(
                        tile2, p, bgCol, fgCol,
                        lit_level::MEMORIZED, true, z_drop, false, height_3d );
@@ -3878,7 +3901,7 @@ bool cata_tiles::draw_vpart( const tripoint &p, lit_level ll, int &height_3d,
         const auto ret = get_vpart_memory_at( p );
         if( ret.has_value() ) {
             const auto [tile_id, subtile, rotation] = ret.value();
-            const tile_search_params tile { tile_id, C_VEHICLE_PART, empty_string, subtile, rotation };
+            const tile_search_params tile { tile_id.str(), C_VEHICLE_PART, empty_string, subtile, rotation };
             return draw_from_id_string(
                        tile, p, bgCol, fgCol,
                        lit_level::MEMORIZED, true, z_drop, false, height_3d );
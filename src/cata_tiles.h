@@ -721,6 +721,11 @@ class cata_tiles
 
         bool draw_item_highlight( const tripoint &pos );
 
+        /** @ref find_tile_looks_like with the default jump limit, remembered in @ref looks_like_cache. */
+        auto find_tile_looks_like_cached( const std::string &id,
+                                          TILE_CATEGORY category ) const -> std::optional<tile_lookup_res>;
+        void clear_looks_like_cache();
+
     public:
         auto find_tile_looks_like( const std::string &id, TILE_CATEGORY category,
                                    int looks_like_jumps_limit = 10 ) const -> std::optional<tile_lookup_res>;
@@ -884,6 +889,13 @@ class cata_tiles
         std::unique_ptr<tileset> tileset_ptr;
         /** List of mods with which @ref tileset_ptr was loaded. */
         std::vector<mod_id> tileset_mod_list_stamp;
+        /**
+         * Resolved tiles by season, category and id. Drawing asks for the same ids every frame,
+         * this saves following their looks_like chains and building ids each time.
+         * Points into @ref tileset_ptr, so it's cleared whenever the tileset is (re)loaded.
+         */
+        mutable std::unordered_map<std::string, std::optional<tile_lookup_res>>
+        looks_like_cache[season_type::NUM_SEASONS][C_OVERMAP_NOTE + 1];
 
         int tile_height = 0;
         int tile_width = 0;
@@ -450,12 +450,20 @@ auto get_hook_entries( sol::state_view lua, std::string_view hook_name,
 
 } // namespace
 
-auto run_hooks( std::string_view hook_name,
+auto run_hooks( const hook_id &hook,
                 std::function < auto( sol::table &params ) -> void > init,
                 const hook_opts &opts ) -> sol::table
 {
     auto &state = opts.state ? *opts.state : *DynamicDataLoader::get_instance().lua;
     auto &lua = state.lua;
+    const std::string_view hook_name = hook.name;
+
+    // Most hooks have no entries in a game without Lua mods, skip building their params
+    if( state.hooks_with_entries ) {
+        if( hook.index && !state.hooks_with_entries->test( *hook.index ) ) {
+            return state.no_hook_results;
+        }
+    }
 
     auto params = lua.create_table();
     auto results = lua.create_table();
@@ -1,47 +1,63 @@
 #include "catalua_hooks.h"
 #include "catalua_impl.h"
+#include "catalua_readonly.h"
+
+#include <optional>
+#include <string>
+#include <tuple>
 
 namespace cata
 {
 
-constexpr auto hook_names = std::array
-{
-    "on_game_load",
-    "on_game_save",
-    "on_game_started",
-    "on_weather_changed",
-    "on_weather_updated",
-    "on_character_reset_stats",
-    "on_character_effect_added",
-    "on_character_effect",
-    "on_character_effect_removed",
-    "on_mon_effect_added",
-    "on_mon_effect",
-    "on_mon_effect_removed",
-    "on_mon_death",
-    "on_character_death",
-    "on_shoot",
-    "on_throw",
-    "on_creature_dodged",
-    "on_creature_blocked",
-    "on_creature_performed_technique",
-    "on_creature_melee_attacked",
-    "on_character_try_move",
-    "on_mapgen_postprocess",
-    "on_explosion_start",
-};
+static_assert( hook_names.size() <= max_hooks );
 
 void define_hooks( lua_state &state )
 {
     sol::state &lua = state.lua;
+    state.hooks_with_entries.emplace();
+
+    // Hook lists live in `lists`, while `game.hooks` itself stays empty so that
+    // replacing a whole list also goes through __newindex
+    sol::table lists = lua.create_table();
     sol::table hooks = lua.create_table();
+    sol::table hooks_meta = lua.create_table();
+    hooks_meta[sol::meta_function::index] = lists;
+    hooks_meta[sol::meta_function::new_index] = [&state, lists]( const sol::table &,
+    const sol::object & key, const sol::object & value ) mutable {
+        lists.raw_set( key, value );
+        if( key.is<std::string>() ) {
+            if( const std::optional<size_t> index = hook_index( key.as<std::string>() ) ) {
+                state.hooks_with_entries->set( *index );
+            }
+        }
+    };
+    // pairs( game.hooks ) walks the lists, as it did before game.hooks became a proxy
+    hooks_meta[sol::meta_function::pairs] = [lists]( sol::this_state L, const sol::table & ) {
+        sol::state_view lua( L.lua_state() );
+        return std::make_tuple( lua["next"].get<sol::object>(), lists, sol::nil );
+    };
+    hooks[sol::metatable_key] = hooks_meta;
+
+    sol::table no_results = lua.create_table();
+    no_results["allowed"] = true;
+    sol::state_view view = lua;
+    state.no_hook_results = make_readonly_table( view, no_results );
 
     // Main game data table
     sol::table gt = lua.globals()["game"];
     gt["hooks"] = hooks;
 
-    for( const auto &hook : hook_names ) {
-        hooks[hook] = lua.create_table();
+    for( size_t i = 0; i < hook_names.size(); i++ ) {
+        sol::table list = lua.create_table();
+        sol::table list_meta = lua.create_table();
+        // Both game.add_hook and table.insert append new keys, so they end up here
+        list_meta[sol::meta_function::new_index] = [&state, i]( sol::table self,
+        const sol::object & key, const sol::object & value ) {
+            self.raw_set( key, value );
+            state.hooks_with_entries->set( i );
+        };
+        list[sol::metatable_key] = list_meta;
+        lists.raw_set( hook_names[i], list );
     }
 }
 
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <functional>
+#include <optional>
 #include <string_view>
 
 #include "catalua_sol_fwd.h"
@@ -10,6 +13,54 @@ namespace cata
 
 struct lua_state;
 
+/// Hooks defined by define_hooks, in the order of their bits in lua_state::hooks_with_entries.
+inline constexpr auto hook_names = std::array {
+    "on_game_load",
+    "on_game_save",
+    "on_game_started",
+    "on_weather_changed",
+    "on_weather_updated",
+    "on_character_reset_stats",
+    "on_character_effect_added",
+    "on_character_effect",
+    "on_character_effect_removed",
+    "on_mon_effect_added",
+    "on_mon_effect",
+    "on_mon_effect_removed",
+    "on_mon_death",
+    "on_character_death",
+    "on_shoot",
+    "on_throw",
+    "on_creature_dodged",
+    "on_creature_blocked",
+    "on_creature_performed_technique",
+    "on_creature_melee_attacked",
+    "on_character_try_move",
+    "on_mapgen_postprocess",
+    "on_explosion_start",
+};
+
+/// Position of the hook among the ones defined by define_hooks, or nullopt if it isn't one of them.
+constexpr auto hook_index( std::string_view hook_name ) -> std::optional<size_t>
+{
+    for( size_t i = 0; i < hook_names.size(); i++ ) {
+        if( hook_names[i] == hook_name ) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+/// Hook name together with its hook_index().
+/// String literals are resolved at compile time, so run_hooks doesn't compare names per call.
+struct hook_id {
+    std::string_view name;
+    std::optional<size_t> index;
+
+    consteval hook_id( const char *name ) : name( name ), index( hook_index( name ) ) {}
+    explicit hook_id( std::string_view name ) : name( name ), index( hook_index( name ) ) {}
+};
+
 struct hook_opts {
     bool exit_early = false;
     lua_state *state = nullptr;
@@ -27,7 +78,7 @@ struct hook_opts {
 /// contains the previous hook's return value.
 /// Returns `params.results`.
 auto run_hooks(
-    std::string_view hook_name,
+    const hook_id &hook,
     std::function < auto( sol::table &params ) -> void > init = nullptr,
 const hook_opts &opts = {}
 ) -> sol::table;
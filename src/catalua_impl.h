@@ -1,5 +1,8 @@
 #pragma once
 
+#include <bitset>
+#include <optional>
+
 #include "calendar.h"
 #include "catalua_sol.h"
 
@@ -15,8 +18,20 @@ struct on_every_x_hooks {
  * Definition is hidden from outside code to prevent sol::state
  * usage and visibility outside catalua files.
  */
+/** Upper bound for the number of hooks defined by define_hooks. */
+constexpr size_t max_hooks = 64;
+
 struct lua_state {
     sol::state lua;
+    /**
+     * Hooks defined by define_hooks that may have entries, indexed by hook_index().
+     * Bits are set when something is stored in a hook list and never cleared,
+     * so a clear bit means run_hooks has nothing to call.
+     * Empty if the hooks weren't set up by define_hooks, then every hook is looked up.
+     */
+    std::optional<std::bitset<max_hooks>> hooks_with_entries;
+    /** Read-only results returned by run_hooks for hooks without entries. */
+    sol::table no_hook_results;
 
     lua_state() = default;
     ~lua_state() = default;
@@ -613,6 +613,7 @@ void Character::move_operator_common( Character &&source ) noexcept
     cached_moves = source.cached_moves ;
     cached_position = source.cached_position ;
     cached_crafting_inventory = std::move( source.cached_crafting_inventory );
+    cached_nearby_items = std::move( source.cached_nearby_items );
 
     npc_ai_info_cache = source.npc_ai_info_cache ;
 
@@ -2454,6 +2454,21 @@ class Character : public Creature, public location_visitable<Character>
         int cached_moves = 0;
         tripoint cached_position;
         inventory cached_crafting_inventory;
+        /**
+         * The items around the character the crafting inventory was last formed from.
+         * Unlike the rest of it, they are only gathered again once any item was moved or
+         * the map changed, see @ref crafting_inventory.
+         */
+        struct nearby_crafting_items {
+            tripoint abs_origin = tripoint_min;
+            int radius = 0;
+            bool clear_path = false;
+            uint64_t item_generation = 0;
+            uint64_t map_generation = 0;
+            std::vector<tripoint> points;
+            inventory items;
+        };
+        nearby_crafting_items cached_nearby_items;
 
         mutable std::array<double, npc_ai_info::num_npc_ai_info> npc_ai_info_cache;
 
@@ -6,6 +6,11 @@
 #include <stdexcept>
 #include <cstddef>
 
+#if defined(ZSTD)
+#include <zdict.h>
+#include <zstd.h>
+#endif
+
 void zlib_compress( const std::string &input, std::vector<std::byte> &output )
 {
     uLongf compressedSize = compressBound( input.size() );
@@ -50,4 +55,184 @@ void zlib_decompress( const void *compressed_data, int compressed_size, std::str
     } while( result == Z_BUF_ERROR );
 
     output.resize( decompressedSize );
-}
\ No newline at end of file
+}
+#if defined(ZSTD)
+
+// Saving happens in the background, so favor ratio over speed a little more than with zlib
+static constexpr int zstd_level = 3;
+// The size zstd's own dictionary builder defaults to
+static constexpr size_t zstd_dictionary_capacity = 112640;
+// Fewer samples than this make for a dictionary that isn't worth it
+static constexpr size_t zstd_min_samples = 64;
+
+class zstd_dictionary
+{
+    public:
+        zstd_dictionary( const void *data, size_t size ) :
+            cdict( ZSTD_createCDict( data, size, zstd_level ) ),
+            ddict( ZSTD_createDDict( data, size ) ),
+            id( ZDICT_getDictID( data, size ) ) {
+            if( cdict == nullptr || ddict == nullptr ) {
+                ZSTD_freeCDict( cdict );
+                ZSTD_freeDDict( ddict );
+                throw std::runtime_error( "Zstd dictionary is corrupt" );
+            }
+        }
+        ~zstd_dictionary() {
+            ZSTD_freeCDict( cdict );
+            ZSTD_freeDDict( ddict );
+        }
+        zstd_dictionary( const zstd_dictionary & ) = delete;
+        zstd_dictionary &operator=( const zstd_dictionary & ) = delete;
+
+        // Dictionaries are read-only, they can be shared by threads
+        ZSTD_CDict *const cdict;
+        ZSTD_DDict *const ddict;
+        const unsigned int id;
+};
+
+// Contexts are expensive to create and not thread safe, so each thread keeps its own
+static ZSTD_CCtx *zstd_cctx()
+{
+    static thread_local std::unique_ptr<ZSTD_CCtx, decltype( &ZSTD_freeCCtx )> cctx(
+        ZSTD_createCCtx(), &ZSTD_freeCCtx );
+    return cctx.get();
+}
+
+static ZSTD_DCtx *zstd_dctx()
+{
+    static thread_local std::unique_ptr<ZSTD_DCtx, decltype( &ZSTD_freeDCtx )> dctx(
+        ZSTD_createDCtx(), &ZSTD_freeDCtx );
+    return dctx.get();
+}
+
+bool zstd_available()
+{
+    return true;
+}
+
+std::vector<std::byte> zstd_train_dictionary( const std::vector<std::string> &samples )
+{
+    std::vector<std::byte> dictionary;
+    if( samples.size() < zstd_min_samples ) {
+        return dictionary;
+    }
+
+    std::string buffer;
+    std::vector<size_t> sizes;
+    sizes.reserve( samples.size() );
+    for( const std::string &sample : samples ) {
+        buffer += sample;
+        sizes.push_back( sample.size() );
+    }
+
+    dictionary.resize( zstd_dictionary_capacity );
+    const size_t result = ZDICT_trainFromBuffer( dictionary.data(), dictionary.size(), buffer.data(),
+                          sizes.data(), sizes.size() );
+    if( ZDICT_isError( result ) ) {
+        dictionary.clear();
+    } else {
+        dictionary.resize( result );
+    }
+    return dictionary;
+}
+
+std::shared_ptr<const zstd_dictionary> zstd_load_dictionary( const void *data, size_t size )
+{
+    return std::make_shared<const zstd_dictionary>( data, size );
+}
+
+unsigned int zstd_dictionary_id( const zstd_dictionary &dictionary )
+{
+    return dictionary.id;
+}
+
+unsigned int zstd_blob_dictionary_id( const void *compressed_data, int compressed_size )
+{
+    return ZSTD_getDictID_fromFrame( compressed_data, compressed_size );
+}
+
+void zstd_compress( const std::string &input, std::vector<std::byte> &output,
+                    const zstd_dictionary *dictionary )
+{
+    output.resize( ZSTD_compressBound( input.size() ) );
+    const size_t result = dictionary != nullptr ?
+                          ZSTD_compress_usingCDict( zstd_cctx(), output.data(), output.size(), input.data(), input.size(),
+                                  dictionary->cdict ) :
+                          ZSTD_compressCCtx( zstd_cctx(), output.data(), output.size(), input.data(), input.size(),
+                                  zstd_level );
+    if( ZSTD_isError( result ) ) {
+        throw std::runtime_error( std::string( "Zstd compression error: " ) +
+                                  ZSTD_getErrorName( result ) );
+    }
+    output.resize( result );
+}
+
+void zstd_decompress( const void *compressed_data, int compressed_size, std::string &output,
+                      const zstd_dictionary *dictionary )
+{
+    // Everything we compress records its size, so there is no need to guess like with zlib
+    const unsigned long long size = ZSTD_getFrameContentSize( compressed_data, compressed_size );
+    if( size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN ) {
+        throw std::runtime_error( "Zstd decompression failed: unknown size" );
+    }
+    output.resize( size );
+    const size_t result = dictionary != nullptr ?
+                          ZSTD_decompress_usingDDict( zstd_dctx(), output.data(), output.size(), compressed_data,
+                                  compressed_size, dictionary->ddict ) :
+                          ZSTD_decompressDCtx( zstd_dctx(), output.data(), output.size(), compressed_data,
+                                  compressed_size );
+    if( ZSTD_isError( result ) ) {
+        throw std::runtime_error( std::string( "Zstd decompression failed: " ) +
+                                  ZSTD_getErrorName( result ) );
+    }
+    output.resize( result );
+}
+
+#else
+
+class zstd_dictionary
+{
+};
+
+[[noreturn]] static void zstd_unavailable()
+{
+    throw std::runtime_error( "This build does not support zstd compression" );
+}
+
+bool zstd_available()
+{
+    return false;
+}
+
+std::vector<std::byte> zstd_train_dictionary( const std::vector<std::string> & )
+{
+    zstd_unavailable();
+}
+
+std::shared_ptr<const zstd_dictionary> zstd_load_dictionary( const void *, size_t )
+{
+    zstd_unavailable();
+}
+
+unsigned int zstd_dictionary_id( const zstd_dictionary & )
+{
+    zstd_unavailable();
+}
+
+unsigned int zstd_blob_dictionary_id( const void *, int )
+{
+    zstd_unavailable();
+}
+
+void zstd_compress( const std::string &, std::vector<std::byte> &, const zstd_dictionary * )
+{
+    zstd_unavailable();
+}
+
+void zstd_decompress( const void *, int, std::string &, const zstd_dictionary * )
+{
+    zstd_unavailable();
+}
+
+#endif
@@ -1,10 +1,36 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "fstream_utils.h"
 
 void zlib_compress( const std::string &input, std::vector<std::byte> &output );
 void zlib_decompress( const void *compressed_data, int compressed_size, std::string &output );
 
+/**
+ * Zstandard is only available in builds with ZSTD defined, the zstd functions
+ * throw in other builds.
+ */
+bool zstd_available();
+
+/**
+ * Shared context for compressing many small, similar blobs, such as map quads.
+ * Compressing with a dictionary needs the same dictionary to decompress.
+ */
+class zstd_dictionary;
+
+/** Returns an empty buffer if there isn't enough data in @p samples to train on. */
+std::vector<std::byte> zstd_train_dictionary( const std::vector<std::string> &samples );
+std::shared_ptr<const zstd_dictionary> zstd_load_dictionary( const void *data, size_t size );
+unsigned int zstd_dictionary_id( const zstd_dictionary &dictionary );
+/** Id of the dictionary the blob was compressed with, 0 if it was compressed without one. */
+unsigned int zstd_blob_dictionary_id( const void *compressed_data, int compressed_size );
+
+void zstd_compress( const std::string &input, std::vector<std::byte> &output,
+                    const zstd_dictionary *dictionary = nullptr );
+void zstd_decompress( const void *compressed_data, int compressed_size, std::string &output,
+                      const zstd_dictionary *dictionary = nullptr );
 
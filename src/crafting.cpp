@@ -549,28 +549,54 @@ const inventory &Character::crafting_inventory( const tripoint &src_pos, int rad
         && cached_position == inv_pos ) {
         return cached_crafting_inventory;
     }
-    cached_crafting_inventory.form_from_map( inv_pos, radius, this, false, clear_path );
-    cached_crafting_inventory.add_items( inv, true );
-    cached_crafting_inventory.add_item( primary_weapon(), true );
-    cached_crafting_inventory.add_items( worn, true );
+
+    map &here = get_map();
+    nearby_crafting_items &nearby = cached_nearby_items;
+    const tripoint abs_origin = here.getabs( inv_pos );
+    if( nearby.abs_origin != abs_origin || nearby.radius != radius ||
+        nearby.clear_path != clear_path || nearby.item_generation != item::location_generation() ||
+        nearby.map_generation != here.get_layout_generation() ) {
+        nearby.abs_origin = abs_origin;
+        nearby.radius = radius;
+        nearby.clear_path = clear_path;
+        nearby.points = inventory::reachable_points( here, inv_pos, radius, clear_path );
+        nearby.items.clear();
+        nearby.items.add_map_items( here, nearby.points, this, false );
+        nearby.items.update_quality_cache();
+    }
+
+    // Charges of the pseudo items, like battery power, change without anything moving
+    inventory others;
+    others.add_map_pseudo_items( here, nearby.points );
+    others.add_items( inv, true );
+    others.add_item( primary_weapon(), true );
+    others.add_items( worn, true );
     for( const bionic &bio : get_bionic_collection() ) {
         const bionic_data &bio_data = bio.info();
         if( ( !bio_data.has_flag( flag_BIONIC_TOGGLED ) || bio.powered ) &&
             !bio_data.fake_item.is_empty() ) {
-            cached_crafting_inventory.add_item( *item::spawn_temporary( bio.info().fake_item, calendar::turn,
-                                                units::to_kilojoule( get_power_level() ) ), true );
+            others.add_item( *item::spawn_temporary( bio.info().fake_item, calendar::turn,
+                             units::to_kilojoule( get_power_level() ) ), true );
         }
     }
     if( has_trait( trait_BURROW ) ) {
-        cached_crafting_inventory.add_item( *item::spawn_temporary( "pickaxe", calendar::turn ), true );
-        cached_crafting_inventory.add_item( *item::spawn_temporary( "shovel", calendar::turn ), true );
+        others.add_item( *item::spawn_temporary( "pickaxe", calendar::turn ), true );
+        others.add_item( *item::spawn_temporary( "shovel", calendar::turn ), true );
     }
+    others.update_quality_cache();
+
+    cached_crafting_inventory = nearby.items;
+    // The copied type cache still points into nearby.items
+    cached_crafting_inventory.unsort();
+    cached_crafting_inventory.add_items( others, true, false, false );
+    cached_crafting_inventory.merge_quality_cache( others );
+    // Spawning the pseudo items may count as moving items, but doesn't change what's nearby
+    nearby.item_generation = item::location_generation();
+    nearby.map_generation = here.get_layout_generation();
 
     cached_moves = moves;
     cached_time = calendar::turn;
     cached_position = inv_pos;
-    // cache the qualities of the items in cached_crafting_inventory
-    cached_crafting_inventory.update_quality_cache();
     return cached_crafting_inventory;
 }
 
@@ -578,6 +604,7 @@ void Character::invalidate_crafting_inventory()
 {
     cached_time = calendar::before_time_starts;
     cached_position = tripoint_min;
+    cached_nearby_items.abs_origin = tripoint_min;
 }
 
 void Character::make_craft( const recipe_id &id_to_make, int batch_size, const tripoint &loc )
@@ -7,6 +7,8 @@
 #include <utility>
 
 #include "debug.h"
+#include "game_constants.h"
+#include "line.h"
 #include "mongroup.h"
 #include "monster.h"
 #include "mtype.h"
@@ -86,7 +88,7 @@ bool Creature_tracker::add( const shared_ptr_fast<monster> &critter_ptr )
     }
 
     monsters_list.emplace_back( critter_ptr );
-    monsters_by_location[critter.pos()] = critter_ptr;
+    set_location( critter.pos(), critter_ptr );
     add_to_faction_map( critter_ptr );
     return true;
 }
@@ -164,8 +166,11 @@ bool Creature_tracker::update_pos( const monster &critter, const tripoint &new_p
         return ptr.get() == &critter;
     } );
     if( iter != monsters_list.end() ) {
-        monsters_by_location.erase( critter.pos() );
-        monsters_by_location[new_pos] = *iter;
+        const auto old_iter = monsters_by_location.find( critter.pos() );
+        if( old_iter != monsters_by_location.end() ) {
+            erase_location( old_iter );
+        }
+        set_location( new_pos, *iter );
         return true;
     } else {
         const tripoint &old_pos = critter.pos();
@@ -184,7 +189,7 @@ void Creature_tracker::remove_from_location_map( const monster &critter )
 {
     const auto pos_iter = monsters_by_location.find( critter.pos() );
     if( pos_iter != monsters_by_location.end() && pos_iter->second.get() == &critter ) {
-        monsters_by_location.erase( pos_iter );
+        erase_location( pos_iter );
         return;
     }
 
@@ -195,8 +200,73 @@ void Creature_tracker::remove_from_location_map( const monster &critter )
         return v.second.get() == &critter;
     } );
     if( iter != monsters_by_location.end() ) {
-        monsters_by_location.erase( iter );
+        erase_location( iter );
+    }
+}
+
+static tripoint cell_of( const tripoint &pos )
+{
+    return tripoint( divide_round_to_minus_infinity( pos.x, SEEX ),
+                     divide_round_to_minus_infinity( pos.y, SEEY ), pos.z );
+}
+
+void Creature_tracker::set_location( const tripoint &pos, const shared_ptr_fast<monster> &critter )
+{
+    const auto iter = monsters_by_location.find( pos );
+    if( iter != monsters_by_location.end() ) {
+        erase_location( iter );
     }
+    monsters_by_location.emplace( pos, critter );
+    monsters_by_cell[cell_of( pos )].emplace_back( pos, critter.get() );
+}
+
+void Creature_tracker::erase_location( decltype( monsters_by_location )::iterator iter )
+{
+    const auto cell_iter = monsters_by_cell.find( cell_of( iter->first ) );
+    if( cell_iter != monsters_by_cell.end() ) {
+        auto &cell = cell_iter->second;
+        const auto in_cell = std::ranges::find( cell, std::make_pair( iter->first, iter->second.get() ) );
+        if( in_cell != cell.end() ) {
+            // Order within a cell doesn't matter
+            *in_cell = cell.back();
+            cell.pop_back();
+        }
+        if( cell.empty() ) {
+            monsters_by_cell.erase( cell_iter );
+        }
+    }
+    monsters_by_location.erase( iter );
+}
+
+void Creature_tracker::clear_locations()
+{
+    monsters_by_location.clear();
+    monsters_by_cell.clear();
+}
+
+std::vector<monster *> Creature_tracker::find_in_radius( const tripoint &center, const int radius,
+        const int radiusz ) const
+{
+    std::vector<monster *> result;
+    const tripoint min_cell = cell_of( center - tripoint( radius, radius, radiusz ) );
+    const tripoint max_cell = cell_of( center + tripoint( radius, radius, radiusz ) );
+    for( int z = std::max( min_cell.z, -OVERMAP_DEPTH ); z <= std::min( max_cell.z, OVERMAP_HEIGHT );
+         z++ ) {
+        for( int y = min_cell.y; y <= max_cell.y; y++ ) {
+            for( int x = min_cell.x; x <= max_cell.x; x++ ) {
+                const auto cell_iter = monsters_by_cell.find( tripoint( x, y, z ) );
+                if( cell_iter == monsters_by_cell.end() ) {
+                    continue;
+                }
+                for( const auto &[pos, critter] : cell_iter->second ) {
+                    if( square_dist( center.xy(), pos.xy() ) <= radius && !critter->is_dead() ) {
+                        result.push_back( critter );
+                    }
+                }
+            }
+        }
+    }
+    return result;
 }
 
 void Creature_tracker::remove( const monster &critter )
@@ -227,17 +297,17 @@ void Creature_tracker::remove( const monster &critter )
 void Creature_tracker::clear()
 {
     monsters_list.clear();
-    monsters_by_location.clear();
+    clear_locations();
     monster_faction_map_.clear();
     removed_.clear();
 }
 
 void Creature_tracker::rebuild_cache()
 {
-    monsters_by_location.clear();
+    clear_locations();
     monster_faction_map_.clear();
     for( const shared_ptr_fast<monster> &mon_ptr : monsters_list ) {
-        monsters_by_location[mon_ptr->pos()] = mon_ptr;
+        set_location( mon_ptr->pos(), mon_ptr );
         add_to_faction_map( mon_ptr );
     }
 }
@@ -256,13 +326,13 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
     shared_ptr_fast<monster> first_ptr;
     if( first_iter != monsters_by_location.end() ) {
         first_ptr = first_iter->second;
-        monsters_by_location.erase( first_iter );
+        erase_location( first_iter );
     }
 
     shared_ptr_fast<monster> second_ptr;
     if( second_iter != monsters_by_location.end() ) {
         second_ptr = second_iter->second;
-        monsters_by_location.erase( second_iter );
+        erase_location( second_iter );
     }
     // implied: (first_ptr != second_ptr) or (first_ptr == nullptr && second_ptr == nullptr)
 
@@ -272,10 +342,10 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
 
     // If the pointers have been taken out of the list, put them back in.
     if( first_ptr ) {
-        monsters_by_location[first.pos()] = first_ptr;
+        set_location( first.pos(), first_ptr );
     }
     if( second_ptr ) {
-        monsters_by_location[second.pos()] = second_ptr;
+        set_location( second.pos(), second_ptr );
     }
 }
 
@@ -84,6 +84,15 @@ class Creature_tracker
             return monsters_list;
         }
 
+        /**
+         * Returns living monsters at most @p radius tiles away from @p center horizontally
+         * (square distance) and at most @p radiusz z-levels away vertically.
+         * Only submap-sized cells around @p center are visited, not the whole monster list.
+         * Pointers stay valid until the end of the turn, see @ref removed_.
+         */
+        std::vector<monster *> find_in_radius( const tripoint &center, int radius,
+                                               int radiusz = 0 ) const;
+
         void serialize( JsonOut &jsout ) const;
         void deserialize( JsonIn &jsin );
 
@@ -94,8 +103,17 @@ class Creature_tracker
     private:
         std::vector<shared_ptr_fast<monster>> monsters_list;
         std::unordered_map<tripoint, shared_ptr_fast<monster>> monsters_by_location;
+        /**
+         * Same entries as @ref monsters_by_location, bucketed by submap-sized cell for radius queries.
+         * Must only be changed through @ref set_location and @ref erase_location.
+         */
+        std::unordered_map<tripoint, std::vector<std::pair<tripoint, monster *>>> monsters_by_cell;
         /** Remove the monsters entry in @ref monsters_by_location */
         void remove_from_location_map( const monster &critter );
+        /** Puts @p critter into @ref monsters_by_location and @ref monsters_by_cell, replacing whatever was at @p pos */
+        void set_location( const tripoint &pos, const shared_ptr_fast<monster> &critter );
+        void erase_location( decltype( monsters_by_location )::iterator iter );
+        void clear_locations();
 };
 
 
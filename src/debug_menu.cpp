@@ -60,6 +60,7 @@
 #include "map.h"
 #include "map_extras.h"
 #include "map_iterator.h"
+#include "mapbuffer.h"
 #include "mapgen.h"
 #include "mapgendata.h"
 #include "martialarts.h"
@@ -108,6 +109,7 @@
 #include "weather.h"
 #include "weather_gen.h"
 #include "weighted_list.h"
+#include "world.h"
 #include "game_info.h"
 #include "overmap_special.h"
 
@@ -195,6 +197,7 @@ enum debug_menu_index {
     DEBUG_VEHICLE_EXPORT_JSON,
     DEBUG_HOUR_TIMER,
     DEBUG_NESTED_MAPGEN,
+    DEBUG_CONVERT_MAP_BINARY,
     DEBUG_RESET_IGNORED_MESSAGES,
     DEBUG_RELOAD_TILES,
     DEBUG_SWAP_CHAR,
@@ -334,6 +337,7 @@ static int map_uilist()
         { uilist_entry( DEBUG_OM_EDITOR, true, 'O', _( "Overmap editor" ) ) },
         { uilist_entry( DEBUG_MAP_EXTRA, true, 'm', _( "Spawn map extra" ) ) },
         { uilist_entry( DEBUG_NESTED_MAPGEN, true, 'n', _( "Spawn nested mapgen" ) ) },
+        { uilist_entry( DEBUG_CONVERT_MAP_BINARY, true, 'b', _( "Convert saved map to binary format" ) ) },
     };
 
     return uilist( _( "Map…" ), uilist_initializer );
@@ -2123,6 +2127,14 @@ void debug()
         case DEBUG_NESTED_MAPGEN:
             debug_menu::spawn_nested_mapgen();
             break;
+        case DEBUG_CONVERT_MAP_BINARY:
+            if( !g->get_active_world()->supports_binary_map_quads() ) {
+                popup( _( "Binary map saves need the \"Binary map saves\" option and a world using the SQLite save format." ) );
+            } else {
+                popup( string_format( _( "Converted %d map areas to the binary format." ),
+                                      MAPBUFFER.convert_quads_to_binary() ) );
+            }
+            break;
         case DEBUG_DISPLAY_NPC_PATH:
             g->debug_pathfinding = !g->debug_pathfinding;
             break;
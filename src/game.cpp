@@ -12,6 +12,7 @@
 #include <ctime>
 #include <cwctype>
 #include <exception>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
@@ -25,6 +26,7 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
@@ -531,6 +533,8 @@ void game::setup( bool load_world_modfiles )
     // a different world
     calendar::set_eternal_season( ::get_option<bool>( "ETERNAL_SEASON" ) );
     calendar::set_season_length( ::get_option<int>( "SEASON_LENGTH" ) );
+    // Temperatures sampled for rot depend on the seasons
+    rot::clear_temperature_timelines();
 
     get_weather().weather_id = weather_type_id::NULL_ID();
     get_weather().nextweather = calendar::before_time_starts;
@@ -1556,6 +1560,14 @@ bool game::do_turn()
 
     u.update_body();
 
+    if( world *world = get_active_world() ) {
+        try {
+            world->finish_background_save();
+        } catch( const std::exception &err ) {
+            popup( _( "Failed to save game data: %s" ), err.what() );
+        }
+    }
+
     // Auto-save if autosave is enabled
     if( get_option<bool>( "AUTOSAVE" ) &&
         calendar::once_every( 1_turns * get_option<int>( "AUTOSAVE_TURNS" ) ) &&
@@ -1761,8 +1773,8 @@ bool game::do_turn()
     // reset player noise
     u.volume = 0;
 
-    // Finally, clear pathfinding cache
-    Pathfinding::clear_d_maps();
+    // Finally, carry pathfinding cache over to the next turn
+    Pathfinding::end_turn();
 
     return false;
 }
@@ -2810,6 +2822,8 @@ bool game::load( const save_t &name )
     // worldoptions
     calendar::set_eternal_season( ::get_option<bool>( "ETERNAL_SEASON" ) );
     calendar::set_season_length( ::get_option<int>( "SEASON_LENGTH" ) );
+    // Temperatures sampled for rot depend on the seasons
+    rot::clear_temperature_timelines();
 
     u.reset();
     //needs all npcs and stats loaded
@@ -2970,7 +2984,18 @@ bool game::save( bool quitting )
             world_generator->active_world->info->add_save( save_t::from_save_id( u.get_save_id() ) );
 
             auto duration = world->commit_save_tx();
-            add_msg( m_info, _( "World Saved (took %dms)." ), duration );
+            if( quitting ) {
+                const auto wait_start = std::chrono::steady_clock::now();
+                world->wait_for_pending_saves();
+                duration += std::chrono::duration_cast<std::chrono::milliseconds>(
+                                std::chrono::steady_clock::now() - wait_start ).count();
+            }
+            if( world->is_saving_in_background() ) {
+                add_msg( m_info, _( "World Saved (took %dms, writing to disk in background)." ),
+                         duration );
+            } else {
+                add_msg( m_info, _( "World Saved (took %dms)." ), duration );
+            }
             return true;
         }
     } catch( std::ios::failure &err ) {
@@ -4201,11 +4226,68 @@ void game::cleanup_dead()
     critter_died = false;
 }
 
+// Splitting sight line checks between threads only pays off with enough monsters in each chunk
+static constexpr size_t MIN_MONSTERS_PER_SCAN_TASK = 32;
+
+// Line of sight checks are most of the work of monster planning. The lines plan() is going to
+// check are listed here, and map::sees runs for them on worker threads to fill its memo.
+// Nothing but map::sees runs on the workers, everything that looks at creatures stays on
+// this thread. plan() then runs serially as before and finds the results in the memo, so
+// the outcome of the turn doesn't depend on the number of threads.
+static void scan_monster_sight_lines( game &g )
+{
+    ZoneScoped;
+
+    const size_t monster_count = g.critter_tracker->size();
+    const size_t task_count = std::min<size_t>( std::max( 1u, std::thread::hardware_concurrency() ),
+                              monster_count / MIN_MONSTERS_PER_SCAN_TASK );
+    // On a single thread plan() would do the same checks anyway
+    if( task_count <= 1 ) {
+        return;
+    }
+
+    std::vector<monster *> monsters;
+    for( monster &critter : g.all_monsters() ) {
+        if( !critter.is_dead() ) {
+            monsters.push_back( &critter );
+        }
+    }
+    std::vector<npc *> npcs;
+    for( npc &guy : g.all_npcs() ) {
+        npcs.push_back( &guy );
+    }
+    std::vector<std::pair<tripoint, tripoint>> lines;
+    for( const monster *critter : monsters ) {
+        critter->add_target_sight_lines( monsters, npcs, lines );
+    }
+
+    const map &here = get_map();
+    const auto scan_range = [&here, &lines]( size_t begin, size_t end ) {
+        for( size_t i = begin; i < end; i++ ) {
+            here.sees( lines[i].first, lines[i].second, -1 );
+        }
+    };
+
+    const size_t chunk_size = ( lines.size() + task_count - 1 ) / task_count;
+    std::vector<std::future<void>> tasks;
+    for( size_t task = 1; task < task_count; task++ ) {
+        tasks.push_back( std::async( std::launch::async, scan_range,
+                                     std::min( lines.size(), task * chunk_size ),
+                                     std::min( lines.size(), ( task + 1 ) * chunk_size ) ) );
+    }
+    scan_range( 0, std::min( lines.size(), chunk_size ) );
+    for( std::future<void> &task : tasks ) {
+        task.get();
+    }
+}
+
 void game::monmove()
 {
     ZoneScoped;
     cleanup_dead();
 
+    scan_monster_sight_lines( *this );
+
     for( monster &critter : all_monsters() ) {
         // Critters in impassable tiles get pushed away, unless it's not impassable for them
         if( !critter.is_dead() && m.impassable( critter.pos() ) && !critter.can_move_to( critter.pos() ) ) {
@@ -11402,8 +11484,6 @@ void game::vertical_shift( const int z_after )
     // TODO: Implement dragging stuff up/down
     u.grab( OBJECT_NONE );
 
-    scent.reset();
-
     u.setz( z_after );
     const int z_before = get_levz();
     if( !m.has_zlevels() ) {
@@ -11468,6 +11548,26 @@ void game::vertical_notes( int z_before, int z_after )
     }
 }
 
+// Reads the saved submaps in front of the player in the background. From a vehicle
+// they are read far enough ahead to stay in front of it until the map shifts again.
+static void prefetch_submaps_ahead( const map &m, const Character &who, point shift )
+{
+    point heading( sgn( shift.x ), sgn( shift.y ) );
+    int distance = 1;
+    const optional_vpart_position vp = m.veh_at( who.pos() );
+    if( vp && who.in_vehicle ) {
+        const vehicle &veh = vp->vehicle();
+        const units::angle dir = veh.velocity < 0 ? veh.move.dir() + 180_degrees : veh.move.dir();
+        // Within 22.5 degrees of an axis, only the submaps along that axis are coming up
+        const double dx = units::cos( dir );
+        const double dy = units::sin( dir );
+        heading = point( std::abs( dx ) > 0.38 ? sgn( dx ) : 0, std::abs( dy ) > 0.38 ? sgn( dy ) : 0 );
+        const int submaps_per_turn = std::abs( veh.velocity ) / vehicles::vmiph_per_tile / SEEX;
+        distance += std::min( submaps_per_turn, 3 );
+    }
+    m.prefetch_submaps( heading, distance );
+}
+
 point game::update_map( Character &who )
 {
     point p2( who.posx(), who.posy() );
@@ -11518,6 +11618,10 @@ point game::update_map( int &x, int &y )
 
     grid_tracker_ptr->load( m );
 
+    if( get_option<bool>( "PREFETCH_MAPS" ) ) {
+        prefetch_submaps_ahead( m, u, shift );
+    }
+
     // Shift monsters
     shift_monsters( tripoint( shift, 0 ) );
     const point shift_ms = sm_to_ms_copy( shift );
@@ -28,6 +28,7 @@ template<typename T>
 void game_object<T>::remove_location()
 {
     loc = nullptr;
+    location_changes++;
 }
 
 template<typename T>
@@ -38,6 +39,7 @@ void game_object<T>::set_location( location<T> *own )
         detach().release();
     }
     loc = own;
+    location_changes++;
 }
 
 template<typename T>
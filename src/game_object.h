@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <utility>
 
 #include "detached_ptr.h"
@@ -30,6 +31,7 @@ class game_object
     protected:
         location<T> *saved_loc = nullptr;
         location<T> *loc = nullptr;
+        static inline uint64_t location_changes = 0;
 
         game_object() = default;
 
@@ -57,6 +59,13 @@ class game_object
         void set_location( location<T> *own );
 
         tripoint position( ) const;
+        /**
+         * Changes whenever any object of this type gets or loses a location, so that
+         * caches of which objects are where can tell they might be out of date.
+         */
+        static uint64_t location_generation() {
+            return location_changes;
+        }
         /** Returns the name that will be used when referring to the object in error messages */
         virtual std::string debug_name() const = 0;
 };
@@ -463,6 +463,12 @@ void inventory::form_from_zone( map &m, std::unordered_set<tripoint> &zone_pts,
 void inventory::form_from_map( map &m, const tripoint &origin, int range, const Character *pl,
                                bool assign_invlet,
                                bool clear_path )
+{
+    form_from_map( m, reachable_points( m, origin, range, clear_path ), pl, assign_invlet );
+}
+
+std::vector<tripoint> inventory::reachable_points( map &m, const tripoint &origin, int range,
+        bool clear_path )
 {
     // populate a grid of spots that can be reached
     std::vector<tripoint> reachable_pts = {};
@@ -476,19 +482,79 @@ void inventory::form_from_map( map &m, const tripoint &origin, int range, const
             reachable_pts.emplace_back( p );
         }
     }
-    form_from_map( m, reachable_pts, pl, assign_invlet );
+    return reachable_pts;
 }
 
 //TODO!: check that not stacking the crafting inventory works ok
 void inventory::form_from_map( map &m, std::vector<tripoint> pts, const Character *pl,
                                bool assign_invlet )
 {
+    items.clear();
+    build_items_type_cache();
+    add_map_items( m, pts, pl, assign_invlet );
+    add_map_pseudo_items( m, pts );
+}
+
+void inventory::add_map_items( map &m, const std::vector<tripoint> &pts, const Character *pl,
+                               bool assign_invlet )
+{
+    if( !items_type_cached ) {
+        build_items_type_cache();
+    }
+    for( const tripoint &p : pts ) {
+        if( m.has_items( p ) && m.accessible_items( p ) ) {
+            bool allow_liquids = m.has_flag_ter_or_furn( "LIQUIDCONT", p );
+            for( auto &i : m.i_at( p ) ) {
+                // if it's *the* player requesting this from from map inventory
+                // then don't allow items owned by another faction to be factored into recipe components etc.
+                if( pl && !i->is_owned_by( *pl, true ) && i->get_owner()->likes_u >= -10 ) {
+                    continue;
+                }
+                if( allow_liquids || !i->made_of( LIQUID ) ) {
+                    add_item_by_items_type_cache( *i, false, assign_invlet, false );
+                }
+            }
+        }
+        // kludge that can probably be done better to check specifically for toilet water to use in
+        // crafting
+        if( m.furn( p ).obj().examine == &iexamine::toilet ) {
+            // get water charges at location
+            auto toilet = m.i_at( p );
+            item *waterp = nullptr;
+            for( auto candidate = toilet.begin(); candidate != toilet.end(); ++candidate ) {
+                if( ( *candidate )->typeId() == itype_water ) {
+                    waterp = *candidate;
+                    break;
+                }
+            }
+            if( waterp != nullptr && waterp->charges > 0 ) {
+                add_item_by_items_type_cache( *waterp, false, true, false );
+            }
+        }
+
+        const optional_vpart_position vp = m.veh_at( p );
+        if( !vp ) {
+            continue;
+        }
+        const std::optional<vpart_reference> cargo = vp.part_with_feature( "CARGO", true );
+        if( cargo ) {
+            const auto items = vp->vehicle().get_items( cargo->part_index() );
+            for( const auto &it : items ) {
+                add_item_by_items_type_cache( *it, false, false, false );
+            }
+        }
+    }
+}
+
+void inventory::add_map_pseudo_items( map &m, const std::vector<tripoint> &pts )
+{
+    if( !items_type_cached ) {
+        build_items_type_cache();
+    }
     const time_point bday = calendar::start_of_cataclysm;
     std::unordered_map<const vehicle *, std::unordered_set<std::string>> checked_veh_tools;
     bool has_faucet = false;
     bool has_autodoc = false;
-    items.clear();
-    build_items_type_cache();
     for( const tripoint &p : pts ) {
         if( m.has_furn( p ) ) {
             const furn_t &f = m.furn( p ).obj();
@@ -509,19 +575,6 @@ void inventory::form_from_map( map &m, std::vector<tripoint> pts, const Characte
                 }
             }
         }
-        if( m.has_items( p ) && m.accessible_items( p ) ) {
-            bool allow_liquids = m.has_flag_ter_or_furn( "LIQUIDCONT", p );
-            for( auto &i : m.i_at( p ) ) {
-                // if it's *the* player requesting this from from map inventory
-                // then don't allow items owned by another faction to be factored into recipe components etc.
-                if( pl && !i->is_owned_by( *pl, true ) && i->get_owner()->likes_u >= -10 ) {
-                    continue;
-                }
-                if( allow_liquids || !i->made_of( LIQUID ) ) {
-                    add_item_by_items_type_cache( *i, false, assign_invlet, false );
-                }
-            }
-        }
         // Kludges for now!
         if( m.has_nearby_fire( p, 0 ) ) {
             item &fire = *item::spawn_temporary( "fire", bday );
@@ -533,22 +586,6 @@ void inventory::form_from_map( map &m, std::vector<tripoint> pts, const Characte
         if( water ) {
             add_item_by_items_type_cache( *water, false, true, false );
         }
-        // kludge that can probably be done better to check specifically for toilet water to use in
-        // crafting
-        if( m.furn( p ).obj().examine == &iexamine::toilet ) {
-            // get water charges at location
-            auto toilet = m.i_at( p );
-            item *waterp = nullptr;
-            for( auto candidate = toilet.begin(); candidate != toilet.end(); ++candidate ) {
-                if( ( *candidate )->typeId() == itype_water ) {
-                    waterp = *candidate;
-                    break;
-                }
-            }
-            if( waterp != nullptr && waterp->charges > 0 ) {
-                add_item_by_items_type_cache( *waterp, false, true, false );
-            }
-        }
 
         // WARNING: The part below has a bug that's currently quite minor
         // When a vehicle has multiple faucets in range, available water is
@@ -572,14 +609,6 @@ void inventory::form_from_map( map &m, std::vector<tripoint> pts, const Characte
 
         const std::optional<vpart_reference> faupart = vp.part_with_feature( "FAUCET", true );
         const std::optional<vpart_reference> autoclavepart = vp.part_with_feature( "AUTOCLAVE", true );
-        const std::optional<vpart_reference> cargo = vp.part_with_feature( "CARGO", true );
-
-        if( cargo ) {
-            const auto items = veh->get_items( cargo->part_index() );
-            for( const auto &it : items ) {
-                add_item_by_items_type_cache( *it, false, false, false );
-            }
-        }
 
         static const flag_id flag_PSEUDO( "PSEUDO" );
         static const flag_id flag_HEATS_FOOD( "HEATS_FOOD" );
@@ -620,7 +649,6 @@ void inventory::form_from_map( map &m, std::vector<tripoint> pts, const Characte
             has_autodoc = true;
         }
     }
-    pts.clear();
 }
 
 std::vector<detached_ptr<item>> location_inventory::reduce_stack( const int position,
@@ -1088,6 +1116,16 @@ void inventory::update_quality_cache()
     } );
 }
 
+void inventory::merge_quality_cache( const inventory &other )
+{
+    for( const auto &[quality, counts] : other.quality_cache ) {
+        std::map<int, int> &merged = quality_cache[quality];
+        for( const auto &[level, count] : counts ) {
+            merged[level] += count;
+        }
+    }
+}
+
 const std::map<quality_id, std::map<int, int>> &inventory::get_quality_cache() const
 {
     return quality_cache;
@@ -144,6 +144,20 @@ class inventory : public temp_visitable<inventory>
                             bool clear_path = true );
         void form_from_map( map &m, std::vector<tripoint> pts, const Character *pl,
                             bool assign_invlet = true );
+        /** The points form_from_map( m, origin, range, ... ) takes items from. */
+        static std::vector<tripoint> reachable_points( map &m, const tripoint &origin, int range,
+                bool clear_path );
+        /**
+         * Adds the real items @ref form_from_map would add, i.e. the items on the ground and
+         * in vehicle cargo. Unlike the rest, these only change when items are moved.
+         */
+        void add_map_items( map &m, const std::vector<tripoint> &pts, const Character *pl,
+                            bool assign_invlet );
+        /**
+         * Adds the rest of @ref form_from_map, the pseudo items standing in for furniture and
+         * vehicle tools, fire and water sources.
+         */
+        void add_map_pseudo_items( map &m, const std::vector<tripoint> &pts );
         /**
          * Remove a specific item from the inventory. The item is compared
          * by pointer. Contents of the item are removed as well.
@@ -224,6 +238,8 @@ class inventory : public temp_visitable<inventory>
         int count_item( const itype_id &item_type ) const;
 
         void update_quality_cache();
+        /** Adds the quality cache of @p other, for when its items were added to this inventory. */
+        void merge_quality_cache( const inventory &other );
         const std::map<quality_id, std::map<int, int>> &get_quality_cache() const;
 
         void build_items_type_cache();
@@ -6281,6 +6281,12 @@ auto get_hourly_rotpoints_at_temp( const units::temperature temp ) -> int
 }
 
 auto item::calc_rot( time_point time, const units::temperature temp ) const -> time_duration
+{
+    const time_duration time_delta = time - last_rot_check;
+    return calc_rot_from_points( time_delta / 1_hours * get_hourly_rotpoints_at_temp( temp ) );
+}
+
+auto item::calc_rot_from_points( const double rot_points ) const -> time_duration
 {
     // Avoid needlessly calculating already rotten things.  Corpses should
     // always rot away and food rots away at twice the shelf life.  If the food
@@ -6305,8 +6311,7 @@ auto item::calc_rot( time_point time, const units::temperature temp ) const -> t
         time_duration spoil_variation = get_shelf_life() * 0.2f;
         added_rot += rng( -spoil_variation, spoil_variation );
     }
-    time_duration time_delta = time - last_rot_check;
-    added_rot += factor * time_delta / 1_hours * get_hourly_rotpoints_at_temp( temp ) * 1_turns;
+    added_rot += factor * rot_points * 1_turns;
     return added_rot;
 }
 
@@ -9806,29 +9811,6 @@ detached_ptr<item> item::process_rot( detached_ptr<item> &&self, const tripoint
                         get_weather() );
 }
 
-static units::temperature clip_by_temperature_flag( units::temperature temperature,
-        temperature_flag flag )
-{
-    switch( flag ) {
-        case temperature_flag::TEMP_NORMAL:
-            // Just use the temperature normally
-            return temperature;
-        case temperature_flag::TEMP_FRIDGE:
-            return std::min( temperature, temperatures::fridge );
-        case temperature_flag::TEMP_FREEZER:
-            return std::min( temperature, temperatures::freezer );
-        case temperature_flag::TEMP_HEATER:
-            return std::max( temperature, temperatures::normal );
-        case temperature_flag::TEMP_ROOT_CELLAR:
-            return temperatures::root_cellar;
-        default:
-            debugmsg( "Temperature flag enum not valid: %d.  Using current temperature.",
-                      static_cast<int>( flag ) );
-            break;
-    }
-    return temperature;
-}
-
 detached_ptr<item>  item::process_rot( detached_ptr<item> &&self, const bool seals,
                                        const tripoint &pos,
                                        player *carrier, const temperature_flag flag,
@@ -9851,7 +9833,7 @@ detached_ptr<item>  item::process_rot( detached_ptr<item> &&self, const bool sea
     constexpr time_duration smallest_interval = 10_minutes;
 
     units::temperature temp = weather.get_temperature( pos );
-    temp = clip_by_temperature_flag( temp, flag );
+    temp = rot::clip_by_temperature_flag( temp, flag );
 
     time_point time = self->last_rot_check;
     item_internal::scoped_goes_bad_cache _cache( &*self );
@@ -9859,40 +9841,23 @@ detached_ptr<item>  item::process_rot( detached_ptr<item> &&self, const bool sea
     if( now - time > 1_hours ) {
         // This code is for items that were left out of reality bubble for long time
 
-        const weather_generator &wgen = weather.get_cur_weather_gen();
-        const unsigned int seed = g->get_seed();
         // It's a modifier, so we need to subtract 0_f
         units::temperature local_mod = units::from_fahrenheit( g->new_game
                                        ? 0
                                        : get_map().get_temperature( pos ) ) - 0_f;
 
-        // Process the past of this item since the last time it was processed
-        while( now - time > 1_hours ) {
-            // Get the environment temperature
-            time_duration time_delta = std::min( 1_hours, now - 1_hours - time );
-            time += time_delta;
-
-            //Use weather if above ground, use map temp if below
-            units::temperature env_temperature_raw;
-            if( pos.z >= 0 ) {
-                tripoint_abs_ms location = tripoint_abs_ms( get_map().getabs( pos ) );
-                units::temperature weather_temperature = wgen.get_weather_temperature( location, time,
-                        calendar::config, seed );
-                env_temperature_raw = weather_temperature + local_mod;
-            } else {
-                env_temperature_raw = temperatures::annual_average + local_mod;
-            }
+        // Process the past of this item since the last time it was processed, in one go.
+        // The temperatures are shared with the other items on the same submap.
+        const time_point until = now - 1_hours;
+        const double rot_points = rot::rot_points_between( weather.get_cur_weather_gen(), g->get_seed(),
+                                  tripoint_abs_ms( get_map().getabs( pos ) ), local_mod, flag, time, until );
+        self->rot += self->calc_rot_from_points( rot_points );
+        self->last_rot_check = until;
+        time = until;
 
-            units::temperature env_temperature_clipped = clip_by_temperature_flag( env_temperature_raw, flag );
-
-            // Calculate item rot
-            self->rot += self->calc_rot( time, env_temperature_clipped );
-            self->last_rot_check = time;
-
-            if( self->has_rotten_away() && carrier == nullptr && !seals ) {
-                // No need to track item that will be gone
-                return detached_ptr<item>();
-            }
+        if( self->has_rotten_away() && carrier == nullptr && !seals ) {
+            // No need to track item that will be gone
+            return detached_ptr<item>();
         }
     }
 
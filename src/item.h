@@ -898,6 +898,11 @@ class item : public location_visitable<item>, public game_object<item>
          * @param temp Temperature at which the rot is calculated
          */
         auto calc_rot( time_point time, const units::temperature temp ) const -> time_duration;
+        /**
+         * Like @ref calc_rot, for a stretch of time at varying temperatures.
+         * @param rot_points Hourly rot points integrated over the time since the last rot calculation
+         */
+        auto calc_rot_from_points( double rot_points ) const -> time_duration;
 
         /**
          * Time that this item is guaranteed to stay fresh.
@@ -2,11 +2,14 @@
 #include "shadowcasting.h" // IWYU pragma: associated
 
 #include <algorithm>
+#include <bitset>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
 #include <optional>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -24,7 +27,6 @@
 #include "item_stack.h"
 #include "line.h"
 #include "map.h"
-#include "map_iterator.h"
 #include "mapdata.h"
 #include "math_defines.h"
 #include "monster.h"
@@ -103,7 +105,18 @@ void map::add_light_from_items( const tripoint &p, const item_stack::iterator &b
 }
 
 // TODO: Consider making this just clear the cache and dynamically fill it in as is_transparent() is called
-bool map::build_transparency_cache( const int zlev )
+float map::update_weather_transparency()
+{
+    const float sight_penalty = get_weather().weather_id->sight_penalty;
+
+    if( sight_penalty != 1.0f &&
+        LIGHT_TRANSPARENCY_OPEN_AIR * sight_penalty != weather_transparency_lookup.transparency ) {
+        weather_transparency_lookup.reset( LIGHT_TRANSPARENCY_OPEN_AIR * sight_penalty );
+    }
+    return sight_penalty;
+}
+
+bool map::build_transparency_cache( const int zlev, const float sight_penalty )
 {
     auto &map_cache = get_cache( zlev );
     auto &transparency_cache = map_cache.transparency_cache;
@@ -124,13 +137,6 @@ bool map::build_transparency_cache( const int zlev )
                                    static_cast<float>( LIGHT_TRANSPARENCY_OPEN_AIR ) );
     }
 
-    const float sight_penalty = get_weather().weather_id->sight_penalty;
-
-    if( sight_penalty != 1.0f &&
-        LIGHT_TRANSPARENCY_OPEN_AIR * sight_penalty != weather_transparency_lookup.transparency ) {
-        weather_transparency_lookup.reset( LIGHT_TRANSPARENCY_OPEN_AIR * sight_penalty );
-    }
-
     // Traverse the submaps in order
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
@@ -636,13 +642,7 @@ void map::generate_lightmap( const int zlev )
         unbuffered: (12^2)*(160*4) = apply_light_ray x 92160
         buffered:   (12*4)*(160)   = apply_light_ray x 7680
     */
-    const tripoint cache_start( 0, 0, zlev );
-    const tripoint cache_end( LIGHTMAP_CACHE_X, LIGHTMAP_CACHE_Y, zlev );
-    for( const tripoint &p : points_in_rectangle( cache_start, cache_end ) ) {
-        if( light_source_buffer[p.x][p.y] > 0.0 ) {
-            apply_light_source( p, light_source_buffer[p.x][p.y] );
-        }
-    }
+    apply_buffered_light_sources( zlev );
     for( const std::pair<tripoint, float> &elem : lm_override ) {
         lm[elem.first.x][elem.first.y].fill( elem.second );
     }
@@ -850,12 +850,8 @@ bool map::pl_line_of_sight( const tripoint &t, const int max_range ) const
 //This algorithm is highly inaccurate and only suitable for the low (<60) values use in shadowcasting
 //A starting constant of 21 and 4 iterations matches 2d 60^2. 16 and 5 matches 3d 60^3.
 template <int start, int iterations>
-static inline int fast_rl_dist( tripoint to )
+static inline int fast_trig_dist( const tripoint &to )
 {
-    if( !trigdist ) {
-        return square_dist( tripoint_zero, to );
-    }
-
     int val = to.x * to.x + to.y * to.y + to.z * to.z;
 
     if( val < 2 ) {
@@ -872,6 +868,41 @@ static inline int fast_rl_dist( tripoint to )
     return a;
 }
 
+template <int start, int iterations>
+static inline int fast_rl_dist( tripoint to )
+{
+    if( !trigdist ) {
+        return square_dist( tripoint_zero, to );
+    }
+    return fast_trig_dist<start, iterations>( to );
+}
+
+// Distances used by 2D shadowcasting for every tile of an octant, so that rows of tiles
+// don't have to be measured one at a time. First index is whether trigdist is on, then
+// the row (-delta.y) and the column (1 - delta.x, rows go from -row to 1).
+struct shadowcasting_distances {
+    static constexpr int size = 63;
+    int fast[2][size][size];
+    int exact[2][size][size];
+
+    shadowcasting_distances() {
+        for( int row = 0; row < size; row++ ) {
+            for( int column = 0; column < size; column++ ) {
+                const tripoint delta( 1 - column, -row, 0 );
+                fast[0][row][column] = square_dist( tripoint_zero, delta );
+                fast[1][row][column] = fast_trig_dist<21, 4>( delta );
+                exact[0][row][column] = square_dist( tripoint_zero, delta );
+                exact[1][row][column] = static_cast<int>( trig_dist( tripoint_zero, delta ) );
+            }
+        }
+    }
+
+    static const shadowcasting_distances &get() {
+        static const shadowcasting_distances distances;
+        return distances;
+    }
+};
+
 // For a direction vector defined by x, y, return the quadrant that's the
 // source of that direction.  Assumes x != 0 && y != 0
 // NOLINTNEXTLINE(cata-xy)
@@ -1245,6 +1276,7 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
     if( start < end ) {
         return;
     }
+    const shadowcasting_distances &distances = shadowcasting_distances::get();
     T last_intensity = 0.0;
     tripoint delta;
     for( int distance = row; distance <= radius; distance++ ) {
@@ -1260,6 +1292,23 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
                                             ( ( -distance + 0.5f ) * end ) - 0.5f ) ) + 1;
 
         int last_dist = -1;
+        const bool row_in_table = distance < shadowcasting_distances::size - 1;
+        const auto update_intensity = [&]() {
+            if( !eq_nullptr_gcc_hack( lookup ) ) {
+                //Only use fast dist on fast paths, it's slower otherwise. Floating point conversion thing maybe?
+                const int dist = ( row_in_table ? distances.fast[trigdist][distance][1 - delta.x] :
+                                   fast_rl_dist<21, 4>( delta ) ) + offsetDistance;
+                last_intensity = lookup_calc( numerator, lookup->values[dist], dist );
+            } else {
+                const int dist = ( row_in_table ? distances.exact[trigdist][distance][1 - delta.x] :
+                                   rl_dist( tripoint_zero, delta ) ) + offsetDistance;
+                //Only avoid recalculation on the slow path, it's faster to avoid the branch on the fast path
+                if( last_dist != dist ) {
+                    last_intensity = calc( numerator, cumulative_transparency, dist );
+                    last_dist = dist;
+                }
+            }
+        };
         for( ; delta.x <= x_limit; delta.x++ ) {
             point current( offset.x + delta.x * xx + delta.y * xy, offset.y + delta.x * yx + delta.y * yy );
 
@@ -1270,6 +1319,31 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
                 break;
             }*/
 
+            if( started_row ) {
+                // Tiles matching the transparency of the current span only need to be lit,
+                //   find how far that goes and light them in one go.
+                constexpr int stride = xx != 0 ? xx * MAPSIZE_Y : yx;
+                const int in_bounds = xx > 0 ? MAPSIZE_X - current.x : xx < 0 ? current.x + 1 :
+                                      yx > 0 ? MAPSIZE_Y - current.y : current.y + 1;
+                const int run = shadowcasting_run_length( &input_array[current.x][current.y], stride,
+                                std::min( x_limit - delta.x + 1, in_bounds ), current_transparency );
+                for( int i = 0; i < run; i++ ) {
+                    if( i > 0 ) {
+                        delta.x++;
+                        current += point( xx, yx );
+                    }
+                    if( check_blocked( current ) ) {
+                        continue;
+                    }
+                    update_intensity();
+                    update_output( output_cache[current.x][current.y], last_intensity,
+                                   check( current_transparency, last_intensity ) ? quadrant::default_ : quad );
+                }
+                if( run > 0 ) {
+                    continue;
+                }
+            }
+
             if( check_blocked( current ) ) {
                 continue;
             }
@@ -1277,18 +1351,7 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
                 started_row = true;
                 current_transparency = input_array[ current.x ][ current.y ];
             }
-            if( !eq_nullptr_gcc_hack( lookup ) ) {
-                //Only use fast dist on fast paths, it's slower otherwise. Floating point conversion thing maybe?
-                const int dist = fast_rl_dist<21, 4>( delta ) + offsetDistance;
-                last_intensity = lookup_calc( numerator, lookup->values[dist], dist );
-            } else {
-                const int dist = rl_dist( tripoint_zero, delta ) + offsetDistance;
-                //Only avoid recalculation on the slow path, it's faster to avoid the branch on the fast path
-                if( last_dist != dist ) {
-                    last_intensity = calc( numerator, cumulative_transparency, dist );
-                    last_dist = dist;
-                }
-            }
+            update_intensity();
 
             T new_transparency = input_array[ current.x ][ current.y ];
 
@@ -1758,28 +1821,14 @@ static float light_from_lookup( const float &numerator, const float &transparenc
     return numerator *  transparency  / distance ;
 }
 
-void map::apply_light_source( const tripoint &p, float luminance )
-{
-    auto &cache = get_cache( p.z );
-    four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y] = cache.lm;
-    float ( &sm )[MAPSIZE_X][MAPSIZE_Y] = cache.sm;
-    float ( &transparency_cache )[MAPSIZE_X][MAPSIZE_Y] = cache.transparency_cache;
-    float ( &light_source_buffer )[MAPSIZE_X][MAPSIZE_Y] = cache.light_source_buffer;
-    diagonal_blocks( &blocked_cache )[MAPSIZE_X][MAPSIZE_Y] = cache.vehicle_obscured_cache;
-
-    const point p2( p.xy() );
-
-    if( inbounds( p ) ) {
-        const float min_light = std::max( static_cast<float>( lit_level::LOW ), luminance );
-        lm[p2.x][p2.y] = elementwise_max( lm[p2.x][p2.y], min_light );
-        sm[p2.x][p2.y] = std::max( sm[p2.x][p2.y], luminance );
-    }
-    if( luminance <= lit_level::LOW ) {
-        return;
-    } else if( luminance <= lit_level::BRIGHT_ONLY ) {
-        luminance = 1.49f;
-    }
+static constexpr uint8_t light_north = 1 << 0;
+static constexpr uint8_t light_east = 1 << 1;
+static constexpr uint8_t light_south = 1 << 2;
+static constexpr uint8_t light_west = 1 << 3;
 
+static uint8_t light_source_directions( const float ( &light_source_buffer )[MAPSIZE_X][MAPSIZE_Y],
+                                        const point &p, const float luminance )
+{
     /* If we're a 5 luminance fire , we skip casting rays into ey && sx if we have
          neighboring fires to the north and west that were applied via light_source_buffer
        If there's a 1 luminance candle east in buffer, we still cast rays into ex since it's smaller
@@ -1797,12 +1846,30 @@ void map::apply_light_source( const tripoint &p, float luminance )
            sy
     */
     const int peer_inbounds = LIGHTMAP_CACHE_X - 1;
-    bool north = ( p2.y != 0 && light_source_buffer[p2.x][p2.y - 1] < luminance );
-    bool south = ( p2.y != peer_inbounds && light_source_buffer[p2.x][p2.y + 1] < luminance );
-    bool east = ( p2.x != peer_inbounds && light_source_buffer[p2.x + 1][p2.y] < luminance );
-    bool west = ( p2.x != 0 && light_source_buffer[p2.x - 1][p2.y] < luminance );
+    uint8_t directions = 0;
+    if( p.y != 0 && light_source_buffer[p.x][p.y - 1] < luminance ) {
+        directions |= light_north;
+    }
+    if( p.y != peer_inbounds && light_source_buffer[p.x][p.y + 1] < luminance ) {
+        directions |= light_south;
+    }
+    if( p.x != peer_inbounds && light_source_buffer[p.x + 1][p.y] < luminance ) {
+        directions |= light_east;
+    }
+    if( p.x != 0 && light_source_buffer[p.x - 1][p.y] < luminance ) {
+        directions |= light_west;
+    }
+    return directions;
+}
+
+static void cast_light_source( four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                               const level_cache &cache, const point &p2, const float luminance,
+                               const uint8_t directions )
+{
+    const float ( &transparency_cache )[MAPSIZE_X][MAPSIZE_Y] = cache.transparency_cache;
+    const diagonal_blocks( &blocked_cache )[MAPSIZE_X][MAPSIZE_Y] = cache.vehicle_obscured_cache;
 
-    if( north ) {
+    if( directions & light_north ) {
         castLightWithLookup < 1, 0, 0, -1, float, four_quadrants, light_calc, light_check,
                             update_light_quadrants, accumulate_transparency, light_from_lookup > (
                                 lm, transparency_cache, blocked_cache, p2, 0, luminance );
@@ -1811,7 +1878,7 @@ void map::apply_light_source( const tripoint &p, float luminance )
                                 lm, transparency_cache, blocked_cache, p2, 0, luminance );
     }
 
-    if( east ) {
+    if( directions & light_east ) {
         castLightWithLookup < 0, -1, 1, 0, float, four_quadrants, light_calc, light_check,
                             update_light_quadrants, accumulate_transparency, light_from_lookup > (
                                 lm, transparency_cache, blocked_cache, p2, 0, luminance );
@@ -1820,7 +1887,7 @@ void map::apply_light_source( const tripoint &p, float luminance )
                                 lm, transparency_cache, blocked_cache, p2, 0, luminance );
     }
 
-    if( south ) {
+    if( directions & light_south ) {
         castLightWithLookup<1, 0, 0, 1, float, four_quadrants, light_calc, light_check,
                             update_light_quadrants, accumulate_transparency, light_from_lookup>(
                                 lm, transparency_cache, blocked_cache, p2, 0, luminance );
@@ -1829,7 +1896,7 @@ void map::apply_light_source( const tripoint &p, float luminance )
                                 lm, transparency_cache, blocked_cache, p2, 0, luminance );
     }
 
-    if( west ) {
+    if( directions & light_west ) {
         castLightWithLookup<0, 1, 1, 0, float, four_quadrants, light_calc, light_check,
                             update_light_quadrants, accumulate_transparency, light_from_lookup>(
                                 lm, transparency_cache, blocked_cache, p2, 0, luminance );
@@ -1839,6 +1906,167 @@ void map::apply_light_source( const tripoint &p, float luminance )
     }
 }
 
+void map::apply_light_source( const tripoint &p, float luminance )
+{
+    auto &cache = get_cache( p.z );
+    four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y] = cache.lm;
+    float ( &sm )[MAPSIZE_X][MAPSIZE_Y] = cache.sm;
+
+    const point p2( p.xy() );
+
+    if( inbounds( p ) ) {
+        const float min_light = std::max( static_cast<float>( lit_level::LOW ), luminance );
+        lm[p2.x][p2.y] = elementwise_max( lm[p2.x][p2.y], min_light );
+        sm[p2.x][p2.y] = std::max( sm[p2.x][p2.y], luminance );
+    }
+    if( luminance <= lit_level::LOW ) {
+        return;
+    } else if( luminance <= lit_level::BRIGHT_ONLY ) {
+        luminance = 1.49f;
+    }
+
+    cast_light_source( lm, cache, p2, luminance,
+                       light_source_directions( cache.light_source_buffer, p2, luminance ) );
+}
+
+// Finds the submaps whose transparency changed since the bulk light sources were last cast,
+// and remembers the current state for next time.
+static std::bitset<MAPSIZE *MAPSIZE> light_source_changed_submaps( level_cache &cache )
+{
+    std::bitset<MAPSIZE *MAPSIZE> changed;
+    if( cache.light_source_trigdist != trigdist ||
+        cache.light_source_weather_transparency != weather_transparency_lookup.transparency ) {
+        cache.light_source_trigdist = trigdist;
+        cache.light_source_weather_transparency = weather_transparency_lookup.transparency;
+        changed.set();
+    }
+    for( int smx = 0; smx < MAPSIZE; ++smx ) {
+        for( int smy = 0; smy < MAPSIZE; ++smy ) {
+            const int y = smy * SEEY;
+            for( int x = smx * SEEX; x < ( smx + 1 ) * SEEX; ++x ) {
+                if( std::memcmp( &cache.transparency_cache[x][y], &cache.light_source_transparency[x][y],
+                                 SEEY * sizeof( float ) ) != 0 ||
+                    std::memcmp( &cache.vehicle_obscured_cache[x][y], &cache.light_source_obscured[x][y],
+                                 SEEY * sizeof( diagonal_blocks ) ) != 0 ) {
+                    changed.set( smx * MAPSIZE + smy );
+                    break;
+                }
+            }
+        }
+    }
+    std::memcpy( cache.light_source_transparency, cache.transparency_cache,
+                 sizeof( cache.transparency_cache ) );
+    std::memcpy( cache.light_source_obscured, cache.vehicle_obscured_cache,
+                 sizeof( cache.vehicle_obscured_cache ) );
+    return changed;
+}
+
+// Light of a single source, cast apart from the rest of the lightmap.
+struct light_source_scratch {
+    four_quadrants lm[MAPSIZE_X][MAPSIZE_Y];
+};
+
+static light_source_result cast_light_source_result( const level_cache &cache, const point &p,
+        const float luminance, const uint8_t directions )
+{
+    thread_local std::unique_ptr<light_source_scratch> scratch;
+    if( !scratch ) {
+        scratch = std::make_unique<light_source_scratch>();
+    }
+    four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y] = scratch->lm;
+    cast_light_source( lm, cache, p, luminance, directions );
+
+    // Light falls off at least as fast as luminance / distance, and casting stops at the
+    // first row that drops below LIGHT_AMBIENT_LOW.
+    const int radius = std::min( 60, static_cast<int>( luminance / LIGHT_AMBIENT_LOW ) + 2 );
+    const point scan_min( std::max( p.x - radius, 0 ), std::max( p.y - radius, 0 ) );
+    const point scan_max( std::min( p.x + radius, MAPSIZE_X - 1 ), std::min( p.y + radius,
+                          MAPSIZE_Y - 1 ) );
+
+    light_source_result result;
+    result.luminance = luminance;
+    result.directions = directions;
+    point lit_min = p;
+    point lit_max = p;
+    constexpr four_quadrants four_zeros( 0.0f );
+    for( int x = scan_min.x; x <= scan_max.x; ++x ) {
+        for( int y = scan_min.y; y <= scan_max.y; ++y ) {
+            if( lm[x][y].max() <= 0.0f ) {
+                continue;
+            }
+            result.lit.emplace_back( point( x, y ), lm[x][y] );
+            lm[x][y] = four_zeros;
+            lit_min = point( std::min( lit_min.x, x ), std::min( lit_min.y, y ) );
+            lit_max = point( std::max( lit_max.x, x ), std::max( lit_max.y, y ) );
+        }
+    }
+    // Diagonal blocks are looked up on the neighbours of the tiles being lit, and a row
+    // made only of blocked tiles stays dark, so leave some margin around the lit area.
+    constexpr int margin = 2;
+    result.sm_min = point( std::max( lit_min.x - margin, 0 ) / SEEX,
+                           std::max( lit_min.y - margin, 0 ) / SEEY );
+    result.sm_max = point( std::min( lit_max.x + margin, MAPSIZE_X - 1 ) / SEEX,
+                           std::min( lit_max.y + margin, MAPSIZE_Y - 1 ) / SEEY );
+    return result;
+}
+
+void map::apply_buffered_light_sources( const int zlev )
+{
+    ZoneScoped;
+    auto &cache = get_cache( zlev );
+    four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y] = cache.lm;
+    float ( &sm )[MAPSIZE_X][MAPSIZE_Y] = cache.sm;
+    const float ( &light_source_buffer )[MAPSIZE_X][MAPSIZE_Y] = cache.light_source_buffer;
+
+    // A source's light only depends on its luminance, the neighbouring sources and the
+    // transparency around it, so sources where none of those changed are not cast again.
+    const std::bitset<MAPSIZE *MAPSIZE> changed = light_source_changed_submaps( cache );
+    const auto reach_changed = [&changed]( const light_source_result & result ) {
+        for( int smx = result.sm_min.x; smx <= result.sm_max.x; ++smx ) {
+            for( int smy = result.sm_min.y; smy <= result.sm_max.y; ++smy ) {
+                if( changed[smx * MAPSIZE + smy] ) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    std::unordered_map<point, light_source_result> results;
+    for( int x = 0; x < LIGHTMAP_CACHE_X; ++x ) {
+        for( int y = 0; y < LIGHTMAP_CACHE_Y; ++y ) {
+            float luminance = light_source_buffer[x][y];
+            if( luminance <= 0.0f ) {
+                continue;
+            }
+            const float min_light = std::max( static_cast<float>( lit_level::LOW ), luminance );
+            lm[x][y] = elementwise_max( lm[x][y], min_light );
+            sm[x][y] = std::max( sm[x][y], luminance );
+            if( luminance <= lit_level::LOW ) {
+                continue;
+            } else if( luminance <= lit_level::BRIGHT_ONLY ) {
+                luminance = 1.49f;
+            }
+
+            const point p( x, y );
+            const uint8_t directions = light_source_directions( light_source_buffer, p, luminance );
+            const auto cached = cache.light_source_results.find( p );
+            light_source_result result;
+            if( cached != cache.light_source_results.end() && cached->second.luminance == luminance &&
+                cached->second.directions == directions && !reach_changed( cached->second ) ) {
+                result = std::move( cached->second );
+            } else {
+                result = cast_light_source_result( cache, p, luminance, directions );
+            }
+            for( const std::pair<point, four_quadrants> &lit : result.lit ) {
+                lm[lit.first.x][lit.first.y] = elementwise_max( lm[lit.first.x][lit.first.y], lit.second );
+            }
+            results.emplace( p, std::move( result ) );
+        }
+    }
+    cache.light_source_results = std::move( results );
+}
+
 void map::apply_directional_light( const tripoint &p, int direction, float luminance )
 {
     const point p2( p.xy() );
@@ -0,0 +1,117 @@
+#include "los_cache.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "game_constants.h"
+#include "point.h"
+
+static constexpr int endpoint_bits = 24;
+static constexpr int value_bit = 2 * endpoint_bits;
+static constexpr int generation_shift = value_bit + 1;
+static constexpr uint16_t max_generation = ( 1 << ( 64 - generation_shift ) ) - 1;
+static constexpr uint64_t key_mask = ( uint64_t( 1 ) << value_bit ) - 1;
+static constexpr size_t max_probes = 8;
+
+// Squares outside of 0-255 on any axis aren't cached, sees() also gets called
+// with origins outside of the map
+static std::optional<uint32_t> pack_endpoint( const tripoint &p )
+{
+    const int z = p.z + OVERMAP_DEPTH;
+    if( p.x < 0 || p.x > 255 || p.y < 0 || p.y > 255 || z < 0 || z > 255 ) {
+        return std::nullopt;
+    }
+    return static_cast<uint32_t>( p.x << 16 | p.y << 8 | z );
+}
+
+static std::optional<uint64_t> pair_key( const tripoint &a, const tripoint &b )
+{
+    const std::optional<uint32_t> first = pack_endpoint( a );
+    const std::optional<uint32_t> second = pack_endpoint( b );
+    if( !first || !second ) {
+        return std::nullopt;
+    }
+    // Sorted, so the cache is reflexive
+    const uint64_t low = std::min( *first, *second );
+    const uint64_t high = std::max( *first, *second );
+    return low << endpoint_bits | high;
+}
+
+static size_t home_slot( const uint64_t key )
+{
+    static_assert( ( los_cache::capacity & ( los_cache::capacity - 1 ) ) == 0 );
+    // Fibonacci hashing, neighbouring squares differ only in a few bits
+    return ( key * 0x9E3779B97F4A7C15ULL ) >> ( 64 - std::countr_zero( los_cache::capacity ) );
+}
+
+std::optional<bool> los_cache::get( const tripoint &a, const tripoint &b ) const
+{
+    if( !data ) {
+        return std::nullopt;
+    }
+    const std::optional<uint64_t> key = pair_key( a, b );
+    if( key ) {
+        const size_t home = home_slot( *key );
+        for( size_t i = 0; i < max_probes; i++ ) {
+            const uint64_t slot = data->slots[( home + i ) & ( capacity - 1 )].load(
+                                      std::memory_order_relaxed );
+            if( ( slot >> generation_shift ) == generation && ( slot & key_mask ) == *key ) {
+                data->hits.fetch_add( 1, std::memory_order_relaxed );
+                return ( slot >> value_bit & 1 ) != 0;
+            }
+        }
+    }
+    data->misses.fetch_add( 1, std::memory_order_relaxed );
+    return std::nullopt;
+}
+
+void los_cache::insert( const tripoint &a, const tripoint &b, const bool visible )
+{
+    const std::optional<uint64_t> key = pair_key( a, b );
+    if( !data || !key ) {
+        return;
+    }
+    const uint64_t entry = static_cast<uint64_t>( generation ) << generation_shift |
+                           static_cast<uint64_t>( visible ) << value_bit | *key;
+    const size_t home = home_slot( *key );
+    size_t target = home;
+    for( size_t i = 0; i < max_probes; i++ ) {
+        const size_t index = ( home + i ) & ( capacity - 1 );
+        const uint64_t slot = data->slots[index].load( std::memory_order_relaxed );
+        if( ( slot >> generation_shift ) != generation || ( slot & key_mask ) == *key ) {
+            target = index;
+            break;
+        }
+    }
+    // Racing inserts may store the same pair twice, both copies hold the same result
+    data->slots[target].store( entry, std::memory_order_relaxed );
+}
+
+void los_cache::invalidate()
+{
+    if( !data ) {
+        data = std::make_unique<storage>();
+        for( std::atomic<uint64_t> &slot : data->slots ) {
+            slot.store( 0, std::memory_order_relaxed );
+        }
+    } else if( generation == max_generation ) {
+        for( std::atomic<uint64_t> &slot : data->slots ) {
+            slot.store( 0, std::memory_order_relaxed );
+        }
+        generation = 0;
+    }
+    // Generation 0 is never current, so zeroed slots are empty
+    generation++;
+    data->hits.store( 0, std::memory_order_relaxed );
+    data->misses.store( 0, std::memory_order_relaxed );
+}
+
+los_cache::stats los_cache::current_stats() const
+{
+    stats result;
+    if( data ) {
+        result.hits = data->hits.load( std::memory_order_relaxed );
+        result.misses = data->misses.load( std::memory_order_relaxed );
+    }
+    return result;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+struct tripoint;
+
+/**
+ * Memo of line of sight results between pairs of map squares, see map::sees.
+ *
+ * A fixed-size open addressing table where each slot is a single atomic word holding
+ * both endpoints, the result and the generation it was stored in. Lookups and inserts
+ * don't lock, so map::sees can run on several threads at once. When the table is full
+ * around a key an older entry is overwritten, losing entries only costs a recalculation.
+ *
+ * Entries are invalidated all at once by bumping the generation instead of wiping the table.
+ * The table is only allocated by the first @ref invalidate, so maps that never build their
+ * vision caches (e.g. tinymaps) don't pay for it; until then nothing is cached.
+ */
+class los_cache
+{
+    public:
+        struct stats {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+
+            double hit_rate() const {
+                return hits + misses == 0 ? 0.0 : static_cast<double>( hits ) / ( hits + misses );
+            }
+        };
+
+        /** Returns the cached result for the pair, the order of the points doesn't matter. */
+        std::optional<bool> get( const tripoint &a, const tripoint &b ) const;
+        void insert( const tripoint &a, const tripoint &b, bool visible );
+        /** Forgets all entries. Must not run concurrently with @ref get or @ref insert. */
+        void invalidate();
+
+        /** Hits and misses since the last call to @ref invalidate. */
+        stats current_stats() const;
+
+        static constexpr size_t capacity = size_t( 1 ) << 17;
+
+    private:
+        struct storage {
+            std::array<std::atomic<uint64_t>, capacity> slots;
+            mutable std::atomic<uint64_t> hits;
+            mutable std::atomic<uint64_t> misses;
+        };
+        std::unique_ptr<storage> data;
+        uint16_t generation = 1;
+};
@@ -72,5 +72,4 @@ const std::list<typename lru_cache<Key, Value>::Pair> &lru_cache<Key, Value>::li
 
 // explicit template initialization for lru_cache of all types
 template class lru_cache<tripoint, int>;
-template class lru_cache<point, char>;
 template class lru_cache<std::string, shared_ptr_fast<std::istringstream>>;
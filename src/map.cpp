@@ -6,11 +6,14 @@
 #include <climits>
 #include <cstdlib>
 #include <cstring>
+#include <future>
 #include <ranges>
 #include <limits>
 #include <optional>
 #include <ostream>
 #include <queue>
+#include <set>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <variant>
@@ -22,6 +25,7 @@
 #include "artifact.h"
 #include "avatar.h"
 #include "bodypart.h"
+#include "cached_options.h"
 #include "calendar.h"
 #include "cata_utility.h"
 #include "character.h"
@@ -80,6 +84,7 @@
 #include "output.h"
 #include "overmapbuffer.h"
 #include "legacy_pathfinding.h"
+#include "pathfinding.h"
 #include "player.h"
 #include "point_float.h"
 #include "projectile.h"
@@ -105,6 +110,7 @@
 #include "vpart_range.h"
 #include "weather.h"
 #include "weighted_list.h"
+#include "world.h"
 
 struct ammo_effect;
 using ammo_effect_str_id = string_id<ammo_effect>;
@@ -368,8 +374,9 @@ void map::add_vehicle_to_cache( vehicle *veh )
             ch.veh_cached_parts[p] = std::make_pair( veh,  static_cast<int>( vpr.part_index() ) );
         }
         if( inbounds( p ) ) {
-            ch.veh_exists_at[p.x][p.y] = true;
+            ch.set_veh_exists_at( p.xy(), true );
         }
+        set_pathfinding_cache_dirty( p );
     }
 
     last_full_vehicle_list_dirty = true;
@@ -386,7 +393,7 @@ void map::clear_vehicle_point_from_cache( vehicle *veh, const tripoint &pt )
     auto it = ch.veh_cached_parts.find( pt );
     if( it != ch.veh_cached_parts.end() && it->second.first == veh ) {
         if( inbounds( pt ) ) {
-            ch.veh_exists_at[pt.x][pt.y] = false;
+            ch.set_veh_exists_at( pt.xy(), false );
         }
         ch.veh_cached_parts.erase( it );
     }
@@ -399,14 +406,8 @@ void map::clear_vehicle_cache( )
     const int zmax = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
     for( int zlev = zmin; zlev <= zmax; zlev++ ) {
         level_cache &ch = get_cache( zlev );
-        while( !ch.veh_cached_parts.empty() ) {
-            const auto part = ch.veh_cached_parts.begin();
-            const auto &p = part->first;
-            if( inbounds( p ) ) {
-                ch.veh_exists_at[p.x][p.y] = false;
-            }
-            ch.veh_cached_parts.erase( part );
-        }
+        ch.veh_cached_parts.clear();
+        ch.clear_veh_exists_at();
         ch.veh_in_active_range = false;
     }
 }
@@ -457,6 +458,9 @@ std::unique_ptr<vehicle> map::detach_vehicle( vehicle *veh )
         }
     }
     veh->invalidate_towing( true );
+    for( const vpart_reference &vpr : veh->get_all_parts() ) {
+        set_pathfinding_cache_dirty( veh->global_part_pos3( vpr.part() ) );
+    }
     submap *const current_submap = get_submap_at_grid( veh->sm_pos );
     level_cache &ch = get_cache( z );
     for( size_t i = 0; i < current_submap->vehicles.size(); i++ ) {
@@ -515,6 +519,7 @@ void map::vehmove()
         }
     }
 
+    queue_vehicle_moves( vehicle_list );
     // 15 equals 3 >50mph vehicles, or up to 15 slow (1 square move) ones
     // But 15 is too low for V12 death-bikes, let's put 100 here
     for( int count = 0; count < 100; count++ ) {
@@ -522,6 +527,7 @@ void map::vehmove()
             break;
         }
     }
+    vehicle_moves.clear();
     // Process item removal on the vehicles that were modified this turn.
     // Use a copy because part_removal_cleanup can modify the container.
     auto temp = dirty_vehicle_list;
@@ -546,23 +552,30 @@ void map::vehmove()
     }
 }
 
+void map::queue_vehicle_moves( const VehicleList &vehicle_list )
+{
+    std::vector<vehicle *> vehicles;
+    vehicles.reserve( vehicle_list.size() );
+    for( const wrapped_vehicle &vehs_v : vehicle_list ) {
+        vehicles.push_back( vehs_v.v );
+    }
+    vehicle_moves.assign( vehicles );
+}
+
 bool map::vehproceed( VehicleList &vehicle_list )
 {
-    wrapped_vehicle *cur_veh = nullptr;
-    float max_of_turn = 0;
-    // First horizontal movement
-    for( wrapped_vehicle &vehs_v : vehicle_list ) {
-        if( vehs_v.v->of_turn > max_of_turn ) {
-            cur_veh = &vehs_v;
-            max_of_turn = cur_veh->v->of_turn;
-        }
+    if( vehicle_moves.empty() ) {
+        // Called on its own, outside of vehmove
+        queue_vehicle_moves( vehicle_list );
     }
+    // First horizontal movement
+    vehicle *cur_veh = vehicle_moves.next();
 
     // Then vertical-only movement
     if( cur_veh == nullptr ) {
         for( wrapped_vehicle &vehs_v : vehicle_list ) {
             if( vehs_v.v->is_falling || ( vehs_v.v->is_aircraft() && vehs_v.v->get_z_change() != 0 ) ) {
-                cur_veh = &vehs_v;
+                cur_veh = vehs_v.v;
                 break;
             }
         }
@@ -572,9 +585,10 @@ bool map::vehproceed( VehicleList &vehicle_list )
         return false;
     }
 
-    cur_veh->v = cur_veh->v->act_on_map();
-    if( cur_veh->v == nullptr ) {
+    vehicle *const moved = cur_veh->act_on_map();
+    if( moved == nullptr ) {
         vehicle_list = get_vehicles();
+        queue_vehicle_moves( vehicle_list );
     }
 
     // confirm that veh_in_active_range is still correct for each z-level
@@ -582,15 +596,7 @@ bool map::vehproceed( VehicleList &vehicle_list )
     int maxz = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
     for( int zlev = minz; zlev <= maxz; ++zlev ) {
         level_cache &cache = get_cache( zlev );
-
-        // Check if any vehicles exist in the active range for this z-level
-        cache.veh_in_active_range = cache.veh_in_active_range &&
-                                    std::ranges::any_of( cache.veh_exists_at,
-        []( const auto & row ) {
-            return std::any_of( std::begin( row ), std::end( row ), []( bool veh_exists ) {
-                return veh_exists;
-            } );
-        } );
+        cache.veh_in_active_range = cache.veh_in_active_range && cache.veh_exists_count > 0;
     }
 
     return true;
@@ -972,6 +978,8 @@ float map::vehicle_vehicle_collision( vehicle &veh, vehicle &veh2,
 
         veh.of_turn = avg_of_turn * .9;
         veh2.of_turn = avg_of_turn * 1.1;
+        vehicle_moves.update( veh );
+        vehicle_moves.update( veh2 );
 
         // Remember that the impulse on vehicle 1 is techncally negative, slowing it
         veh1_impulse = std::abs( m1 * ( vel1_y_a - vel1_y ) );
@@ -1550,7 +1558,7 @@ void map::furn_set( const tripoint &p, const furn_id &new_furniture,
     set_memory_seen_cache_dirty( p );
 
     // TODO: Limit to changes that affect move cost, traps and stairs
-    set_pathfinding_cache_dirty( p.z );
+    set_pathfinding_cache_dirty( p );
 
     // Make sure the furniture falls if it needs to
     support_dirty( p );
@@ -1894,7 +1902,7 @@ bool map::ter_set( const tripoint &p, const ter_id &new_terrain )
     set_memory_seen_cache_dirty( p );
 
     // TODO: Limit to changes that affect move cost, traps and stairs
-    set_pathfinding_cache_dirty( p.z );
+    set_pathfinding_cache_dirty( p );
 
     tripoint above( p.xy(), p.z + 1 );
     // Make sure that if we supported something and no longer do so, it falls down
@@ -5700,6 +5708,7 @@ void map::trap_set( const tripoint &p, const trap_id &type )
     if( type != tr_null ) {
         traplocs[type.to_i()].push_back( p );
     }
+    set_pathfinding_cache_dirty( p );
 }
 
 void map::disarm_trap( const tripoint &p )
@@ -5781,6 +5790,7 @@ void map::remove_trap( const tripoint &p )
         if( iter != traps.end() ) {
             traps.erase( iter );
         }
+        set_pathfinding_cache_dirty( p );
     }
 }
 /*
@@ -5926,6 +5936,7 @@ bool map::add_field( const tripoint &p, const field_type_id &type_id, int intens
     invalidate_max_populated_zlev( p.z );
 
     if( current_submap->get_field( l ).add_field( type_id, intensity, age ) ) {
+        current_submap->field_tiles.mark( l );
         //Only adding it to the count if it doesn't exist.
         if( !current_submap->field_count++ ) {
             get_cache( p.z ).field_cache.set( static_cast<size_t>( p.x / SEEX + ( (
@@ -5948,7 +5959,7 @@ bool map::add_field( const tripoint &p, const field_type_id &type_id, int intens
     }
 
     if( fd_type.is_dangerous() ) {
-        set_pathfinding_cache_dirty( p.z );
+        set_pathfinding_cache_dirty( p );
     }
 
     // Ensure blood type fields don't hang in the air
@@ -5980,7 +5991,7 @@ void map::remove_field( const tripoint &p, const field_type_id &field_to_remove
             set_seen_cache_dirty( p );
         }
         if( fdata.is_dangerous() ) {
-            set_pathfinding_cache_dirty( p.z );
+            set_pathfinding_cache_dirty( p );
         }
     }
 }
@@ -6619,17 +6630,8 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
         bresenham_slope = 0;
         return false; // Out of range!
     }
-    // Cannonicalize the order of the tripoints so the cache is reflexive.
-    const tripoint &min = F < T ? F : T;
-    const tripoint &max = !( F < T ) ? F : T;
-    // A little gross, just pack the values into a point.
-    const point key(
-        min.x << 16 | min.y << 8 | ( min.z + OVERMAP_DEPTH ),
-        max.x << 16 | max.y << 8 | ( max.z + OVERMAP_DEPTH )
-    );
-    char cached = skew_vision_cache.get( key, -1 );
-    if( cached >= 0 ) {
-        return cached > 0;
+    if( const std::optional<bool> cached = skew_vision_cache.get( F, T ) ) {
+        return *cached;
     }
 
     bool visible = true;
@@ -6652,7 +6654,7 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
             last_point = new_point;
             return true;
         } );
-        skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+        skew_vision_cache.insert( F, T, visible );
         return visible;
     }
 
@@ -6685,7 +6687,7 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
         last_point = new_point;
         return true;
     } );
-    skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+    skew_vision_cache.insert( F, T, visible );
     return visible;
 }
 
@@ -7107,6 +7109,58 @@ void map::load( const tripoint_abs_sm &w, const bool update_vehicle, const bool
     load( w.raw(), update_vehicle, pump_events );
 }
 
+/** How many z-levels above and below the current one @ref map::prefetch_submaps reads. */
+static constexpr int prefetch_z_reach = 1;
+
+void map::prefetch_submaps( point heading, int distance ) const
+{
+    world *active_world = g->get_active_world();
+    if( heading == point_zero || distance <= 0 || active_world == nullptr ) {
+        return;
+    }
+
+    const tripoint abs = get_abs_sub();
+    // Only the levels close to the current one are read ahead, the others rarely have much
+    // saved on them and are read when the map shifts. The current level goes first.
+    std::vector<int> levels = { abs.z };
+    if( zlevels ) {
+        for( int offset = 1; offset <= prefetch_z_reach; offset++ ) {
+            if( abs.z - offset >= -OVERMAP_DEPTH ) {
+                levels.push_back( abs.z - offset );
+            }
+            if( abs.z + offset <= OVERMAP_HEIGHT ) {
+                levels.push_back( abs.z + offset );
+            }
+        }
+    }
+    std::vector<tripoint> quads;
+    std::set<tripoint> requested;
+    const auto request = [&]( point grid, int z ) {
+        const tripoint om_addr = sm_to_omt_copy( tripoint( abs.xy() + grid, z ) );
+        // Quads are loaded and unloaded as a whole
+        if( !MAPBUFFER.is_submap_loaded( omt_to_sm_copy( om_addr ) ) &&
+            requested.insert( om_addr ).second ) {
+            quads.push_back( om_addr );
+        }
+    };
+    // Ring by ring, so the nearest submaps are read first
+    for( int ring = 1; ring <= distance; ring++ ) {
+        const int edge_x = heading.x > 0 ? my_MAPSIZE - 1 + ring : -ring;
+        const int edge_y = heading.y > 0 ? my_MAPSIZE - 1 + ring : -ring;
+        for( const int z : levels ) {
+            for( int along = -ring; along < my_MAPSIZE + ring; along++ ) {
+                if( heading.x != 0 ) {
+                    request( point( edge_x, along ), z );
+                }
+                if( heading.y != 0 ) {
+                    request( point( along, edge_y ), z );
+                }
+            }
+        }
+    }
+    active_world->prefetch_map_quads( quads );
+}
+
 void map::shift_traps( const tripoint &shift )
 {
     // Offset needs to have sign opposite to shift direction
@@ -8578,6 +8632,29 @@ void map::build_obstacle_cache( const tripoint &start, const tripoint &end,
 }
 
 bool map::build_floor_cache( const int zlev )
+{
+    if( get_cache( zlev ).floor_cache_dirty ) {
+        report_unloaded_floor_submaps( zlev );
+    }
+    return fill_floor_cache( zlev );
+}
+
+void map::report_unloaded_floor_submaps( const int zlev ) const
+{
+    const bool lowest_z_lev = zlev <= -OVERMAP_DEPTH;
+    for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
+        for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+            if( get_submap_at_grid( { smx, smy, zlev } ) == nullptr ) {
+                debugmsg( "Tried to build floor cache at (%d,%d,%d) but the submap is not loaded", smx, smy, zlev );
+            } else if( !lowest_z_lev && get_submap_at_grid( { smx, smy, zlev - 1 } ) == nullptr ) {
+                debugmsg( "Tried to build floor cache at (%d,%d,%d) but the submap is not loaded", smx, smy,
+                          zlev - 1 );
+            }
+        }
+    }
+}
+
+bool map::fill_floor_cache( const int zlev )
 {
     auto &ch = get_cache( zlev );
     if( !ch.floor_cache_dirty ) {
@@ -8594,13 +8671,7 @@ bool map::build_floor_cache( const int zlev )
             const submap *cur_submap = get_submap_at_grid( { smx, smy, zlev } );
             const submap *below_submap = !lowest_z_lev ? get_submap_at_grid( { smx, smy, zlev - 1 } ) : nullptr;
 
-            if( cur_submap == nullptr ) {
-                debugmsg( "Tried to build floor cache at (%d,%d,%d) but the submap is not loaded", smx, smy, zlev );
-                continue;
-            }
-            if( !lowest_z_lev && below_submap == nullptr ) {
-                debugmsg( "Tried to build floor cache at (%d,%d,%d) but the submap is not loaded", smx, smy,
-                          zlev - 1 );
+            if( cur_submap == nullptr || ( !lowest_z_lev && below_submap == nullptr ) ) {
                 continue;
             }
 
@@ -8800,23 +8871,67 @@ void map::build_map_cache( const int zlev, bool skip_lightmap )
     const int maxz = zlevels ? OVERMAP_HEIGHT : zlev;
     bool seen_cache_dirty = false;
     std::vector<int> dirty_seen_cache_levels;
+    // Marks supports dirty in a map-wide set, so it can't run next to the other levels
     for( int z = minz; z <= maxz; z++ ) {
-        // trigger FOV recalculation only when there is a change on the player's level or if fov_3d is enabled
-        const bool affects_seen_cache =  z == zlev || fov_3d;
-        build_outside_cache( z );
-        build_transparency_cache( z );
         update_suspension_cache( z );
-        seen_cache_dirty |= ( build_floor_cache( z ) && affects_seen_cache );
-        const bool level_seen_dirty = get_cache( z ).seen_cache_dirty;
-        seen_cache_dirty |= level_seen_dirty;
-        if( level_seen_dirty ) {
-            dirty_seen_cache_levels.push_back( z );
+    }
+
+    // Shared by all levels, so it has to be up to date before any of them are built.
+    // Looking up the weather isn't safe from the workers.
+    const float sight_penalty = update_weather_transparency();
+    // Debug messages aren't safe to show from the workers
+    for( int z = minz; z <= maxz; z++ ) {
+        if( get_cache( z ).floor_cache_dirty ) {
+            report_unloaded_floor_submaps( z );
         }
+    }
+
+    // Each level only writes its own caches (the floor cache only reads the submaps below),
+    // so the levels can be built concurrently
+    std::vector<char> floor_rebuilt( maxz - minz + 1, false );
+    const auto build_level = [&]( const int z ) {
+        build_outside_cache( z );
+        build_transparency_cache( z, sight_penalty );
+        floor_rebuilt[z - minz] = fill_floor_cache( z );
         diagonal_blocks fill = {false, false};
         std::uninitialized_fill_n( &( get_cache( z ).vehicle_obscured_cache[0][0] ), MAPSIZE_X * MAPSIZE_Y,
                                    fill );
         std::uninitialized_fill_n( &( get_cache( z ).vehicle_obstructed_cache[0][0] ),
                                    MAPSIZE_X * MAPSIZE_Y, fill );
+    };
+    const unsigned max_tasks = map_cache_task_count > 0 ? map_cache_task_count :
+                               std::max( 1u, std::thread::hardware_concurrency() );
+    const int task_count = std::min( max_tasks, static_cast<unsigned>( maxz - minz + 1 ) );
+    if( !parallel_map_cache || task_count <= 1 ) {
+        for( int z = minz; z <= maxz; z++ ) {
+            build_level( z );
+        }
+    } else {
+        // Interleave the levels, the ones high up in the sky are mostly uniform and cheap
+        const auto build_levels = [&]( const int first ) {
+            for( int z = first; z <= maxz; z += task_count ) {
+                build_level( z );
+            }
+        };
+        std::vector<std::future<void>> tasks;
+        for( int task = 1; task < task_count; task++ ) {
+            tasks.push_back( std::async( std::launch::async, build_levels, minz + task ) );
+        }
+        build_levels( minz );
+        for( std::future<void> &task : tasks ) {
+            task.get();
+        }
+    }
+
+    for( int z = minz; z <= maxz; z++ ) {
+        // trigger FOV recalculation only when there is a change on the player's level or if fov_3d is enabled
+        const bool affects_seen_cache =  z == zlev || fov_3d;
+        seen_cache_dirty |= ( floor_rebuilt[z - minz] && affects_seen_cache );
+        const bool level_seen_dirty = get_cache( z ).seen_cache_dirty;
+        seen_cache_dirty |= level_seen_dirty;
+        if( level_seen_dirty ) {
+            dirty_seen_cache_levels.push_back( z );
+        }
     }
     // needs a separate pass as it changes the caches on neighbour z-levels (e.g. floor_cache);
     // otherwise such changes might be overwritten by main cache-building logic
@@ -8827,7 +8942,8 @@ void map::build_map_cache( const int zlev, bool skip_lightmap )
     seen_cache_dirty |= build_vision_transparency_cache( get_player_character() );
 
     if( seen_cache_dirty ) {
-        skew_vision_cache.clear();
+        TracyPlot( "LOS cache hit rate", skew_vision_cache.current_stats().hit_rate() );
+        skew_vision_cache.invalidate();
     }
     // Initial value is illegal player position.
     const tripoint &p = g->u.pos();
@@ -9146,7 +9262,7 @@ void map::function_over( const tripoint &start, const tripoint &end, Functor fun
 }
 
 void map::scent_blockers( std::array<std::array<char, MAPSIZE_X>, MAPSIZE_Y> &scent_transfer,
-                          point min, point max )
+                          point min, point max, const int zlev )
 {
     auto reduce = TFLAG_REDUCE_SCENT;
     auto block = TFLAG_NO_SCENT;
@@ -9165,7 +9281,7 @@ void map::scent_blockers( std::array<std::array<char, MAPSIZE_X>, MAPSIZE_Y> &sc
         return ITER_CONTINUE;
     };
 
-    function_over( tripoint( min, abs_sub.z ), tripoint( max, abs_sub.z ), fill_values );
+    function_over( tripoint( min, zlev ), tripoint( max, zlev ), fill_values );
 
     const inclusive_rectangle<point> local_bounds( min, max );
 
@@ -9176,7 +9292,8 @@ void map::scent_blockers( std::array<std::array<char, MAPSIZE_X>, MAPSIZE_Y> &sc
         vehicle &veh = *( wrapped_veh.v );
         for( const vpart_reference &vp : veh.get_any_parts( VPFLAG_OBSTACLE ) ) {
             const tripoint part_pos = vp.pos();
-            if( local_bounds.contains( part_pos.xy() ) && scent_transfer[part_pos.x][part_pos.y] == 5 ) {
+            if( part_pos.z == zlev && local_bounds.contains( part_pos.xy() ) &&
+                scent_transfer[part_pos.x][part_pos.y] == 5 ) {
                 scent_transfer[part_pos.x][part_pos.y] = 1;
             }
         }
@@ -9188,13 +9305,39 @@ void map::scent_blockers( std::array<std::array<char, MAPSIZE_X>, MAPSIZE_Y> &sc
             }
 
             const tripoint part_pos = vp.pos();
-            if( local_bounds.contains( part_pos.xy() ) && scent_transfer[part_pos.x][part_pos.y] == 5 ) {
+            if( part_pos.z == zlev && local_bounds.contains( part_pos.xy() ) &&
+                scent_transfer[part_pos.x][part_pos.y] == 5 ) {
                 scent_transfer[part_pos.x][part_pos.y] = 1;
             }
         }
     }
 }
 
+void map::scent_openings( std::array<std::array<char, MAPSIZE_X>, MAPSIZE_Y> &scent_opening,
+                          point min, point max, const int zlev )
+{
+    if( !zlevels || zlev >= OVERMAP_HEIGHT ) {
+        for( auto &column : scent_opening ) {
+            column.fill( 0 );
+        }
+        return;
+    }
+
+    auto fill_values = [&]( const tripoint & gp, const submap * sm, point  lp ) {
+        const point p = lp + sm_to_ms_copy( gp.xy() );
+        const submap *sm_above = get_submap_at_grid( gp + tripoint_above );
+        const ter_t &ter = sm->get_ter( lp ).obj();
+        const ter_t &ter_above = sm_above->get_ter( lp ).obj();
+        scent_opening[p.x][p.y] = !ter.has_flag( TFLAG_LIQUID ) && !ter_above.has_flag( TFLAG_LIQUID ) &&
+                                  ( ter.has_flag( TFLAG_GOES_UP ) || ter_above.has_flag( TFLAG_GOES_DOWN ) ||
+                                    ter_above.has_flag( TFLAG_NO_FLOOR ) );
+
+        return ITER_CONTINUE;
+    };
+
+    function_over( tripoint( min, zlev ), tripoint( max, zlev ), fill_values );
+}
+
 tripoint_range<tripoint> map::points_in_rectangle( const tripoint &from, const tripoint &to ) const
 {
     const tripoint min( std::max( 0, std::min( from.x, to.x ) ), std::max( 0, std::min( from.y,
@@ -9382,17 +9525,25 @@ level_cache::level_cache()
     std::fill_n( &lm[0][0], map_dimensions, four_zeros );
     std::fill_n( &sm[0][0], map_dimensions, 0.0f );
     std::fill_n( &light_source_buffer[0][0], map_dimensions, 0.0f );
+    std::fill_n( &light_source_transparency[0][0], map_dimensions, 0.0f );
     std::fill_n( &outside_cache[0][0], map_dimensions, false );
     std::fill_n( &floor_cache[0][0], map_dimensions, false );
     std::fill_n( &transparency_cache[0][0], map_dimensions, 0.0f );
     diagonal_blocks fill = {false, false};
     std::fill_n( &vehicle_obscured_cache[0][0], map_dimensions, fill );
     std::fill_n( &vehicle_obstructed_cache[0][0], map_dimensions, fill );
+    std::fill_n( &light_source_obscured[0][0], map_dimensions, fill );
     std::fill_n( &seen_cache[0][0], map_dimensions, 0.0f );
     std::fill_n( &camera_cache[0][0], map_dimensions, 0.0f );
     std::fill_n( &visibility_cache[0][0], map_dimensions, lit_level::DARK );
     veh_in_active_range = false;
-    std::fill_n( &veh_exists_at[0][0], map_dimensions, false );
+    clear_veh_exists_at();
+}
+
+void level_cache::clear_veh_exists_at()
+{
+    std::fill_n( &veh_exists_at[0][0], MAPSIZE_X * MAPSIZE_Y, false );
+    veh_exists_count = 0;
 }
 
 pathfinding_cache::pathfinding_cache()
@@ -9409,8 +9560,23 @@ pathfinding_cache &map::get_pathfinding_cache( int zlev ) const
 
 void map::set_pathfinding_cache_dirty( const int zlev )
 {
+    layout_generation++;
     if( inbounds_z( zlev ) ) {
         get_pathfinding_cache( zlev ).dirty = true;
+        if( g != nullptr && this == &get_map() ) {
+            Pathfinding::mark_dirty_level( zlev );
+        }
+    }
+}
+
+void map::set_pathfinding_cache_dirty( const tripoint &p )
+{
+    layout_generation++;
+    if( inbounds_z( p.z ) ) {
+        get_pathfinding_cache( p.z ).dirty = true;
+        if( g != nullptr && this == &get_map() ) {
+            Pathfinding::mark_dirty_tile( p );
+        }
     }
 }
 
@@ -12,6 +12,7 @@
 #include <set>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -26,13 +27,14 @@
 #include "item_stack.h"
 #include "lightmap.h"
 #include "line.h"
-#include "lru_cache.h"
+#include "los_cache.h"
 #include "mapdata.h"
 #include "memory_fast.h"
 #include "point.h"
 #include "shadowcasting.h"
 #include "type_id.h"
 #include "units.h"
+#include "vehicle_move_queue.h"
 
 #include <variant>
 
@@ -296,6 +298,18 @@ struct diagonal_blocks {
     bool ne;
 };
 
+// Light cast by one bulk light source (see map::add_light_source) during the last
+// generate_lightmap, kept so that it can be reused while nothing it reached has changed.
+struct light_source_result {
+    float luminance = 0.0f;
+    // Which of the four cardinal directions rays were cast into
+    uint8_t directions = 0;
+    // Submaps (inclusive) whose transparency could have affected the result
+    point sm_min;
+    point sm_max;
+    std::vector<std::pair<point, four_quadrants>> lit;
+};
+
 struct level_cache {
     // Zeros all relevant values
     level_cache();
@@ -314,6 +328,14 @@ struct level_cache {
     // To prevent redundant ray casting into neighbors: precalculate bulk light source positions.
     // This is only valid for the duration of generate_lightmap
     float light_source_buffer[MAPSIZE_X][MAPSIZE_Y];
+    // Bulk light sources from the previous generate_lightmap, by position.
+    std::unordered_map<point, light_source_result> light_source_results;
+    // transparency_cache and vehicle_obscured_cache as they were when light_source_results
+    // were cast, to find the submaps that changed since.
+    float light_source_transparency[MAPSIZE_X][MAPSIZE_Y];
+    diagonal_blocks light_source_obscured[MAPSIZE_X][MAPSIZE_Y];
+    float light_source_weather_transparency = 0.0f;
+    bool light_source_trigdist = false;
 
     // if false, means tile is under the roof ("inside"), true means tile is "outside"
     // "inside" tiles are protected from sun, rain, etc. (see "INDOORS" flag)
@@ -351,10 +373,18 @@ struct level_cache {
 
     bool veh_in_active_range;
     bool veh_exists_at[MAPSIZE_X][MAPSIZE_Y];
+    // Number of set entries in veh_exists_at, only change it through set_veh_exists_at
+    int veh_exists_count;
     std::map< tripoint, std::pair<vehicle *, int> > veh_cached_parts;
     std::set<vehicle *> vehicle_list;
     std::set<vehicle *> zone_vehicles;
 
+    void set_veh_exists_at( point p, bool exists ) {
+        bool &cell = veh_exists_at[p.x][p.y];
+        veh_exists_count += static_cast<int>( exists ) - static_cast<int>( cell );
+        cell = exists;
+    }
+    void clear_veh_exists_at();
 };
 
 /**
@@ -425,8 +455,18 @@ class map
         void set_suspension_cache_dirty( const int zlev );
 
         void set_pathfinding_cache_dirty( int zlev );
+        // Same as above, but lets incremental pathfinding know exactly which tile changed
+        void set_pathfinding_cache_dirty( const tripoint &p );
         /*@}*/
 
+        /**
+         * Changes whenever a pathfinding cache is marked dirty, i.e. when terrain, furniture
+         * or vehicles change or submaps are loaded.
+         */
+        uint64_t get_layout_generation() const {
+            return layout_generation;
+        }
+
         void set_memory_seen_cache_dirty( const tripoint &p );
 
         void invalidate_map_cache( const int zlev );
@@ -518,6 +558,13 @@ class map
          * Note: the map must have been loaded before this can be called.
          */
         void shift( point s );
+        /**
+         * Starts reading the saved submaps that shifting the map along @p heading would
+         * load, up to @p distance submaps past the edge of the map, in the background.
+         * With z-levels, only the current level and the ones next to it are read ahead.
+         * See @ref world::prefetch_map_quads.
+         */
+        void prefetch_submaps( point heading, int distance ) const;
         /**
          * Moves the map vertically to (not by!) newz.
          * Does not actually shift anything, only forces cache updates.
@@ -617,6 +664,8 @@ class map
         // Sees:
         /**
         * Returns whether `F` sees `T` with a view range of `range`.
+        * Only reads the level caches and the line of sight memo, so it may run on several
+        * threads at once, as long as nothing changes the map meanwhile.
         */
         bool sees( const tripoint &F, const tripoint &T, int range ) const;
     private:
@@ -1557,11 +1606,17 @@ class map
 
         // Scent propagation helpers
         /**
-         * Build the map of scent-resistant tiles.
+         * Build the map of scent-resistant tiles on z-level @p zlev.
          * Should be way faster than if done in `game.cpp` using public map functions.
          */
         void scent_blockers( std::array<std::array<char, MAPSIZE_X>, MAPSIZE_Y> &scent_transfer,
-                             point min, point max );
+                             point min, point max, int zlev );
+        /**
+         * Build the map of tiles where scent passes between z-level @p zlev and the one above,
+         * that is stairs and open air. Scent doesn't pass into or out of liquids this way.
+         */
+        void scent_openings( std::array<std::array<char, MAPSIZE_X>, MAPSIZE_Y> &scent_opening,
+                             point min, point max, int zlev );
 
         // Computers
         computer *computer_at( const tripoint &p );
@@ -1849,7 +1904,16 @@ class map
 
         // Builds a transparency cache and returns true if the cache was invalidated.
         // Used to determine if seen cache should be rebuilt.
-        bool build_transparency_cache( int zlev );
+        // Call update_weather_transparency() first and pass on the sight penalty it returns.
+        bool build_transparency_cache( int zlev, float sight_penalty );
+        // Updates the shared lookup for weather-penalized open air used by the transparency caches,
+        // returns the current weather's sight penalty
+        float update_weather_transparency();
+        // Same as build_floor_cache, but skips submaps that aren't loaded without a word,
+        // so that it can run on worker threads
+        bool fill_floor_cache( int zlev );
+        // Reports the submaps build_floor_cache would need but aren't loaded
+        void report_unloaded_floor_submaps( int zlev ) const;
         bool build_vision_transparency_cache( const Character &player );
         // fills lm with sunlight. pzlev is current player's zlevel
         void build_sunlight_cache( int pzlev );
@@ -1974,6 +2038,9 @@ class map
         // ...this, which will apply the light after at the end of generate_lightmap, and prevent redundant
         // light rays from causing massive slowdowns, if there's a huge amount of light.
         void add_light_source( const tripoint &p, float luminance );
+        // Applies everything added by add_light_source, reusing the light of sources
+        // that are unchanged since the previous generate_lightmap.
+        void apply_buffered_light_sources( int zlev );
         // Handle just cardinal directions and 45 deg angles.
         void apply_directional_light( const tripoint &p, int direction, float luminance );
         void apply_light_arc( const tripoint &p, units::angle, float luminance,
@@ -2051,21 +2118,27 @@ class map
         std::array< std::unique_ptr<level_cache>, OVERMAP_LAYERS > caches;
 
         mutable std::array< std::unique_ptr<pathfinding_cache>, OVERMAP_LAYERS > pathfinding_caches;
+        uint64_t layout_generation = 0;
         /**
          * Set of submaps that contain active items in absolute coordinates.
          */
         std::set<tripoint> submaps_with_active_items;
 
         /**
-         * Cache of coordinate pairs recently checked for visibility.
+         * Cache of coordinate pairs checked for visibility since the seen caches were last dirty.
          */
-        mutable lru_cache<point, char> skew_vision_cache;
+        mutable los_cache skew_vision_cache;
 
         /**
          * Vehicle list doesn't change often, but is pretty expensive.
          */
         VehicleList last_full_vehicle_list;
         bool last_full_vehicle_list_dirty = true;
+        /**
+         * Vehicles left to move during @ref vehmove, empty outside of it.
+         */
+        vehicle_move_queue vehicle_moves;
+        void queue_vehicle_moves( const VehicleList &vehicle_list );
 
         // Note: no bounds check
         level_cache &get_cache( int zlev ) const {
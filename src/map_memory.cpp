@@ -1,5 +1,8 @@
 #include "map_memory.h"
 
+#include <deque>
+#include <unordered_map>
+
 #include "coordinate_conversions.h"
 #include "cuboid_rectangle.h"
 #include "debug.h"
@@ -10,7 +13,7 @@
 #include "translations.h"
 #include "map.h"
 #include "world.h"
-const memorized_terrain_tile mm_submap::default_tile { "", 0, 0 };
+const memorized_terrain_tile mm_submap::default_tile { memorized_tile_name(), 0, 0 };
 const int mm_submap::default_symbol = 0;
 
 #define MM_SIZE (MAPSIZE * 2)
@@ -30,6 +33,36 @@ struct reg_coord_pair {
     }
 };
 
+namespace
+{
+struct tile_name_table {
+    // A deque, so references to the names stay valid while it grows
+    std::deque<std::string> names = { std::string() };
+    std::unordered_map<std::string, uint32_t> indices = { { std::string(), 0 } };
+};
+
+tile_name_table &get_tile_names()
+{
+    static tile_name_table table;
+    return table;
+}
+} // namespace
+
+memorized_tile_name::memorized_tile_name( const std::string &name )
+{
+    tile_name_table &table = get_tile_names();
+    const auto [iter, inserted] = table.indices.emplace( name, table.names.size() );
+    if( inserted ) {
+        table.names.push_back( name );
+    }
+    index = iter->second;
+}
+
+const std::string &memorized_tile_name::str() const
+{
+    return get_tile_names().names[index];
+}
+
 mm_submap::mm_submap() = default;
 
 mm_region::mm_region() : submaps {{ nullptr }} {}
@@ -83,7 +116,8 @@ void map_memory::memorize_tile( const tripoint &pos, const std::string &ter,
 {
     coord_pair p( pos );
     mm_submap &sm = get_submap( p.sm );
-    sm.set_tile( p.loc, memorized_terrain_tile{ ter, subtile, rotation } );
+    sm.set_tile( p.loc, memorized_terrain_tile{ memorized_tile_name( ter ),
+                 static_cast<int16_t>( subtile ), static_cast<int16_t>( rotation ) } );
 }
 
 int map_memory::get_symbol( const tripoint &pos )
@@ -203,12 +237,14 @@ static void temp_remove_open_air( const shared_ptr_fast<mm_submap> &sm )
     if( sm->is_empty() ) {
         return;
     }
+    static const memorized_tile_name open_air( "t_open_air" );
+    static const memorized_tile_name open_air_rooved( "t_open_air_rooved" );
+    static const memorized_tile_name open_air_rooved_outside( "t_open_air_rooved_outside" );
     for( int x = 0; x < SEEX; x++ ) {
         for( int y = 0; y < SEEY; y++ ) {
             const memorized_terrain_tile &t = sm->tile( {x, y} );
 
-            if( !t.tile.empty() && ( t.tile == "t_open_air" || t.tile == "t_open_air_rooved" ||
-                                     t.tile == "t_open_air_rooved_outside" ) ) {
+            if( t.tile == open_air || t.tile == open_air_rooved || t.tile == open_air_rooved_outside ) {
                 sm->set_tile( {x, y}, mm_submap::default_tile );
             }
         }
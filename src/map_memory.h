@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "game_constants.h"
 #include "memory_fast.h"
@@ -10,10 +12,40 @@
 class JsonOut;
 class JsonIn;
 
+/**
+ * Name of a memorized tile, interned in a table shared by the whole process,
+ * so each memorized tile only stores an index. Index 0 is the empty name.
+ */
+class memorized_tile_name
+{
+    public:
+        memorized_tile_name() = default;
+        explicit memorized_tile_name( const std::string &name );
+
+        /** The name, the reference stays valid for the lifetime of the process. */
+        const std::string &str() const;
+        bool empty() const {
+            return index == 0;
+        }
+        uint32_t to_i() const {
+            return index;
+        }
+
+        bool operator==( const memorized_tile_name &rhs ) const {
+            return index == rhs.index;
+        }
+        bool operator!=( const memorized_tile_name &rhs ) const {
+            return index != rhs.index;
+        }
+
+    private:
+        uint32_t index = 0;
+};
+
 struct memorized_terrain_tile {
-    std::string tile;
-    int subtile;
-    int rotation;
+    memorized_tile_name tile;
+    int16_t subtile;
+    int16_t rotation;
 
     bool operator==( const memorized_terrain_tile &rhs ) const {
         return ( rotation == rhs.rotation ) && ( subtile == rhs.subtile ) && ( tile == rhs.tile );
@@ -24,6 +56,9 @@ struct memorized_terrain_tile {
     }
 };
 
+/** Tile names used by one saved mm_region, see mm_region::serialize. */
+struct mm_name_table;
+
 /** Represent a submap-sized chunk of tile memory. */
 struct mm_submap {
     public:
@@ -72,8 +107,12 @@ struct mm_submap {
             symbols[p.y * SEEX + p.x] = value;
         }
 
-        void serialize( JsonOut &jsout ) const;
-        void deserialize( JsonIn &jsin );
+        void serialize( JsonOut &jsout, mm_name_table &names ) const;
+        /**
+         * Reads tiles written by @ref serialize with the same name table, or,
+         * if @p names is null, by older versions that spelled out the tile names.
+         */
+        void deserialize( JsonIn &jsin, const mm_name_table *names );
 
     private:
         std::vector<memorized_terrain_tile> tiles; // holds either 0 or SEEX*SEEY elements
@@ -93,7 +132,12 @@ struct mm_region {
 
     bool is_empty() const;
 
+    /**
+     * Writes `{ "names": [...], "submaps": [...] }`, where each submap is a flat array of
+     * runs of (name index, subtile, rotation, symbol, length) and names are spelled out once.
+     */
     void serialize( JsonOut &jsout ) const;
+    /** Reads both the current format and the older array of per-tile strings. */
     void deserialize( JsonIn &jsin );
 };
 
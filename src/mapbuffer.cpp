@@ -1,9 +1,9 @@
 #include "mapbuffer.h"
 
 #include <algorithm>
+#include <array>
 #include <exception>
 #include <functional>
-#include <set>
 #include <sstream>
 #include <utility>
 #include <vector>
@@ -22,6 +22,7 @@
 #include "popup.h"
 #include "string_formatter.h"
 #include "submap.h"
+#include "submap_binary.h"
 #include "translations.h"
 #include "ui_manager.h"
 #include "world.h"
@@ -33,16 +34,19 @@ mapbuffer::~mapbuffer() = default;
 
 void mapbuffer::clear()
 {
-    submaps.clear();
+    quads.clear();
+    submap_count = 0;
 }
 
 bool mapbuffer::add_submap( const tripoint &p, std::unique_ptr<submap> &sm )
 {
-    if( submaps.contains( p ) ) {
+    std::unique_ptr<submap> &slot = quads[sm_to_omt_copy( p )][quad_slot( p )];
+    if( slot ) {
         return false;
     }
 
-    submaps[p] = std::move( sm );
+    slot = std::move( sm );
+    submap_count++;
 
     return true;
 }
@@ -61,18 +65,35 @@ bool mapbuffer::add_submap( const tripoint &p, submap *sm )
 
 void mapbuffer::remove_submap( tripoint addr )
 {
-    auto m_target = submaps.find( addr );
-    if( m_target == submaps.end() ) {
+    const auto quad = quads.find( sm_to_omt_copy( addr ) );
+    if( quad == quads.end() || !quad->second[quad_slot( addr )] ) {
         debugmsg( "Tried to remove non-existing submap %s", addr.to_string() );
         return;
     }
-    submaps.erase( m_target );
+    quad->second[quad_slot( addr )].reset();
+    submap_count--;
+    const bool quad_empty = std::ranges::none_of( quad->second,
+    []( const std::unique_ptr<submap> &sm ) {
+        return sm != nullptr;
+    } );
+    if( quad_empty ) {
+        quads.erase( quad );
+    }
+}
+
+submap *mapbuffer::find_submap( const tripoint &p ) const
+{
+    const auto quad = quads.find( sm_to_omt_copy( p ) );
+    if( quad == quads.end() ) {
+        return nullptr;
+    }
+    return quad->second[quad_slot( p )].get();
 }
 
 submap *mapbuffer::lookup_submap( const tripoint &p )
 {
-    const auto iter = submaps.find( p );
-    if( iter == submaps.end() ) {
+    submap *sm = find_submap( p );
+    if( sm == nullptr ) {
         try {
             return unserialize_submaps( p );
         } catch( const std::exception &err ) {
@@ -81,13 +102,13 @@ submap *mapbuffer::lookup_submap( const tripoint &p )
         return nullptr;
     }
 
-    return iter->second.get();
+    return sm;
 }
 
 void mapbuffer::save( bool delete_after_save )
 {
     int num_saved_submaps = 0;
-    int num_total_submaps = submaps.size();
+    int num_total_submaps = submap_count;
 
     map &here = get_map();
     const tripoint map_origin = sm_to_omt_copy( here.get_abs_sub() );
@@ -95,13 +116,18 @@ void mapbuffer::save( bool delete_after_save )
 
     static_popup popup;
 
-    // A set of already-saved submaps, in global overmap coordinates.
-    std::set<tripoint> saved_submaps;
+    // Save the quads in a stable order, so that saving the same map gives the same files
+    std::vector<tripoint> quads_to_save;
+    quads_to_save.reserve( quads.size() );
+    for( const auto &quad : quads ) {
+        quads_to_save.push_back( quad.first );
+    }
+    std::sort( quads_to_save.begin(), quads_to_save.end() );
     std::list<tripoint> submaps_to_delete;
     static constexpr std::chrono::milliseconds update_interval( 500 );
     auto last_update = std::chrono::steady_clock::now();
 
-    for( auto &elem : submaps ) {
+    for( const tripoint &om_addr : quads_to_save ) {
         auto now = std::chrono::steady_clock::now();
         if( last_update + update_interval < now ) {
             popup.message( _( "Please wait as the map saves [%d/%d]" ),
@@ -111,16 +137,9 @@ void mapbuffer::save( bool delete_after_save )
             inp_mngr.pump_events();
             last_update = now;
         }
-        // Whatever the coordinates of the current submap are,
-        // we're saving a 2x2 quad of submaps at a time.
+        // We're saving a 2x2 quad of submaps at a time.
         // Submaps are generated in quads, so we know if we have one member of a quad,
         // we have the rest of it, if that assumption is broken we have REAL problems.
-        const tripoint om_addr = sm_to_omt_copy( elem.first );
-        if( saved_submaps.contains( om_addr ) ) {
-            // Already handled this one.
-            continue;
-        }
-        saved_submaps.insert( om_addr );
 
         // A segment is a chunk of 32x32 submap quads.
         // We're breaking them into subdirectories so there aren't too many files per directory.
@@ -159,7 +178,7 @@ void mapbuffer::save_quad( const tripoint &om_addr, std::list<tripoint> &submaps
         submap_addr.x += offsets_offset.x;
         submap_addr.y += offsets_offset.y;
         submap_addrs.push_back( submap_addr );
-        submap *sm = submaps[submap_addr].get();
+        submap *sm = find_submap( submap_addr );
         if( sm != nullptr && !sm->is_uniform ) {
             all_uniform = false;
         }
@@ -169,7 +188,7 @@ void mapbuffer::save_quad( const tripoint &om_addr, std::list<tripoint> &submaps
         // Nothing to save - this quad will be regenerated faster than it would be re-read
         if( delete_after_save ) {
             for( auto &submap_addr : submap_addrs ) {
-                if( submaps.contains( submap_addr ) && submaps[submap_addr] != nullptr ) {
+                if( find_submap( submap_addr ) != nullptr ) {
                     submaps_to_delete.push_back( submap_addr );
                 }
             }
@@ -182,15 +201,30 @@ void mapbuffer::save_quad( const tripoint &om_addr, std::list<tripoint> &submaps
         return;
     }
 
-    g->get_active_world()->write_map_quad( om_addr, [&]( std::ostream & fout ) {
-        JsonOut jsout( fout );
-        jsout.start_array();
+    world *active_world = g->get_active_world();
+    if( active_world->supports_binary_map_quads() ) {
+        std::vector<std::pair<tripoint, const submap *>> quad;
         for( auto &submap_addr : submap_addrs ) {
-            if( !submaps.contains( submap_addr ) ) {
+            const submap *sm = find_submap( submap_addr );
+            if( sm == nullptr ) {
                 continue;
             }
+            quad.emplace_back( submap_addr, sm );
+            if( delete_after_save ) {
+                submaps_to_delete.push_back( submap_addr );
+            }
+        }
+        active_world->write_map_quad( om_addr, [&]( std::ostream & fout ) {
+            serialize_submap_quad( fout, quad );
+        }, true );
+        return;
+    }
 
-            submap *sm = submaps[submap_addr].get();
+    active_world->write_map_quad( om_addr, [&]( std::ostream & fout ) {
+        JsonOut jsout( fout );
+        jsout.start_array();
+        for( auto &submap_addr : submap_addrs ) {
+            submap *sm = find_submap( submap_addr );
 
             if( sm == nullptr ) {
                 continue;
@@ -229,16 +263,16 @@ submap *mapbuffer::unserialize_submaps( const tripoint &p )
 
     using namespace std::placeholders;
     if( !g->get_active_world()->read_map_quad( om_addr, std::bind( &mapbuffer::deserialize,
-            this, _1 ) ) ) {
+            this, _1 ), std::bind( &mapbuffer::deserialize_binary, this, _1 ) ) ) {
         // If it doesn't exist, trigger generating it.
         return nullptr;
     }
-    if( !submaps.contains( p ) ) {
+    submap *sm = find_submap( p );
+    if( sm == nullptr ) {
         debugmsg( "file did not contain the expected submap %d,%d,%d",
                   p.x, p.y, p.z );
-        return nullptr;
     }
-    return submaps[ p ].get();
+    return sm;
 }
 
 void mapbuffer::deserialize( JsonIn &jsin )
@@ -276,3 +310,65 @@ void mapbuffer::deserialize( JsonIn &jsin )
         }
     }
 }
+
+void mapbuffer::deserialize_binary( std::istream &fin )
+{
+    for( auto &[submap_coordinates, sm] : deserialize_submap_quad( fin ) ) {
+        if( !add_submap( submap_coordinates, sm ) ) {
+            debugmsg( "submap %d,%d,%d was already loaded", submap_coordinates.x, submap_coordinates.y,
+                      submap_coordinates.z );
+        }
+    }
+}
+
+int mapbuffer::convert_quads_to_binary()
+{
+    world *active_world = g->get_active_world();
+    if( !active_world->supports_binary_map_quads() ) {
+        return 0;
+    }
+
+    static_popup popup;
+    const std::vector<tripoint> quads = active_world->list_json_map_quads();
+    int num_converted = 0;
+    static constexpr std::chrono::milliseconds update_interval( 500 );
+    auto last_update = std::chrono::steady_clock::now();
+
+    active_world->start_save_tx();
+    for( const tripoint &om_addr : quads ) {
+        auto now = std::chrono::steady_clock::now();
+        if( last_update + update_interval < now ) {
+            popup.message( _( "Please wait as the map is converted [%d/%d]" ),
+                           num_converted, quads.size() );
+            ui_manager::redraw();
+            refresh_display();
+            inp_mngr.pump_events();
+            last_update = now;
+        }
+
+        // Loaded quads are written in the binary format the next time the game saves.
+        // Any one of the four submaps being loaded counts, converting the others would
+        // write the quad without it.
+        const tripoint sm_addr = omt_to_sm_copy( om_addr );
+        constexpr std::array<point, 4> quad_offsets = { point_zero, point_south, point_east, point_south_east };
+        if( std::ranges::any_of( quad_offsets, [&]( const point & offset ) {
+        return is_submap_loaded( sm_addr + offset );
+        } ) ) {
+            continue;
+        }
+        mapbuffer quad;
+        std::list<tripoint> unused;
+        try {
+            using namespace std::placeholders;
+            if( active_world->read_map_quad( om_addr, std::bind( &mapbuffer::deserialize, &quad, _1 ),
+                                             std::bind( &mapbuffer::deserialize_binary, &quad, _1 ) ) ) {
+                quad.save_quad( om_addr, unused, false );
+                num_converted++;
+            }
+        } catch( const std::exception &err ) {
+            debugmsg( "Failed to convert map quad %s: %s", om_addr.to_string(), err.what() );
+        }
+    }
+    active_world->commit_save_tx();
+    return num_converted;
+}
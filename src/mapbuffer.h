@@ -1,9 +1,12 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <iosfwd>
 #include <list>
-#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "coordinates.h"
 #include "point.h"
@@ -56,30 +59,44 @@ class mapbuffer
             return lookup_submap( p.raw() );
         }
 
-    private:
-        using submap_map_t = std::map<tripoint, std::unique_ptr<submap>>;
-
-    public:
-        submap_map_t::iterator begin() {
-            return submaps.begin();
-        }
-        submap_map_t::iterator end() {
-            return submaps.end();
+        bool is_submap_loaded( const tripoint &p ) const {
+            return find_submap( p ) != nullptr;
         }
 
-        bool is_submap_loaded( const tripoint &p ) const {
-            return submaps.contains( p );
+        /** Number of submaps currently in the buffer. */
+        size_t size() const {
+            return submap_count;
         }
 
+        /**
+         * Rewrites the saved map quads that are still stored as JSON in the binary format.
+         * Quads that are currently loaded are skipped, saving the game takes care of them.
+         * @return The number of converted quads.
+         */
+        int convert_quads_to_binary();
+
     private:
         // There's a very good reason this is private,
         // if not handled carefully, this can erase in-use submaps and crash the game.
         void remove_submap( tripoint addr );
+        submap *find_submap( const tripoint &p ) const;
         submap *unserialize_submaps( const tripoint &p );
         void deserialize( JsonIn &jsin );
+        void deserialize_binary( std::istream &fin );
         void save_quad( const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
                         bool delete_after_save );
-        submap_map_t submaps;
+
+        /**
+         * The submaps of one overmap terrain tile, which are saved and loaded together.
+         * Indexed by @ref quad_slot.
+         */
+        using submap_quad = std::array<std::unique_ptr<submap>, 4>;
+        static size_t quad_slot( const tripoint &p ) {
+            return ( p.x & 1 ) + ( p.y & 1 ) * 2;
+        }
+        /** Keyed by the position of the quads in overmap terrain coordinates. */
+        std::unordered_map<tripoint, submap_quad> quads;
+        size_t submap_count = 0;
 };
 
 extern mapbuffer MAPBUFFER;
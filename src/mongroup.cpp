@@ -6,6 +6,7 @@
 #include "assign.h"
 #include "calendar.h"
 #include "debug.h"
+#include "enum_conversions.h"
 #include "json.h"
 #include "mtype.h"
 #include "options.h"
@@ -27,6 +28,28 @@ MonsterGroupManager::t_string_set MonsterGroupManager::monster_categories_blackl
 MonsterGroupManager::t_string_set MonsterGroupManager::monster_categories_whitelist;
 bool monster_whitelist_is_exclusive = false;
 
+namespace io
+{
+
+template<>
+std::string enum_to_string<horde_behaviour>( horde_behaviour data )
+{
+    switch( data ) {
+        // *INDENT-OFF*
+        case horde_behaviour::none: return "";
+        case horde_behaviour::city: return "city";
+        case horde_behaviour::roam: return "roam";
+        case horde_behaviour::nemesis: return "nemesis";
+        // *INDENT-ON*
+        case horde_behaviour::last:
+            break;
+    }
+    debugmsg( "Invalid horde_behaviour" );
+    abort();
+}
+
+} // namespace io
+
 /** @relates string_id */
 template<>
 bool string_id<MonsterGroup>::is_valid() const
@@ -7,6 +7,7 @@
 
 #include "calendar.h"
 #include "coordinates.h"
+#include "enum_traits.h"
 #include "io_tags.h"
 #include "monster.h"
 #include "point.h"
@@ -76,6 +77,24 @@ struct MonsterGroup {
     LUA_TYPE_OPS( MonsterGroup, name );
 };
 
+/** How a horde picks its next target when it loses interest, see @ref mongroup::wander. */
+enum class horde_behaviour : int {
+    // Not chosen yet, picked at random when the horde first moves
+    none,
+    // Sticks around cities and returns to them whenever possible
+    city,
+    // Roams around the map randomly
+    roam,
+    // Follows the player, moved by overmap::move_nemesis instead
+    nemesis,
+    last
+};
+
+template<>
+struct enum_traits<horde_behaviour> {
+    static constexpr horde_behaviour last = horde_behaviour::last;
+};
+
 struct mongroup {
     mongroup_id type;
     // Note: position is not saved as such in the json
@@ -96,12 +115,7 @@ struct mongroup {
      */
     std::vector<monster> monsters;
 
-    /** There are two types of hordes: "city", who try to stick around cities
-     *  and return to them whenever possible.
-     *  And "roam", who roam around the map randomly, not taking care to return
-     *  anywhere.
-     */
-    std::string horde_behaviour;
+    horde_behaviour behaviour = horde_behaviour::none;
     bool diffuse = false;   // group size ind. of dist. from center and radius invariant
     mongroup( const mongroup_id &ptype, const tripoint &ppos,
               unsigned int prad, unsigned int ppop )
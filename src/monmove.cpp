@@ -15,6 +15,7 @@
 #include "avatar.h"
 #include "behavior.h"
 #include "bionics.h"
+#include "cached_options.h"
 #include "cata_utility.h"
 #include "creature_tracker.h"
 #include "debug.h"
@@ -54,6 +55,7 @@
 #include "vpart_position.h"
 #include "profile.h"
 
+static const efftype_id effect_ai_controlled( "ai_controlled" );
 static const efftype_id effect_ai_waiting( "ai_waiting" );
 static const efftype_id effect_bouldering( "bouldering" );
 static const efftype_id effect_countdown( "countdown" );
@@ -300,6 +302,54 @@ void monster::wander_to( const tripoint &p, int f )
     wandf = f;
 }
 
+// Calls @p func for every monster that is a member of a faction hostile to @p mon, in the
+// order of the creature tracker's faction lists. plan() breaks ties between equally rated
+// targets with random draws, so the order matters.
+// Unless @p mon prioritizes targets, monsters beyond @p range are skipped without being looked at,
+// as rate_target() would reject them anyway.
+template<typename Func>
+static void for_each_hostile_monster( const monster &mon, const int range, Func func )
+{
+    const auto &factions = g->critter_tracker->factions();
+    if( !mon.has_flag( MF_PRIORITIZE_TARGETS ) ) {
+        const mfaction_id faction_player = mfaction_str_id( "player" ).id();
+        std::vector<std::pair<std::ptrdiff_t, monster *>> hostiles;
+        for( monster *other : g->critter_tracker->find_in_radius( mon.pos(), range,
+                fov_3d ? range : 0 ) ) {
+            // Same faction the creature tracker would file it under
+            const mfaction_id other_faction = other->friendly == 0 ? other->faction : faction_player;
+            const auto faction_att = mon.faction.obj().attitude( other_faction );
+            if( faction_att != MFA_NEUTRAL && faction_att != MFA_FRIENDLY ) {
+                hostiles.emplace_back( std::distance( factions.begin(), factions.find( other_faction ) ),
+                                       other );
+            }
+        }
+        // Faction lists are sets ordered by address
+        std::ranges::sort( hostiles, []( const auto & lhs, const auto & rhs ) {
+            return lhs.first != rhs.first ? lhs.first < rhs.first :
+                   std::less<const monster *>()( lhs.second, rhs.second );
+        } );
+        for( const auto &hostile : hostiles ) {
+            func( *hostile.second );
+        }
+        return;
+    }
+
+    for( const auto &fac : factions ) {
+        const auto faction_att = mon.faction.obj().attitude( fac.first );
+        if( faction_att == MFA_NEUTRAL || faction_att == MFA_FRIENDLY ) {
+            continue;
+        }
+
+        for( const weak_ptr_fast<monster> &weak : fac.second ) {
+            const shared_ptr_fast<monster> shared = weak.lock();
+            if( shared ) {
+                func( *shared );
+            }
+        }
+    }
+}
+
 float monster::rate_target( Creature &c, float best, bool smart ) const
 {
     const auto d = rl_dist_fast( pos(), c.pos() );
@@ -334,6 +384,60 @@ float monster::rate_target( Creature &c, float best, bool smart ) const
     return FLT_MAX;
 }
 
+void monster::add_target_sight_lines( const std::vector<monster *> &monsters,
+                                      const std::vector<npc *> &npcs,
+                                      std::vector<std::pair<tripoint, tripoint>> &lines ) const
+{
+    if( has_effect( effect_ai_waiting ) || has_effect( effect_ai_controlled ) ) {
+        return;
+    }
+
+    const bool smart_planning = has_flag( MF_PRIORITIZE_TARGETS );
+    const int max_sight_range = std::max( type->vision_day, type->vision_night );
+    const auto add = [&]( const Creature & c ) {
+        const auto d = rl_dist_fast( pos(), c.pos() );
+        // Same cutoff rate_target() starts with, these are never looked at
+        if( d <= 0 || ( !smart_planning && d >= max_sight_range ) ||
+            ( !fov_3d && posz() != c.posz() ) ) {
+            return;
+        }
+        lines.emplace_back( pos(), c.pos() );
+    };
+
+    // Mirrors the candidates considered by plan(). Monsters see the player through the
+    // player's seen cache instead, so the player isn't listed.
+    if( friendly != 0 && !has_effect( effect_docile ) ) {
+        for( const monster *tmp : monsters ) {
+            if( tmp->friendly == 0 ) {
+                add( *tmp );
+            }
+        }
+    }
+
+    for( const npc *who : npcs ) {
+        const auto faction_att = faction.obj().attitude( who->get_monster_faction() );
+        if( faction_att != MFA_NEUTRAL && faction_att != MFA_FRIENDLY ) {
+            add( *who );
+        }
+    }
+
+    if( friendly == 0 ) {
+        for_each_hostile_monster( *this, max_sight_range, add );
+    }
+    if( ( has_flag( MF_GROUP_MORALE ) && morale < type->morale ) || has_flag( MF_SWARMS ) ) {
+        const auto &factions = g->critter_tracker->factions();
+        const auto myfaction_iter = factions.find( friendly == 0 ? faction :
+                                    mfaction_str_id( "player" ).id() );
+        if( myfaction_iter != factions.end() ) {
+            for( const weak_ptr_fast<monster> &weak : myfaction_iter->second ) {
+                if( const shared_ptr_fast<monster> shared = weak.lock() ) {
+                    add( *shared );
+                }
+            }
+        }
+    }
+}
+
 void monster::plan()
 {
     ZoneScoped;
@@ -491,40 +595,28 @@ void monster::plan()
 
     fleeing = fleeing || ( mood == MATT_FLEE );
     if( friendly == 0 ) {
-        for( const auto &fac : factions ) {
-            auto faction_att = faction.obj().attitude( fac.first );
-            if( faction_att == MFA_NEUTRAL || faction_att == MFA_FRIENDLY ) {
-                continue;
-            }
-
-            for( const weak_ptr_fast<monster> &weak : fac.second ) {
-                const shared_ptr_fast<monster> shared = weak.lock();
-                if( !shared ) {
-                    continue;
-                }
-                monster &mon = *shared;
-                float rating = rate_target( mon, dist, smart_planning );
-                if( rating == dist ) {
-                    ++valid_targets;
-                    if( one_in( valid_targets ) ) {
-                        target = &mon;
-                    }
-                }
-                if( rating < dist ) {
+        for_each_hostile_monster( *this, max_sight_range, [&]( monster & mon ) {
+            float rating = rate_target( mon, dist, smart_planning );
+            if( rating == dist ) {
+                ++valid_targets;
+                if( one_in( valid_targets ) ) {
                     target = &mon;
-                    dist = rating;
-                    valid_targets = 1;
                 }
-                if( rating <= 5 ) {
-                    if( has_flag( MF_FACTION_MEMORY ) ) {
-                        add_faction_anger( mon.faction, angers_hostile_near );
-                    } else {
-                        anger += angers_hostile_near;
-                    }
-                    morale -= fears_hostile_near;
+            }
+            if( rating < dist ) {
+                target = &mon;
+                dist = rating;
+                valid_targets = 1;
+            }
+            if( rating <= 5 ) {
+                if( has_flag( MF_FACTION_MEMORY ) ) {
+                    add_faction_anger( mon.faction, angers_hostile_near );
+                } else {
+                    anger += angers_hostile_near;
                 }
+                morale -= fears_hostile_near;
             }
-        }
+        } );
     }
 
     // Friendly monsters here
@@ -1328,11 +1420,6 @@ void monster::footsteps( const tripoint &p )
 
 tripoint monster::scent_move()
 {
-    // TODO: Remove when scentmap is 3D
-    if( std::abs( posz() - g->get_levz() ) > SCENT_MAP_Z_REACH ) {
-        return { -1, -1, INT_MIN };
-    }
-
     const std::set<scenttype_id> &tracked_scents = type->scents_tracked;
     const std::set<scenttype_id> &ignored_scents = type->scents_ignored;
 
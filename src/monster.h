@@ -38,6 +38,7 @@ class JsonObject;
 class JsonOut;
 class effect;
 class item;
+class npc;
 class player;
 struct dealt_projectile_attack;
 struct pathfinding_settings;
@@ -233,6 +234,12 @@ class monster : public Creature, public location_visitable<monster>
 
         // How good of a target is given creature (checks for visibility)
         float rate_target( Creature &c, float best, bool smart = false ) const;
+        /**
+         * Adds the pairs of squares plan() is going to check line of sight between to @p lines,
+         * so that game::monmove can run map::sees for them ahead of time.
+         */
+        void add_target_sight_lines( const std::vector<monster *> &monsters, const std::vector<npc *> &npcs,
+                                     std::vector<std::pair<tripoint, tripoint>> &lines ) const;
         void plan();
         void move(); // Actual movement
         void footsteps( const tripoint &p ); // noise made by movement
@@ -1081,6 +1081,9 @@ void mtype::setup_pathfinding_deferred()
     this->route_settings.max_f_coeff = get_option<float>( "PATHFINDING_MAX_F_COEFF_DEFAULT" );
     this->route_settings.f_limit_based_on_max_dist =
         get_option<bool>( "PATHFINDING_MAX_F_LIMIT_BASED_ON_MAX_DIST" );
+    const float hierarchical_min_dist = get_option<float>( "PATHFINDING_HIERARCHICAL_MIN_DIST_DEFAULT" );
+    this->route_settings.hierarchical_min_dist = hierarchical_min_dist < 0.0 ? INFINITY :
+            hierarchical_min_dist;
 
     const bool default_override = get_option<bool>( "PATHFINDING_DEFAULT_IS_OVERRIDE" );
     const float range_mult = get_option<float>( "PATHFINDING_RANGE_MULT" );
@@ -3174,6 +3174,8 @@ std::pair<PathfindingSettings, RouteSettings> npc::get_pathfinding_pair(
     route_settings.f_limit_based_on_max_dist = false;
     route_settings.search_cone_angle = 180.0;
     route_settings.search_radius_coeff = INFINITY;
+    // Followers walk across the whole reality bubble, route them over submap portals
+    route_settings.hierarchical_min_dist = 2 * SEEX;
 
     return { path_settings, route_settings };
 }
@@ -1448,6 +1448,28 @@ void options_manager::add_options_general()
 
     get_option( "AUTOSAVE_MINUTES" ).setPrerequisite( "AUTOSAVE" );
 
+    add( "SAVE_SYNCHRONOUS", general, translate_marker( "Save durability" ),
+    translate_marker( "How often saving waits for data to reach the disk.  Lower settings make saves faster, but a power loss or system crash may lose the most recent saves.  Takes effect when a world is loaded." ), {
+        { "OFF", to_translation( "Off" ) },
+        { "NORMAL", to_translation( "Normal" ) },
+        { "FULL", to_translation( "Full" ) }
+    }, "NORMAL" );
+
+    add( "ASYNC_SAVE", general, translate_marker( "Save in background" ),
+         translate_marker( "If true, compressing and writing the save to disk happens in the background, so the game can continue while it finishes." ),
+         false
+       );
+
+    add( "BINARY_MAP_SAVES", general, translate_marker( "Binary map saves" ),
+         translate_marker( "If true, saved map areas are stored in a compact binary format that is faster to save and load.  Maps saved as JSON can still be loaded.  Only applies to worlds using the SQLite save format.  Older versions of the game can't load maps saved this way." ),
+         false
+       );
+
+    add( "PREFETCH_MAPS", general, translate_marker( "Prefetch map areas" ),
+         translate_marker( "If true, saved map areas ahead of the player are read in the background, so crossing into them doesn't wait for the disk.  Only applies to worlds using the SQLite save format." ),
+         true
+       );
+
     add_empty_line();
 
     add( "AUTO_NOTES", general, translate_marker( "Auto notes" ),
@@ -2371,6 +2393,11 @@ void options_manager::add_options_debug()
 
     get_option( "FOV_3D_Z_RANGE" ).setPrerequisite( "FOV_3D" );
 
+    add( "PARALLEL_MAP_CACHE", debug, translate_marker( "Parallel map cache rebuild" ),
+         translate_marker( "If true, the map caches of different z-levels are rebuilt on separate threads." ),
+         true
+       );
+
     add( "ENABLE_EVENTS", debug, translate_marker( "Event bus system" ),
          translate_marker( "If false, achievements and some Magiclysm functionality won't work, but performance will be better." ),
          true
@@ -2435,6 +2462,12 @@ void options_manager::add_options_world_default()
     }, "reset"
        );
 
+    add( "SAVE_COMPRESSION", world_default, translate_marker( "Save compression" ),
+    translate_marker( "How save data of worlds using the SQLite save format is compressed.  Zstandard trains a dictionary on the world's own saves, making them smaller and faster to load, but needs a build with zstd support to load them." ), {
+        { "zlib", translate_marker( "zlib" ) }, { "zstd", translate_marker( "Zstandard" ) }
+    }, "zlib"
+       );
+
     add_empty_line();
 
     add( "CITY_SIZE", world_default, translate_marker( "Size of cities" ),
@@ -3832,6 +3865,7 @@ void options_manager::cache_to_globals()
     message_cooldown = ::get_option<int>( "MESSAGE_COOLDOWN" );
     fov_3d = ::get_option<bool>( "FOV_3D" );
     fov_3d_z_range = ::get_option<int>( "FOV_3D_Z_RANGE" );
+    parallel_map_cache = ::get_option<bool>( "PARALLEL_MAP_CACHE" );
     static_z_effect = ::get_option<bool>( "STATICZEFFECT" );
     overmap_transparency = ::get_option<bool>( "OVERMAP_TRANSPARENCY" );
     PICKUP_RANGE = ::get_option<int>( "PICKUP_RANGE" );
@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <climits>
 #include <cmath>
 #include <coordinates.h>
 #include <cstddef>
@@ -3586,7 +3587,7 @@ void mongroup::wander( const overmap &om )
     const city *target_city = nullptr;
     int target_distance = 0;
 
-    if( horde_behaviour == "city" ) {
+    if( behaviour == horde_behaviour::city ) {
         // Find a nearby city to return to..
         for( const city &check_city : om.cities ) {
             // Check if this is the nearest city so far.
@@ -3620,14 +3621,14 @@ void overmap::move_hordes()
     //MOVE ZOMBIE GROUPS
     for( auto it = zg.begin(); it != zg.end(); ) {
         mongroup &mg = it->second;
-        if( !mg.horde || mg.horde_behaviour == "nemesis" ) {
+        if( !mg.horde || mg.behaviour == horde_behaviour::nemesis ) {
             // Nemesis hordes have their own move logic.
             ++it;
             continue;
         }
 
-        if( mg.horde_behaviour.empty() ) {
-            mg.horde_behaviour = one_in( 2 ) ? "city" : "roam";
+        if( mg.behaviour == horde_behaviour::none ) {
+            mg.behaviour = one_in( 2 ) ? horde_behaviour::city : horde_behaviour::roam;
         }
 
         // Gradually decrease interest.
@@ -3671,15 +3672,16 @@ void overmap::move_hordes()
                 mg.pos.y()++;
             }
 
-            // Erase the group at it's old location, add the group with the new location
-            tmpzg.insert( std::pair<tripoint_om_sm, mongroup>( mg.pos, mg ) );
-            zg.erase( it++ );
+            // Move the group's node to its new location, the group itself isn't copied
+            auto node = zg.extract( it++ );
+            node.key() = mg.pos;
+            tmpzg.insert( std::move( node ) );
         } else {
             ++it;
         }
     }
     // and now back into the monster group map.
-    zg.insert( tmpzg.begin(), tmpzg.end() );
+    zg.merge( tmpzg );
 
     if( get_option<bool>( "WANDER_SPAWNS" ) ) {
 
@@ -3758,7 +3760,7 @@ void overmap::move_nemesis()
     decltype( zg ) tmpzg;
     for( std::multimap<tripoint_om_sm, mongroup>::iterator it = zg.begin(); it != zg.end(); ) {
         mongroup &mg = it->second;
-        if( !mg.horde || mg.horde_behaviour != "nemesis" ) {
+        if( !mg.horde || mg.behaviour != horde_behaviour::nemesis ) {
             ++it;
             continue;
         }
@@ -3796,9 +3798,10 @@ void overmap::move_nemesis()
                 mg.pos.y() = local_sm.y();
                 mg.pos.x() = local_sm.x();
 
-                // Erase the group at its old location, add the group with the new location
-                tmpzg.insert( std::pair<tripoint_om_sm, mongroup>( mg.pos, mg ) );
-                zg.erase( it++ );
+                // Move the group's node to its new location
+                auto node = zg.extract( it++ );
+                node.key() = mg.pos;
+                tmpzg.insert( std::move( node ) );
                 break;
             }
         } else {
@@ -3807,14 +3810,14 @@ void overmap::move_nemesis()
         break;
     }
     // and now back into the monster group map.
-    zg.insert( tmpzg.begin(), tmpzg.end() );
+    zg.merge( tmpzg );
 }
 
 bool overmap::remove_nemesis()
 {
     for( std::multimap<tripoint_om_sm, mongroup>::iterator it = zg.begin(); it != zg.end(); ) {
         mongroup &mg = it->second;
-        if( mg.horde_behaviour == "nemesis" ) {
+        if( mg.behaviour == horde_behaviour::nemesis ) {
             zg.erase( it++ );
             return true;
         }
@@ -3830,12 +3833,16 @@ bool overmap::remove_nemesis()
 void overmap::signal_hordes( const tripoint_rel_sm &p_rel, const int sig_power )
 {
     tripoint_om_sm p( p_rel.raw() );
-    for( auto &elem : zg ) {
-        mongroup &mg = elem.second;
+    // Groups are ordered by x first and no distance is shorter than the x difference,
+    // so only the groups in this slice of the overmap can hear the signal.
+    const auto first = zg.lower_bound( tripoint_om_sm( p.x() - sig_power, INT_MIN, INT_MIN ) );
+    const auto last = zg.upper_bound( tripoint_om_sm( p.x() + sig_power, INT_MAX, INT_MAX ) );
+    for( auto it = first; it != last; ++it ) {
+        mongroup &mg = it->second;
         if( !mg.horde ) {
             continue;
         }
-        if( mg.horde_behaviour == "nemesis" ) {
+        if( mg.behaviour == horde_behaviour::nemesis ) {
             // Nemesis hordes are signaled to the player by their own function.
             continue;
         }
@@ -3879,7 +3886,7 @@ void overmap::signal_nemesis( const tripoint_abs_sm p_abs_sm )
     for( std::pair<const tripoint_om_sm, mongroup> &elem : zg ) {
         mongroup &mg = elem.second;
 
-        if( mg.horde_behaviour == "nemesis" ) {
+        if( mg.behaviour == horde_behaviour::nemesis ) {
             // If the horde is a nemesis, we set its target directly on the player.
             mg.set_target( pos_om );
             mg.set_nemesis_target( p_abs_sm );
@@ -6237,7 +6244,7 @@ void overmap::place_nemesis( const tripoint_abs_omt p )
 
     mongroup nemesis( GROUP_NEMESIS, local_sm, 1, 1 );
     nemesis.horde = true;
-    nemesis.horde_behaviour = "nemesis";
+    nemesis.behaviour = horde_behaviour::nemesis;
     nemesis.abs_pos = pos_sm;
     add_mon_group( nemesis );
 }
@@ -191,7 +191,7 @@ void overmapbuffer::fix_nemesis( overmap &new_overmap )
     for( auto it = new_overmap.zg.begin(); it != new_overmap.zg.end(); ) {
         mongroup &mg = it->second;
 
-        if( mg.horde_behaviour != "nemesis" ) {
+        if( mg.behaviour != horde_behaviour::nemesis ) {
             ++it;
             continue;
         }
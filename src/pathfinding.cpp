@@ -9,6 +9,7 @@
 #include "game.h"
 #include "map.h"
 #include "map_iterator.h"
+#include "options.h"
 #include "point.h"
 #include "submap.h"
 #include "trap.h"
@@ -17,6 +18,13 @@
 #include "vehicle_part.h"
 #include "vpart_position.h"
 
+static constexpr std::array<point, 4> ORTHOGONAL_DIRS_2D = {
+    point_east,
+    point_north,
+    point_west,
+    point_south,
+};
+
 static constexpr std::array<point, 8> DIRS_2D = {
     point_north_east,
     point_north_west,
@@ -30,10 +38,17 @@ static constexpr std::array<point, 8> DIRS_2D = {
 
 decltype( Pathfinding::d_maps_store ) Pathfinding::d_maps_store = {};
 decltype( Pathfinding::d_maps ) Pathfinding::d_maps = {};
+decltype( Pathfinding::d_maps_origin ) Pathfinding::d_maps_origin = {};
+decltype( Pathfinding::dirty_tiles ) Pathfinding::dirty_tiles = {};
+decltype( Pathfinding::dirty_levels ) Pathfinding::dirty_levels = {};
 decltype( Pathfinding::z_area ) Pathfinding::z_area = {};
 decltype( Pathfinding::z_caches ) Pathfinding::z_caches = {};
 decltype( Pathfinding::z_caches_open_air ) Pathfinding::z_caches_open_air = {};
 decltype( Pathfinding::cached_closest_z_changes ) Pathfinding::cached_closest_z_changes = {};
+decltype( Pathfinding::portal_graphs ) Pathfinding::portal_graphs = {};
+
+// Past this many changed tiles on a z-level per turn, repairing d_maps stops being cheaper than rebuilding them
+static constexpr size_t MAX_DIRTY_TILES_PER_LEVEL = 1024;
 
 // Thanks for nothing, MVSC
 // For our MVSC builds, std::is_nan and std::is_inf are not constexpr
@@ -174,6 +189,10 @@ float &Pathfinding::g_at( const point &p )
 {
     return this->g_map[p.y][p.x];
 };
+uint8_t &Pathfinding::parent_at( const point &p )
+{
+    return this->parent_map[p.y][p.x];
+}
 float Pathfinding::get_f_unbiased( const point &p )
 {
     return this->p_at( p ) + this->g_at( p );
@@ -202,52 +221,284 @@ void Pathfinding::produce_d_map( point dest, int z, PathfindingSettings settings
     d_map->dest = dest;
     d_map->z = z;
     d_map->settings = settings;
+    d_map->is_used = true;
 
     Pathfinding::d_maps.push_back( std::move( d_map ) );
 }
+void Pathfinding::recycle_d_map( std::unique_ptr<Pathfinding> &&d_map )
+{
+    d_map->reset_maps();
+    d_map->reset_tile_state();
+    d_map->unbiased_frontier.clear();
+    d_map->forbidden_moves.clear();
+    d_map->domain = Pathfinding::MapDomain::RELATIVE_DOMAIN;
+    d_map->is_explored = false;
+    Pathfinding::d_maps_store.push_back( std::move( d_map ) );
+}
 void Pathfinding::clear_d_maps()
 {
     for( auto &map : Pathfinding::d_maps ) {
-        map->reset_maps();
-        map->reset_tile_state();
-        map->unbiased_frontier.clear();
-        map->forbidden_moves.clear();
-        map->domain = Pathfinding::MapDomain::RELATIVE_DOMAIN;
-        map->is_explored = false;
-        Pathfinding::d_maps_store.push_back( std::move( map ) );
+        Pathfinding::recycle_d_map( std::move( map ) );
     }
     Pathfinding::d_maps.clear();
     Pathfinding::cached_closest_z_changes.clear();
+
+    for( std::vector<point> &tiles : Pathfinding::dirty_tiles ) {
+        tiles.clear();
+    }
+    Pathfinding::dirty_levels.reset();
 }
-void Pathfinding::reset_maps()
+void Pathfinding::end_turn()
 {
-    this->p_at( this->dest ) = 0.0;
-    this->g_at( this->dest ) = 0.0;
+    const tripoint cur_origin = get_map().get_abs_sub();
+    if( cur_origin != Pathfinding::d_maps_origin ) {
+        Pathfinding::clear_d_maps();
+        Pathfinding::portal_graphs.clear();
+        Pathfinding::d_maps_origin = cur_origin;
+        return;
+    }
 
-    for( const point &p : this->map_modify_set ) {
-        this->p_at( p ) = 0.0;
-        this->g_at( p ) = 0.0;
+    // Portal graphs are always kept up to date, only drop ones nobody needs anymore
+    std::erase_if( Pathfinding::portal_graphs, []( const auto & graph ) {
+        return !graph->is_used;
+    } );
+    for( auto &graph : Pathfinding::portal_graphs ) {
+        graph->is_used = false;
+    }
+
+    if( !get_option<bool>( "PATHFINDING_INCREMENTAL" ) ) {
+        Pathfinding::clear_d_maps();
+        return;
+    }
+
+    std::vector<std::unique_ptr<Pathfinding>> kept_d_maps;
+    for( auto &map : Pathfinding::d_maps ) {
+        const int z_index = map->z + OVERMAP_DEPTH;
+        const bool can_keep = map->is_reusable() &&
+                              !Pathfinding::dirty_levels[z_index] &&
+                              map->repair( Pathfinding::dirty_tiles[z_index] );
+        if( can_keep ) {
+            map->is_used = false;
+            kept_d_maps.push_back( std::move( map ) );
+        } else {
+            Pathfinding::recycle_d_map( std::move( map ) );
+        }
+    }
+    Pathfinding::d_maps = std::move( kept_d_maps );
+    Pathfinding::cached_closest_z_changes.clear();
+
+    for( std::vector<point> &tiles : Pathfinding::dirty_tiles ) {
+        tiles.clear();
+    }
+    Pathfinding::dirty_levels.reset();
+}
+void Pathfinding::mark_dirty_tile( const tripoint &p )
+{
+    if( p.z < -OVERMAP_DEPTH || p.z > OVERMAP_HEIGHT ) {
+        return;
+    }
+
+    if( p.x >= 0 && p.y >= 0 && p.x < MAPSIZE_X && p.y < MAPSIZE_Y ) {
+        const point sm( p.x / SEEX, p.y / SEEY );
+        const point in_sm( p.x % SEEX, p.y % SEEY );
+        for( auto &graph : Pathfinding::portal_graphs ) {
+            if( graph->z != p.z ) {
+                continue;
+            }
+            graph->dirty.set( sm.x + sm.y * MAPSIZE );
+            // Portals on the other side of a submap border depend on this tile too
+            if( in_sm.x == 0 && sm.x > 0 ) {
+                graph->dirty.set( sm.x - 1 + sm.y * MAPSIZE );
+            } else if( in_sm.x == SEEX - 1 && sm.x < MAPSIZE - 1 ) {
+                graph->dirty.set( sm.x + 1 + sm.y * MAPSIZE );
+            }
+            if( in_sm.y == 0 && sm.y > 0 ) {
+                graph->dirty.set( sm.x + ( sm.y - 1 ) * MAPSIZE );
+            } else if( in_sm.y == SEEY - 1 && sm.y < MAPSIZE - 1 ) {
+                graph->dirty.set( sm.x + ( sm.y + 1 ) * MAPSIZE );
+            }
+        }
+    }
+
+    const int z_index = p.z + OVERMAP_DEPTH;
+    if( Pathfinding::dirty_levels[z_index] ) {
+        return;
+    }
+
+    std::vector<point> &tiles = Pathfinding::dirty_tiles[z_index];
+    if( tiles.size() >= MAX_DIRTY_TILES_PER_LEVEL ) {
+        Pathfinding::mark_dirty_level( p.z );
+        return;
+    }
+    tiles.push_back( p.xy() );
+}
+void Pathfinding::mark_dirty_level( const int z )
+{
+    if( z < -OVERMAP_DEPTH || z > OVERMAP_HEIGHT ) {
+        return;
+    }
+
+    const int z_index = z + OVERMAP_DEPTH;
+    Pathfinding::dirty_levels.set( z_index );
+    Pathfinding::dirty_tiles[z_index].clear();
+
+    for( auto &graph : Pathfinding::portal_graphs ) {
+        if( graph->z == z ) {
+            graph->dirty.set();
+        }
     }
-    this->map_modify_set.clear();
 }
-void Pathfinding::reset_tile_state()
+bool Pathfinding::is_reusable() const
+{
+    // Mob positions change every turn and are not tracked as dirty tiles
+    const bool care_about_mobs = this->settings.mob_presence_penalty > 0;
+    return this->is_used && !care_about_mobs;
+}
+bool Pathfinding::repair( const std::vector<point> &dirty )
 {
-    this->tile_state_at( this->dest ) = State::UNVISITED;
+    using Frontier = std::priority_queue<val_pair, std::vector<val_pair>, pair_greater_cmp_first>;
+
+    std::vector<point> stack;
+
+    for( const point &p : dirty ) {
+        if( p == this->dest ) {
+            // Everything hangs off the destination, cheaper to start from scratch
+            return false;
+        }
+        if( !this->in_bounds( p ) ) {
+            continue;
+        }
+
+        // Zero g-value means "not calculated yet"
+        this->g_at( p ) = 0.0;
+        std::erase_if( this->forbidden_moves, [&p]( const std::pair<point, point> &move ) {
+            return move.first == p || move.second == p;
+        } );
+
+        if( this->tile_state_at( p ) != State::UNVISITED ) {
+            stack.push_back( p );
+        }
+    }
+
+    if( stack.empty() ) {
+        return true;
+    }
+
+    // Everything whose route leads through a changed tile has a stale p-value,
+    //   so forget the whole subtree of the search rooted at changed tiles
+    std::unordered_set<point> hole;
+    while( !stack.empty() ) {
+        const point p = stack.back();
+        stack.pop_back();
+
+        State &state = this->tile_state_at( p );
+        if( state == State::UNVISITED ) {
+            continue;
+        }
+        state = State::UNVISITED;
+        this->p_at( p ) = 0.0;
+        hole.insert( p );
+
+        for( size_t i = 0; i < DIRS_2D.size(); i++ ) {
+            const point child = p + DIRS_2D[i];
+            const State child_state = this->tile_state_at( child );
+            if( child == this->dest || child_state == State::UNVISITED || child_state == State::BOUNDS ) {
+                continue;
+            }
+            if( this->parent_at( child ) == i ) {
+                stack.push_back( child );
+            }
+        }
+    }
 
-    for( const point &p : this->tile_state_modify_set ) {
-        this->tile_state_at( p ) = State::UNVISITED;
+    // Refill the hole from its border with plain dijikstra. Since this is the only place
+    //   a cost can go down, also relax already visited tiles that now have a cheaper route.
+    Frontier frontier;
+    for( const point &p : hole ) {
+        for( const point &dir : DIRS_2D ) {
+            const point border = p + dir;
+            if( this->tile_state_at( border ) == State::ACCESSIBLE ) {
+                frontier.emplace( this->get_f_unbiased( border ), border );
+            }
+        }
     }
 
-    this->tile_state_modify_set.clear();
+    const map &here = get_map();
+    while( !frontier.empty() ) {
+        const auto [f, next_point] = frontier.top();
+        frontier.pop();
+
+        // Stale entry, the tile has been relaxed since
+        if( f != this->get_f_unbiased( next_point ) ) {
+            continue;
+        }
+
+        int _;
+        const vehicle *next_vehicle = here.veh_at_internal( tripoint( next_point, this->z ), _ );
+
+        for( size_t dir_index = 0; dir_index < DIRS_2D.size(); dir_index++ ) {
+            const point cur_point = next_point + DIRS_2D[dir_index];
+            if( cur_point == this->dest || !this->in_bounds( cur_point ) ) {
+                continue;
+            }
 
-    for( int y = 0; y < MAPSIZE_Y + 2; y++ ) {
-        this->tile_state[y][0] = State::BOUNDS;
-        this->tile_state[y][MAPSIZE_Y + 1] = State::BOUNDS;
+            State &state = this->tile_state_at( cur_point );
+            const bool is_hole = state == State::UNVISITED && hole.contains( cur_point );
+            if( !is_hole && state != State::ACCESSIBLE ) {
+                // Unexplored tiles are left for regular expansion
+                continue;
+            }
+            if( this->forbidden_moves.contains( { cur_point, next_point } ) ||
+                !this->is_move_allowed( cur_point, next_point, next_vehicle ) ) {
+                continue;
+            }
+
+            if( is_hole ) {
+                if( this->g_at( cur_point ) == 0.0 ) {
+                    this->g_at( cur_point ) = this->calculate_g( cur_point, next_point, next_vehicle );
+                }
+                state = is_inf( this->g_at( cur_point ) ) ? State::IMPASSABLE : State::ACCESSIBLE;
+                this->tile_state_modify_set.push_back( cur_point );
+                this->map_modify_set.push_back( cur_point );
+            } else if( f + this->g_at( cur_point ) >= this->get_f_unbiased( cur_point ) ) {
+                continue;
+            }
+
+            this->p_at( cur_point ) = f;
+            this->parent_at( cur_point ) = static_cast<uint8_t>( dir_index );
+            if( state == State::ACCESSIBLE ) {
+                frontier.emplace( this->get_f_unbiased( cur_point ), cur_point );
+            }
+        }
     }
-    for( int x = 0; x < MAPSIZE_X + 2; x++ ) {
-        this->tile_state[0][x] = State::BOUNDS;
-        this->tile_state[MAPSIZE_Y + 1][x] = State::BOUNDS;
+
+    // Refilled tiles bordering unexplored area have to be expanded by regular search later
+    std::erase_if( this->unbiased_frontier, [this]( const point & p ) {
+        return this->tile_state_at( p ) != State::ACCESSIBLE;
+    } );
+    for( const point &p : hole ) {
+        if( this->tile_state_at( p ) != State::ACCESSIBLE ) {
+            continue;
+        }
+        for( const point &dir : DIRS_2D ) {
+            if( this->tile_state_at( p + dir ) == State::UNVISITED ) {
+                this->unbiased_frontier.push_back( p );
+                break;
+            }
+        }
     }
+
+    this->is_explored = false;
+
+    // Long-lived maps would otherwise accumulate duplicates every repair
+    for( std::vector<point> *modify_set : { &this->map_modify_set, &this->tile_state_modify_set } ) {
+        if( modify_set->size() > static_cast<size_t>( MAPSIZE_X * MAPSIZE_Y ) ) {
+            std::sort( modify_set->begin(), modify_set->end() );
+            modify_set->erase( std::unique( modify_set->begin(), modify_set->end() ), modify_set->end() );
+        }
+    }
+
+    return true;
 }
 /// Pathfinding: Z-levels
 std::unordered_map<point, Pathfinding::ZLevelChangeOpenAirPair>
@@ -425,6 +676,192 @@ void Pathfinding::update_z_caches( bool update_open_air )
 
     Pathfinding::z_area = cur_z_area;
 }
+/// Pathfinding: tile costs
+bool Pathfinding::is_step_allowed( const int z, const point &cur_point, const point &next_point,
+                                   const vehicle *next_vehicle )
+{
+    const map &here = get_map();
+    const tripoint cur_point_with_z = tripoint( cur_point, z );
+    const tripoint next_point_with_z = tripoint( next_point, z );
+
+    int _;
+    const vehicle *cur_vehicle = here.veh_at_internal( cur_point_with_z, _ );
+
+    bool is_move_valid = true;
+
+    const bool is_valid_to_step_into_veh =
+        cur_vehicle == nullptr ?
+        true :
+        cur_vehicle->allowed_move( cur_vehicle->tripoint_to_mount( cur_point_with_z ),
+                                   cur_vehicle->tripoint_to_mount( next_point_with_z ) );
+
+    const bool is_valid_to_step_out_of_veh =
+        next_vehicle == nullptr ?
+        true :
+        next_vehicle->allowed_move( next_vehicle->tripoint_to_mount( cur_point_with_z ),
+                                    next_vehicle->tripoint_to_mount( next_point_with_z ) );
+
+    is_move_valid &= is_valid_to_step_into_veh;
+    is_move_valid &= is_valid_to_step_out_of_veh;
+
+    return is_move_valid;
+}
+bool Pathfinding::is_move_allowed( const point &cur_point, const point &next_point,
+                                   const vehicle *next_vehicle )
+{
+    if( !Pathfinding::is_step_allowed( this->z, cur_point, next_point, next_vehicle ) ) {
+        this->forbidden_moves.emplace( cur_point, next_point );
+        return false;
+    }
+    return true;
+}
+float Pathfinding::calculate_g( const point &cur_point, const point &next_point,
+                                const vehicle *next_vehicle )
+{
+    return Pathfinding::tile_g( this->settings, this->z, cur_point, next_point, next_vehicle );
+}
+float Pathfinding::tile_g( const PathfindingSettings &settings, const int z,
+                           const point &cur_point, const point &next_point,
+                           const vehicle *next_vehicle )
+{
+    const map &here = get_map();
+    const tripoint cur_point_with_z = tripoint( cur_point, z );
+    const point dir = cur_point - next_point;
+
+    const bool can_open_doors = !is_inf( settings.door_open_cost );
+    const bool can_bash = settings.bash_strength_val > 0;
+    const bool can_climb = !is_inf( settings.climb_cost );
+    const bool care_about_mobs = settings.mob_presence_penalty > 0;
+    const bool care_about_traps = settings.trap_cost > 0;
+
+    int cur_vehicle_part;
+    const vehicle *cur_vehicle = here.veh_at_internal( cur_point_with_z, cur_vehicle_part );
+
+    const maptile &new_tile = here.maptile_at_internal( cur_point_with_z );
+    const auto &terrain = new_tile.get_ter_t();
+    const auto &furniture = new_tile.get_furn_t();
+    const int move_cost = here.move_cost_internal( furniture, terrain, cur_vehicle, cur_vehicle_part );
+
+    float cur_g = 0.0;
+    bool is_diag = dir.x != 0 && dir.y != 0;
+    cur_g += is_diag ? 0.75 * move_cost : 0.5 * move_cost;
+    cur_g *= settings.move_cost_coeff;
+
+    // First, check for trivial cost modifiers
+    const bool is_rough = move_cost > 2;
+    const bool is_sharp = terrain.has_flag( TFLAG_SHARP );
+
+    cur_g += is_rough ? settings.rough_terrain_cost : 0.0;
+    cur_g += is_sharp ? settings.sharp_terrain_cost : 0.0;
+
+    if( care_about_mobs && !std::isinf( cur_g ) ) {
+        cur_g += g->critter_at( cur_point_with_z, true ) != nullptr ?
+                 settings.mob_presence_penalty :
+                 0.0;
+    }
+
+    if( care_about_traps && !std::isinf( cur_g ) ) {
+        const trap &maybe_ter_trap = terrain.trap.obj();
+        const trap &maybe_trap = maybe_ter_trap.is_benign() ? new_tile.get_trap_t() : maybe_ter_trap;
+        const bool is_trap = !maybe_trap.is_benign();
+
+        cur_g += is_trap ? settings.trap_cost : 0.0;
+    }
+
+    const bool is_ledge = here.has_zlevels() && terrain.has_flag( TFLAG_NO_FLOOR );
+    if( is_ledge && !settings.can_fly ) {
+        // Close ledges outright for non-fliers
+        cur_g += INFINITY;
+    }
+
+    // And finally, add a potential field extra
+    if( !std::isinf( cur_g ) && settings.extra_g_costs.contains( cur_point ) ) {
+        cur_g += settings.extra_g_costs.at( cur_point );
+    }
+
+    const bool is_passable = move_cost != 0;
+    float obstacle_g = 0;
+    // Calculate the cost for if the tile is impassable
+    while( !std::isinf( cur_g ) && !is_passable ) {
+        const bool is_climbable = terrain.has_flag( TFLAG_CLIMBABLE );
+        const bool is_door = !!terrain.open || !!furniture.open;
+
+        if( cur_vehicle != nullptr ) {
+            // Do processing for possible vehicle first
+            const auto vpobst = vpart_position( const_cast<vehicle &>( *cur_vehicle ),
+                                                cur_vehicle_part ).obstacle_at_part();
+            const int obstacle_part = vpobst ? vpobst->part_index() : -1;
+
+            if( obstacle_part >= 0 ) {
+                int _;
+                const bool part_is_door = cur_vehicle->part_flag( obstacle_part, VPFLAG_OPENABLE );
+                const bool part_opens_from_inside = cur_vehicle->part_flag( obstacle_part, "OPENCLOSE_INSIDE" );
+                const bool is_cur_point_inside = here.veh_at_internal( cur_point_with_z, _ ) == next_vehicle;
+                const bool valid_to_open = part_is_door && ( part_opens_from_inside ? is_cur_point_inside : true );
+
+                if( can_open_doors && valid_to_open ) {
+                    obstacle_g = settings.door_open_cost;
+                } else if( can_bash ) {
+                    const int htd = cur_vehicle->hits_to_destroy( obstacle_part,
+                                    settings.bash_strength_val * settings.bash_strength_quanta,
+                                    DT_BASH );
+                    if( htd == 0 ) {
+                        // We cannot bash down this part
+                        obstacle_g = INFINITY;
+                        break;
+                    } else {
+                        obstacle_g = settings.bash_cost * htd;
+                        break;
+                    }
+                } else {
+                    // Nothing can be done here. Don't bother with other checks since vehicles take priority.
+                    obstacle_g = INFINITY;
+                    break;
+                }
+            }
+        }
+
+        if( is_climbable && can_climb ) {
+            obstacle_g = settings.climb_cost;
+            break;
+        }
+        if( is_door && can_open_doors ) {
+            // Doors that can only be open from the inside
+            const bool door_opens_from_inside = terrain.has_flag( "OPENCLOSE_INSIDE" ) ||
+                                                furniture.has_flag( "OPENCLOSE_INSIDE" );
+            const bool is_cur_point_inside = !here.is_outside( cur_point );
+            const bool valid_to_open = door_opens_from_inside ? is_cur_point_inside : true;
+            if( valid_to_open ) {
+                obstacle_g = settings.door_open_cost;
+                break;
+            }
+        }
+        if( can_bash ) {
+            // Time to consider bashing the obstacle
+            const int rating = here.bash_rating_internal(
+                                   settings.bash_strength_val * settings.bash_strength_quanta,
+                                   furniture, terrain, false, cur_vehicle, cur_vehicle_part );
+            if( rating > 1 ) {
+                obstacle_g = ( 10. / rating ) * settings.bash_cost;
+                break;
+            } else if( rating == 1 ) {
+                // Rating == 1 implies it will take at least 10 turns to take this down
+                //   which is a very unattractive target
+                //   so we'll penalize this target a lot
+                obstacle_g = 30.0 * settings.bash_cost * settings.bash_cost * settings.bash_cost;
+                break;
+            }
+
+        }
+        // We can do nothing anymore, close the tile
+        obstacle_g = INFINITY;
+        break;
+    }
+
+    cur_g += obstacle_g;
+
+    return cur_g;
+}
 /// Pathfinding: main loops
 void Pathfinding::detect_culled_frontier(
     const point &start, const RouteSettings &route_settings, std::unordered_set<point> &out )
@@ -536,11 +973,6 @@ Pathfinding::ExpansionOutcome Pathfinding::expand_2d_up_to(
     std::unordered_set<point> culled_frontier;
     ExpansionOutcome result = ExpansionOutcome::UNSET;
 
-    const bool can_open_doors = !is_inf( this->settings.door_open_cost );
-    const bool can_bash = this->settings.bash_strength_val > 0;
-    const bool can_climb = !is_inf( this->settings.climb_cost );
-    const bool care_about_mobs = this->settings.mob_presence_penalty > 0;
-    const bool care_about_traps = this->settings.trap_cost > 0;
     const map &here = get_map();
 
     while( !biased_frontier.empty() ) {
@@ -573,10 +1005,10 @@ Pathfinding::ExpansionOutcome Pathfinding::expand_2d_up_to(
         const vehicle *next_vehicle;
         next_vehicle = here.veh_at_internal( next_point_with_z, _ );
 
-        for( const point &dir : DIRS_2D ) {
+        for( size_t dir_index = 0; dir_index < DIRS_2D.size(); dir_index++ ) {
+            const point &dir = DIRS_2D[dir_index];
             // It's cur_point because we're working backwards from destination
             const point cur_point = next_point + dir;
-            const tripoint cur_point_with_z = tripoint( cur_point, this->z );
 
             if( !this->in_bounds( cur_point ) ) {
                 continue;
@@ -586,165 +1018,18 @@ Pathfinding::ExpansionOutcome Pathfinding::expand_2d_up_to(
                 continue;
             }
 
-            int cur_vehicle_part;
-            const vehicle *cur_vehicle;
-            cur_vehicle = here.veh_at_internal( cur_point_with_z, cur_vehicle_part );
-
-            {
-                bool is_move_valid = true;
-
-                const bool is_valid_to_step_into_veh =
-                    cur_vehicle == nullptr ?
-                    true :
-                    cur_vehicle->allowed_move( cur_vehicle->tripoint_to_mount( cur_point_with_z ),
-                                               cur_vehicle->tripoint_to_mount( next_point_with_z ) );
-
-                const bool is_valid_to_step_out_of_veh =
-                    next_vehicle == nullptr ?
-                    true :
-                    next_vehicle->allowed_move( next_vehicle->tripoint_to_mount( cur_point_with_z ),
-                                                next_vehicle->tripoint_to_mount( next_point_with_z ) );
-
-                is_move_valid &= is_valid_to_step_into_veh;
-                is_move_valid &= is_valid_to_step_out_of_veh;
-
-                if( !is_move_valid ) {
-                    this->forbidden_moves.emplace( cur_point, next_point );
-                    continue;
-                }
+            if( !this->is_move_allowed( cur_point, next_point, next_vehicle ) ) {
+                continue;
             }
 
-            const maptile &new_tile = here.maptile_at_internal( cur_point_with_z );
-            const auto &terrain = new_tile.get_ter_t();
-            const auto &furniture = new_tile.get_furn_t();
-            const int move_cost = here.move_cost_internal( furniture, terrain, cur_vehicle, cur_vehicle_part );
-
-            float cur_g = this->g_at( cur_point );
-            // May be false for relative search, so we'll reuse g-values there
-            const bool is_g_calc_needed = cur_g == 0.0;
-
-            if( is_g_calc_needed ) {
-                bool is_diag = dir.x != 0 && dir.y != 0;
-                cur_g += is_diag ? 0.75 * move_cost : 0.5 * move_cost;
-                cur_g *= this->settings.move_cost_coeff;
-
-                // First, check for trivial cost modifiers
-                const bool is_rough = move_cost > 2;
-                const bool is_sharp = terrain.has_flag( TFLAG_SHARP );
-
-                cur_g += is_rough ? this->settings.rough_terrain_cost : 0.0;
-                cur_g += is_sharp ? this->settings.sharp_terrain_cost : 0.0;
-
-                if( care_about_mobs && !std::isinf( cur_g ) ) {
-                    cur_g += g->critter_at( cur_point_with_z, true ) != nullptr ?
-                             this->settings.mob_presence_penalty :
-                             0.0;
-                }
-
-                if( care_about_traps && !std::isinf( cur_g ) ) {
-                    const trap &maybe_ter_trap = terrain.trap.obj();
-                    const trap &maybe_trap = maybe_ter_trap.is_benign() ? new_tile.get_trap_t() : maybe_ter_trap;
-                    const bool is_trap = !maybe_trap.is_benign();
-
-                    cur_g += is_trap ? this->settings.trap_cost : 0.0;
-                }
-
-                const bool is_ledge = here.has_zlevels() && terrain.has_flag( TFLAG_NO_FLOOR );
-                if( is_ledge && !this->settings.can_fly ) {
-                    // Close ledges outright for non-fliers
-                    cur_g += INFINITY;
-                }
-
-                // And finally, add a potential field extra
-                if( !std::isinf( cur_g ) && this->settings.extra_g_costs.contains( cur_point ) ) {
-                    cur_g += this->settings.extra_g_costs.at( cur_point );
-                }
-
-                const bool is_passable = move_cost != 0;
-                float obstacle_g = 0;
-                // Calculate the cost for if the tile is impassable
-                while( !std::isinf( cur_g ) && !is_passable ) {
-                    const bool is_climbable = terrain.has_flag( TFLAG_CLIMBABLE );
-                    const bool is_door = !!terrain.open || !!furniture.open;
-
-                    if( cur_vehicle != nullptr ) {
-                        // Do processing for possible vehicle first
-                        const auto vpobst = vpart_position( const_cast<vehicle &>( *cur_vehicle ),
-                                                            cur_vehicle_part ).obstacle_at_part();
-                        const int obstacle_part = vpobst ? vpobst->part_index() : -1;
-
-                        if( obstacle_part >= 0 ) {
-                            int _;
-                            const bool part_is_door = cur_vehicle->part_flag( obstacle_part, VPFLAG_OPENABLE );
-                            const bool part_opens_from_inside = cur_vehicle->part_flag( obstacle_part, "OPENCLOSE_INSIDE" );
-                            const bool is_cur_point_inside = here.veh_at_internal( cur_point_with_z, _ ) == next_vehicle;
-                            const bool valid_to_open = part_is_door && ( part_opens_from_inside ? is_cur_point_inside : true );
-
-                            if( can_open_doors && valid_to_open ) {
-                                obstacle_g = this->settings.door_open_cost;
-                            } else if( can_bash ) {
-                                const int htd = cur_vehicle->hits_to_destroy( obstacle_part,
-                                                this->settings.bash_strength_val * this->settings.bash_strength_quanta,
-                                                DT_BASH );
-                                if( htd == 0 ) {
-                                    // We cannot bash down this part
-                                    obstacle_g = INFINITY;
-                                    break;
-                                } else {
-                                    obstacle_g = this->settings.bash_cost * htd;
-                                    break;
-                                }
-                            } else {
-                                // Nothing can be done here. Don't bother with other checks since vehicles take priority.
-                                obstacle_g = INFINITY;
-                                break;
-                            }
-                        }
-                    }
-
-                    if( is_climbable && can_climb ) {
-                        obstacle_g = this->settings.climb_cost;
-                        break;
-                    }
-                    if( is_door && can_open_doors ) {
-                        // Doors that can only be open from the inside
-                        const bool door_opens_from_inside = terrain.has_flag( "OPENCLOSE_INSIDE" ) ||
-                                                            furniture.has_flag( "OPENCLOSE_INSIDE" );
-                        const bool is_cur_point_inside = !here.is_outside( cur_point );
-                        const bool valid_to_open = door_opens_from_inside ? is_cur_point_inside : true;
-                        if( valid_to_open ) {
-                            obstacle_g = this->settings.door_open_cost;
-                            break;
-                        }
-                    }
-                    if( can_bash ) {
-                        // Time to consider bashing the obstacle
-                        const int rating = here.bash_rating_internal(
-                                               this->settings.bash_strength_val * this->settings.bash_strength_quanta,
-                                               furniture, terrain, false, cur_vehicle, cur_vehicle_part );
-                        if( rating > 1 ) {
-                            obstacle_g = ( 10. / rating ) * this->settings.bash_cost;
-                            break;
-                        } else if( rating == 1 ) {
-                            // Rating == 1 implies it will take at least 10 turns to take this down
-                            //   which is a very unattractive target
-                            //   so we'll penalize this target a lot
-                            obstacle_g = 30.0 * this->settings.bash_cost * this->settings.bash_cost * this->settings.bash_cost;
-                            break;
-                        }
-
-                    }
-                    // We can do nothing anymore, close the tile
-                    obstacle_g = INFINITY;
-                    break;
-                }
-
-                cur_g += obstacle_g;
-
-                this->g_at( cur_point ) = cur_g;
+            // May be already calculated for relative search, so we'll reuse g-values there
+            if( this->g_at( cur_point ) == 0.0 ) {
+                this->g_at( cur_point ) = this->calculate_g( cur_point, next_point, next_vehicle );
             }
+            const float cur_g = this->g_at( cur_point );
 
             this->p_at( cur_point ) = this->get_f_unbiased( next_point );
+            this->parent_at( cur_point ) = static_cast<uint8_t>( dir_index );
 
             // Reintroduce this point into frontier unless the tile is closed
             if( is_inf( cur_g ) ) {
@@ -800,6 +1085,358 @@ Pathfinding::ExpansionOutcome Pathfinding::expand_2d_up_to(
 }
 
 
+/// Pathfinding: hierarchical routes
+Pathfinding::PortalGraph &Pathfinding::get_portal_graph( const int z,
+        const PathfindingSettings &settings )
+{
+    PathfindingSettings graph_settings = settings;
+    graph_settings.mob_presence_penalty = 0.0;
+
+    auto graph_it = std::ranges::find_if( Pathfinding::portal_graphs,
+    [z, &graph_settings]( const auto & graph ) {
+        return graph->z == z && graph->settings == graph_settings;
+    } );
+
+    if( graph_it != Pathfinding::portal_graphs.end() ) {
+        ( *graph_it )->is_used = true;
+        return **graph_it;
+    }
+
+    std::unique_ptr<PortalGraph> graph = std::make_unique<PortalGraph>();
+    graph->z = z;
+    graph->settings = std::move( graph_settings );
+    graph->dirty.set();
+    Pathfinding::portal_graphs.push_back( std::move( graph ) );
+    return *Pathfinding::portal_graphs.back();
+}
+const std::vector<Pathfinding::Portal> &Pathfinding::get_portals( PortalGraph &graph,
+        const point &sm )
+{
+    const size_t sm_index = sm.x + sm.y * MAPSIZE;
+    std::vector<Portal> &portals = graph.portals[sm_index];
+    if( !graph.dirty[sm_index] ) {
+        return portals;
+    }
+    graph.dirty.reset( sm_index );
+    portals.clear();
+
+    const map &here = get_map();
+    const int z = graph.z;
+    const PathfindingSettings &settings = graph.settings;
+
+    // Can we step both ways between `a` and `b`?
+    const auto can_cross = [&]( const point & a, const point & b ) {
+        int _;
+        const vehicle *a_vehicle = here.veh_at_internal( tripoint( a, z ), _ );
+        const vehicle *b_vehicle = here.veh_at_internal( tripoint( b, z ), _ );
+        return Pathfinding::is_step_allowed( z, a, b, b_vehicle ) &&
+               Pathfinding::is_step_allowed( z, b, a, a_vehicle ) &&
+               !is_inf( Pathfinding::tile_g( settings, z, a, b, b_vehicle ) ) &&
+               !is_inf( Pathfinding::tile_g( settings, z, b, a, a_vehicle ) );
+    };
+
+    const point corner( sm.x * SEEX, sm.y * SEEY );
+    for( const point &across : ORTHOGONAL_DIRS_2D ) {
+        const point neighbour_sm = sm + across;
+        if( neighbour_sm.x < 0 || neighbour_sm.x >= MAPSIZE ||
+            neighbour_sm.y < 0 || neighbour_sm.y >= MAPSIZE ) {
+            continue;
+        }
+
+        // Walk along the side of the submap facing `across`
+        const point step = across.x != 0 ? point_south : point_east;
+        const point side_start = corner + point( across.x > 0 ? SEEX - 1 : 0, across.y > 0 ? SEEY - 1 : 0 );
+        const int side_length = across.x != 0 ? SEEY : SEEX;
+
+        // Every run of crossable tiles gets a portal in its middle. The neighbouring submap
+        //   finds the exact same runs from its side, so portals always come in pairs.
+        int run_start = -1;
+        for( int i = 0; i <= side_length; i++ ) {
+            const point p = side_start + step * i;
+            const bool is_open = i < side_length && can_cross( p, p + across );
+            if( is_open && run_start < 0 ) {
+                run_start = i;
+            } else if( !is_open && run_start >= 0 ) {
+                const point portal_pos = side_start + step * ( ( run_start + i - 1 ) / 2 );
+                run_start = -1;
+                // Corner tiles may be picked by two sides
+                const bool is_duplicate = std::ranges::any_of( portals, [&portal_pos]( const Portal & portal ) {
+                    return portal.pos == portal_pos;
+                } );
+                if( !is_duplicate ) {
+                    portals.push_back( Portal{ .pos = portal_pos, .edges = {} } );
+                }
+            }
+        }
+    }
+
+    SubmapSearch search;
+    for( Portal &portal : portals ) {
+        Pathfinding::search_submap( settings, z, portal.pos, true, search );
+        for( size_t i = 0; i < portals.size(); i++ ) {
+            const point local = portals[i].pos - corner;
+            const float cost = search.cost[local.y][local.x];
+            if( portals[i].pos != portal.pos && !is_inf( cost ) ) {
+                portal.edges.emplace_back( i, cost );
+            }
+        }
+    }
+
+    return portals;
+}
+void Pathfinding::search_submap( const PathfindingSettings &settings, const int z,
+                                 const point &origin, const bool forward, SubmapSearch &out )
+{
+    using Frontier = std::priority_queue<val_pair, std::vector<val_pair>, pair_greater_cmp_first>;
+
+    const map &here = get_map();
+    const point corner( origin.x - origin.x % SEEX, origin.y - origin.y % SEEY );
+
+    for( auto &row : out.cost ) {
+        row.fill( INFINITY );
+    }
+    const point origin_local = origin - corner;
+    out.cost[origin_local.y][origin_local.x] = 0.0;
+    out.came_from[origin_local.y][origin_local.x] = origin;
+
+    Frontier frontier;
+    frontier.emplace( 0.0, origin );
+
+    while( !frontier.empty() ) {
+        const auto [cost, p] = frontier.top();
+        frontier.pop();
+
+        const point p_local = p - corner;
+        if( cost > out.cost[p_local.y][p_local.x] ) {
+            continue;
+        }
+
+        int _;
+        const vehicle *p_vehicle = here.veh_at_internal( tripoint( p, z ), _ );
+
+        for( const point &dir : DIRS_2D ) {
+            const point next = p + dir;
+            const point next_local = next - corner;
+            if( next_local.x < 0 || next_local.x >= SEEX || next_local.y < 0 || next_local.y >= SEEY ) {
+                continue;
+            }
+
+            // Like in dijikstra maps, a step costs g-value of the tile we leave
+            float step_cost;
+            if( forward ) {
+                const vehicle *next_vehicle = here.veh_at_internal( tripoint( next, z ), _ );
+                if( !Pathfinding::is_step_allowed( z, p, next, next_vehicle ) ) {
+                    continue;
+                }
+                step_cost = Pathfinding::tile_g( settings, z, p, next, next_vehicle );
+            } else {
+                if( !Pathfinding::is_step_allowed( z, next, p, p_vehicle ) ) {
+                    continue;
+                }
+                step_cost = Pathfinding::tile_g( settings, z, next, p, p_vehicle );
+            }
+
+            const float next_cost = cost + step_cost;
+            if( is_inf( next_cost ) || next_cost >= out.cost[next_local.y][next_local.x] ) {
+                continue;
+            }
+            out.cost[next_local.y][next_local.x] = next_cost;
+            out.came_from[next_local.y][next_local.x] = p;
+            frontier.emplace( next_cost, next );
+        }
+    }
+}
+std::vector<tripoint> Pathfinding::get_route_2d_hierarchical(
+    const point from, const point to, const int z,
+    const PathfindingSettings &path_settings,
+    const RouteSettings &route_settings )
+{
+    // Portals are identified by submap index in the upper bits and portal index in the lower ones
+    using NodeId = uint32_t;
+    constexpr NodeId START = UINT32_MAX - 1;
+    constexpr NodeId GOAL = UINT32_MAX;
+    constexpr int PORTAL_BITS = 8;
+
+    const point sm_from( from.x / SEEX, from.y / SEEY );
+    const point sm_to( to.x / SEEX, to.y / SEEY );
+    if( sm_from == sm_to ) {
+        return std::vector<tripoint>();
+    }
+
+    PortalGraph &graph = Pathfinding::get_portal_graph( z, path_settings );
+
+    const auto sm_of = [&]( const NodeId id ) {
+        if( id == START ) {
+            return sm_from;
+        } else if( id == GOAL ) {
+            return sm_to;
+        }
+        const int sm_index = id >> PORTAL_BITS;
+        return point( sm_index % MAPSIZE, sm_index / MAPSIZE );
+    };
+    const auto pos_of = [&]( const NodeId id ) {
+        if( id == START ) {
+            return from;
+        } else if( id == GOAL ) {
+            return to;
+        }
+        return graph.portals[id >> PORTAL_BITS][id & ( ( 1 << PORTAL_BITS ) - 1 )].pos;
+    };
+    const auto portal_id = []( const point & sm, const size_t portal_index ) {
+        return static_cast<NodeId>( ( ( sm.x + sm.y * MAPSIZE ) << PORTAL_BITS ) + portal_index );
+    };
+
+    SubmapSearch from_search;
+    Pathfinding::search_submap( graph.settings, z, from, true, from_search );
+    SubmapSearch to_search;
+    Pathfinding::search_submap( graph.settings, z, to, false, to_search );
+    const point from_corner( sm_from.x * SEEX, sm_from.y * SEEY );
+    const point to_corner( sm_to.x * SEEX, sm_to.y * SEEY );
+
+    const float step_cost = graph.settings.move_cost_coeff;
+    const auto h = [&]( const point & p ) {
+        return route_settings.h_coeff * step_cost * rl_dist_exact( tripoint( p, 0 ), tripoint( to, 0 ) );
+    };
+
+    // A* over portals
+    std::priority_queue<std::pair<float, NodeId>, std::vector<std::pair<float, NodeId>>, pair_greater_cmp_first>
+    open;
+    std::unordered_map<NodeId, float> best_cost;
+    std::unordered_map<NodeId, NodeId> came_from;
+
+    const auto relax = [&]( const NodeId from_id, const NodeId to_id, const float edge_cost ) {
+        const float cost = best_cost[from_id] + edge_cost;
+        const auto it = best_cost.find( to_id );
+        if( is_inf( cost ) || ( it != best_cost.end() && it->second <= cost ) ) {
+            return;
+        }
+        best_cost[to_id] = cost;
+        came_from[to_id] = from_id;
+        open.emplace( cost + h( pos_of( to_id ) ), to_id );
+    };
+
+    best_cost[START] = 0.0;
+    open.emplace( h( from ), START );
+
+    const map &here = get_map();
+    bool found = false;
+    while( !open.empty() ) {
+        const NodeId id = open.top().second;
+        const float f = open.top().first;
+        open.pop();
+
+        if( f > best_cost[id] + h( pos_of( id ) ) ) {
+            // Stale entry
+            continue;
+        }
+        if( id == GOAL ) {
+            found = true;
+            break;
+        }
+
+        const point sm = sm_of( id );
+        const std::vector<Portal> &portals = Pathfinding::get_portals( graph, sm );
+
+        if( id == START ) {
+            for( size_t i = 0; i < portals.size(); i++ ) {
+                const point local = portals[i].pos - from_corner;
+                relax( id, portal_id( sm, i ), from_search.cost[local.y][local.x] );
+            }
+            continue;
+        }
+
+        const Portal &portal = portals[id & ( ( 1 << PORTAL_BITS ) - 1 )];
+        for( const auto &[i, cost] : portal.edges ) {
+            relax( id, portal_id( sm, i ), cost );
+        }
+        if( sm == sm_to ) {
+            const point local = portal.pos - to_corner;
+            relax( id, GOAL, to_search.cost[local.y][local.x] );
+        }
+
+        // Cross into the neighbouring submap
+        for( const point &dir : ORTHOGONAL_DIRS_2D ) {
+            const point across = portal.pos + dir;
+            const point across_sm( across.x / SEEX, across.y / SEEY );
+            if( across.x < 0 || across.y < 0 || across_sm.x >= MAPSIZE || across_sm.y >= MAPSIZE ||
+                across_sm == sm ) {
+                continue;
+            }
+            const std::vector<Portal> &across_portals = Pathfinding::get_portals( graph, across_sm );
+            for( size_t i = 0; i < across_portals.size(); i++ ) {
+                if( across_portals[i].pos != across ) {
+                    continue;
+                }
+                int _;
+                const vehicle *across_vehicle = here.veh_at_internal( tripoint( across, z ), _ );
+                relax( id, portal_id( across_sm, i ),
+                       Pathfinding::tile_g( graph.settings, z, portal.pos, across, across_vehicle ) );
+                break;
+            }
+        }
+    }
+
+    if( !found ) {
+        return std::vector<tripoint>();
+    }
+
+    // Could be NaN if max_f_coeff = INFINITY * 0
+    const float max_f = route_settings.max_f_coeff * (
+                            route_settings.f_limit_based_on_max_dist ?
+                            route_settings.max_dist :
+                            rl_dist_exact( tripoint( from, z ), tripoint( to, z ) ) );
+    if( !is_nan( max_f ) && best_cost[GOAL] > max_f ) {
+        return std::vector<tripoint>();
+    }
+
+    std::vector<NodeId> abstract_path;
+    for( NodeId id = GOAL; id != START; id = came_from[id] ) {
+        abstract_path.push_back( id );
+    }
+    abstract_path.push_back( START );
+    std::ranges::reverse( abstract_path );
+
+    // Refine the corridor: steps between submaps are single tiles,
+    //   steps inside a submap are searched for with actual settings
+    std::vector<tripoint> result;
+    result.emplace_back( from, z );
+    SubmapSearch search;
+    for( size_t i = 0; i + 1 < abstract_path.size(); i++ ) {
+        const point segment_from = pos_of( abstract_path[i] );
+        const point segment_to = pos_of( abstract_path[i + 1] );
+        if( segment_from == segment_to ) {
+            continue;
+        }
+        if( sm_of( abstract_path[i] ) != sm_of( abstract_path[i + 1] ) ) {
+            result.emplace_back( segment_to, z );
+            continue;
+        }
+
+        Pathfinding::search_submap( path_settings, z, segment_from, true, search );
+        const point corner( segment_from.x - segment_from.x % SEEX, segment_from.y - segment_from.y % SEEY );
+        const point to_local = segment_to - corner;
+        if( is_inf( search.cost[to_local.y][to_local.x] ) ) {
+            // Something is in the way that the graph does not know of, such as mobs
+            return std::vector<tripoint>();
+        }
+
+        std::vector<tripoint> segment;
+        for( point p = segment_to; p != segment_from; ) {
+            segment.emplace_back( p, z );
+            const point local = p - corner;
+            p = search.came_from[local.y][local.x];
+        }
+        result.insert( result.end(), segment.rbegin(), segment.rend() );
+    }
+
+    const int chebyshev_distance = square_dist( from, to );
+    if( result.size() - 2 > route_settings.max_s_coeff * chebyshev_distance ) {
+        return std::vector<tripoint>();
+    }
+
+    return result;
+}
+
 std::vector<tripoint> Pathfinding::get_route_2d(
     const point from, const point to, const int z,
     const PathfindingSettings path_settings,
@@ -815,6 +1452,19 @@ std::vector<tripoint> Pathfinding::get_route_2d(
         return map->dest == to && map->z == z && map->settings == path_settings;
     } );
 
+    // Don't bother with portals if a d_map already knows the way
+    const bool d_map_has_route = d_map_it != Pathfinding::d_maps.end() &&
+                                 ( *d_map_it )->domain == MapDomain::ABSOLUTE_DOMAIN &&
+                                 ( *d_map_it )->tile_state_at( from ) == State::ACCESSIBLE;
+    const bool is_long_route = square_dist( from, to ) >= route_settings.hierarchical_min_dist;
+    if( is_long_route && !d_map_has_route && !route_settings.is_relative_search_domain() ) {
+        std::vector<tripoint> route = Pathfinding::get_route_2d_hierarchical( from, to, z,
+                                      path_settings, route_settings );
+        if( !route.empty() ) {
+            return route;
+        }
+    }
+
     Pathfinding *d_map;
     if( d_map_it == Pathfinding::d_maps.end() ) {
         Pathfinding::produce_d_map( to, z, path_settings );
@@ -822,6 +1472,7 @@ std::vector<tripoint> Pathfinding::get_route_2d(
     } else {
         d_map = d_map_it->get();
     }
+    d_map->is_used = true;
 
     if( !d_map->is_in_limited_domain( from, from, route_settings ) ) {
         // This should only fail if max f-limit is failed
@@ -1095,6 +1746,13 @@ std::vector<tripoint> Pathfinding::route(
     here.clip_to_bounds( from );
     here.clip_to_bounds( to );
 
+    // The map may have shifted mid-turn, invalidating local coordinates of all d_maps
+    if( here.get_abs_sub() != Pathfinding::d_maps_origin ) {
+        Pathfinding::clear_d_maps();
+        Pathfinding::portal_graphs.clear();
+        Pathfinding::d_maps_origin = here.get_abs_sub();
+    }
+
     PathfindingSettings path_settings = maybe_path_settings.has_value() ? *maybe_path_settings :
                                         PathfindingSettings();
     RouteSettings route_settings = maybe_route_settings.has_value() ? *maybe_route_settings :
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <bitset>
+#include <cstdint>
 #include <cstring>
 #include <map>
 #include <memory>
@@ -14,6 +16,7 @@
 #include "point.h"
 #include "rng.h"
 
+class vehicle;
 
 // A struct defining abilities of the actor and how to respond to various terrain features
 struct PathfindingSettings {
@@ -167,6 +170,13 @@ struct RouteSettings {
     // Check `max_f_coeff` for more detail.
     bool f_limit_based_on_max_dist = true;
 
+    // Routes at least this long (chebyshev distance in tiles) between different submaps are first planned
+    //   over a graph of submap border crossings and then refined tile by tile only along the chosen corridor.
+    // This is much cheaper for one-off long routes, but the path may be slightly longer than the shortest one
+    //   and the work is not shared with other actors heading to the same destination like dijikstra maps are.
+    // INFINITY disables it. Ignored for relative search domains.
+    float hierarchical_min_dist = INFINITY;
+
     // Does the search domain depend on start position?
     constexpr bool is_relative_search_domain() const;
 };
@@ -212,12 +222,47 @@ class Pathfinding
             std::optional<ZLevelChange> reach_from_above;
         };
 
+        // A tile on a submap border that routes can cross into the neighbouring submap through
+        struct Portal {
+            point pos;
+            // Cost of walking to other portals of the same submap: (portal index, cost)
+            std::vector<std::pair<size_t, float>> edges;
+        };
+        // HPA*-style abstract graph of a z-level: portals between adjacent submaps and costs of walking
+        //   between portals of the same submap. Portals are rebuilt per submap whenever its tiles change.
+        struct PortalGraph {
+            int z = 0;
+            // Settings costs were calculated with. Mob presence is ignored on this level since mobs move every turn.
+            PathfindingSettings settings;
+            // Portals of each submap, indexed by `x + y * MAPSIZE`
+            std::array<std::vector<Portal>, MAPSIZE * MAPSIZE> portals;
+            // Submaps whose portals are out of date
+            std::bitset<MAPSIZE * MAPSIZE> dirty;
+            // Was this graph queried since the last turn ended?
+            bool is_used = true;
+        };
+        // Costs and search tree of a search confined to a single submap
+        struct SubmapSearch {
+            std::array<std::array<float, SEEX>, SEEY> cost;
+            std::array<std::array<point, SEEX>, SEEY> came_from;
+        };
+
         // Global state: allocated dijikstra d_maps. Pull to `d_maps` from here.
         static std::vector<std::unique_ptr<Pathfinding>> d_maps_store;
 
-        // Global state: memoized dijikstra d_maps. Transfer to `d_maps_store` every game turn.
+        // Global state: memoized dijikstra d_maps. Maps that were used during the turn and are not affected
+        //   by mob positions survive into the next turn and get repaired instead of rebuilt,
+        //   everything else is transferred to `d_maps_store` every game turn.
         static std::vector<std::unique_ptr<Pathfinding>> d_maps;
 
+        // Global state: absolute submap of the map's top left corner `d_maps` were built against.
+        // All local coordinates become meaningless once the map shifts.
+        static tripoint d_maps_origin;
+        // Global state: tiles that changed in a way that could affect g-values since last turn, per z-level
+        static std::array<std::vector<point>, OVERMAP_LAYERS> dirty_tiles;
+        // Global state: z-levels that changed too much to track per tile (submap loads, moving vehicles)
+        static std::bitset<OVERMAP_LAYERS> dirty_levels;
+
         // We store the area covered by last Z-scan (in global coords, top left loaded submap)
         // ```
         // -----
@@ -241,6 +286,8 @@ class Pathfinding
         z_caches_open_air;
         // Global state: We cache `z_path` information taken to prevent multiple iterations for the same target
         static std::map<std::tuple<bool, int, tripoint>, ZLevelChange> cached_closest_z_changes;
+        // Global state: portal graphs for hierarchical routes, shares lifetime rules with `d_maps`
+        static std::vector<std::unique_ptr<PortalGraph>> portal_graphs;
 
         // Smallest adjacent f
         std::array<std::array<float, MAPSIZE_X>, MAPSIZE_Y> p_map;
@@ -248,6 +295,9 @@ class Pathfinding
         std::array<std::array<float, MAPSIZE_X>, MAPSIZE_Y> g_map;
         // Tile overall state [padded on all sides by 1 tile for bounds checking]
         std::array < std::array < State, MAPSIZE_X + 2 >, MAPSIZE_Y + 2 > tile_state;
+        // Index into `DIRS_2D` of the step that expanded into the tile: parent is `p - DIRS_2D[i]`.
+        // Only meaningful for visited tiles, used to find tiles whose route goes through a changed tile.
+        std::array<std::array<uint8_t, MAPSIZE_X>, MAPSIZE_Y> parent_map;
 
         // Which points in maps have we modified thus far? Used for resetting.
         std::vector<point> map_modify_set;
@@ -266,6 +316,9 @@ class Pathfinding
         // Is the map already fully explored? UNVISITED tiles become INACCESSIBLE in that case.
         bool is_explored = false;
 
+        // Was this map queried since the last turn ended? Unused maps are not worth repairing.
+        bool is_used = true;
+
         // We don't want to calculate dijikstra of the whole map every time,
         //   so we store wave `frontier` to proceed from later if needed
         std::vector<point> unbiased_frontier;
@@ -284,11 +337,36 @@ class Pathfinding
         static std::unordered_map<point, ZLevelChangeOpenAirPair> &get_z_cache_open_air( const int z );
 
         static void produce_d_map( point dest, int z, PathfindingSettings settings );
+        // Reset `d_map` and return it to `d_maps_store`
+        static void recycle_d_map( std::unique_ptr<Pathfinding> &&d_map );
+
+        // Can this map be carried over to the next turn at all?
+        bool is_reusable() const;
+        // Forget everything derived from `dirty` tiles: their g-values and the search subtree rooted at them,
+        //   then refill the hole from its border and propagate any cost decrease outwards (LPA*-style repair).
+        // Returns false if the map cannot be repaired and should be rebuilt instead.
+        bool repair( const std::vector<point> &dirty );
+
+        // Check if stepping from `cur_point` into `next_point` is allowed by vehicle geometry, remember it in `forbidden_moves` if not
+        bool is_move_allowed( const point &cur_point, const point &next_point,
+                              const vehicle *next_vehicle );
+        // Calculate g-value of `cur_point` when it is expanded from `next_point`
+        float calculate_g( const point &cur_point, const point &next_point,
+                           const vehicle *next_vehicle );
+        // See `is_move_allowed`, without remembering the result
+        static bool is_step_allowed( int z, const point &cur_point, const point &next_point,
+                                     const vehicle *next_vehicle );
+        // See `calculate_g`
+        static float tile_g( const PathfindingSettings &settings, int z,
+                             const point &cur_point, const point &next_point,
+                             const vehicle *next_vehicle );
 
         // Get `p`-value at `p`
         float &p_at( const point &p );
         // Get `g`-value at `p`
         float &g_at( const point &p );
+        // Get index of the direction `p` was expanded with
+        uint8_t &parent_at( const point &p );
         // f0 = p + g
         float get_f_unbiased( const point &p );
         // f1 = p + g + `h_coeff` * [distance between `start` and `p`]
@@ -309,6 +387,19 @@ class Pathfinding
         bool is_in_limited_domain( const point &start, const point &p,
                                    const RouteSettings &route_settings );
 
+        // Get (and create if needed) portal graph for `z` and `settings`
+        static PortalGraph &get_portal_graph( int z, const PathfindingSettings &settings );
+        // Get portals of submap `sm`, rebuilding them if they are out of date
+        static const std::vector<Portal> &get_portals( PortalGraph &graph, const point &sm );
+        // Run dijikstra from `origin` without leaving its submap. If `forward`, costs are of walking from `origin`,
+        //   otherwise of walking to `origin`.
+        static void search_submap( const PathfindingSettings &settings, int z, const point &origin,
+                                   bool forward, SubmapSearch &out );
+        // See `Pathfinding::route` and `RouteSettings::hierarchical_min_dist`
+        static std::vector<tripoint> get_route_2d_hierarchical(
+            const point from, const point to, const int z,
+            const PathfindingSettings &path_settings,
+            const RouteSettings &route_settings );
         // See `Pathfinding::route`
         static std::vector<tripoint> get_route_2d(
             const point from, const point to, const int z,
@@ -333,6 +424,15 @@ class Pathfinding
         // Reset whole pathfinding pretty much
         static void clear_d_maps();
 
+        // Called once per turn: repair d_maps that can be carried over into the next turn
+        //   with tiles marked dirty during this turn, recycle the rest.
+        static void end_turn();
+
+        // A tile on the reality bubble changed in a way that may change its cost (terrain, furniture, trap, field, vehicle part)
+        static void mark_dirty_tile( const tripoint &p );
+        // Too many tiles changed on the z-level to track them individually
+        static void mark_dirty_level( int z );
+
         // Reset Z-level information. Should only be done when new Z-level changes could have appeared
         //   such as change in terrain
         static void mark_dirty_z_cache();
@@ -1,6 +1,7 @@
 #include "recipe_dictionary.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <iterator>
 #include <memory>
 #include <unordered_map>
@@ -23,6 +24,7 @@
 #include "skill.h"
 #include "string_id.h"
 #include "string_utils.h"
+#include "translations.h"
 #include "uistate.h"
 #include "units.h"
 #include "value_ptr.h"
@@ -93,29 +95,233 @@ recipe_filter recipe_filter_by_component( const itype_id &c )
     };
 }
 
-// searches for left-anchored partial match in the relevant recipe requirements set
+// joins the names of all alternatives in a requirements set, one per line
 template <class group>
-bool search_reqs( group gp, const std::string &txt )
+void append_reqs( std::string &text, const group &gp )
 {
-    return std::any_of( gp.begin(), gp.end(), [&]( const typename group::value_type & opts ) {
-        return std::any_of( opts.begin(),
-        opts.end(), [&]( const typename group::value_type::value_type & e ) {
-            return lcmatch( e.to_string(), txt );
-        } );
-    } );
+    for( const auto &opts : gp ) {
+        for( const auto &e : opts ) {
+            text += e.to_string();
+            text += '\n';
+        }
+    }
 }
 // template specialization to make component searches easier
 template<>
-bool search_reqs( std::vector<std::vector<item_comp> >  gp,
-                  const std::string &txt )
+void append_reqs( std::string &text, const std::vector<std::vector<item_comp>> &gp )
 {
-    return std::any_of( gp.begin(), gp.end(), [&]( const std::vector<item_comp> &opts ) {
-        return std::any_of( opts.begin(), opts.end(), [&]( const item_comp & ic ) {
-            return lcmatch( item::nname( ic.type ), txt );
-        } );
+    for( const std::vector<item_comp> &opts : gp ) {
+        for( const item_comp &ic : opts ) {
+            text += item::nname( ic.type );
+            text += '\n';
+        }
+    }
+}
+
+// all text of the recipe a query of the given type is matched against, one entry per line
+static std::string search_text( const recipe &r, const recipe_subset::search_type key )
+{
+    using search_type = recipe_subset::search_type;
+    std::string text;
+    switch( key ) {
+        case search_type::name:
+            return r.result_name( /*decorated=*/false );
+
+        case search_type::skill:
+            return r.required_skills_string( nullptr, true, false );
+
+        case search_type::primary_skill:
+            return r.skill_used->name();
+
+        case search_type::component:
+            append_reqs( text, r.simple_requirements().get_components() );
+            return text;
+
+        case search_type::tool:
+            append_reqs( text, r.simple_requirements().get_tools() );
+            return text;
+
+        case search_type::quality:
+            append_reqs( text, r.simple_requirements().get_qualities() );
+            return text;
+
+        case search_type::quality_result:
+            for( const std::pair<const quality_id, int> &e : r.result()->qualities ) {
+                text += e.first->name.translated();
+                text += '\n';
+            }
+            return text;
+
+        case search_type::description_result: {
+            detached_ptr<item> result = r.create_result();
+            return remove_color_tags( result->info_string( iteminfo_query::no_conditions ) );
+        }
+
+        default:
+            return text;
+    }
+}
+
+namespace
+{
+
+using trigram = uint32_t;
+
+trigram trigram_at( const std::string &text, size_t pos )
+{
+    return static_cast<uint8_t>( text[pos] ) |
+           static_cast<uint8_t>( text[pos + 1] ) << 8 |
+           static_cast<uint8_t>( text[pos + 2] ) << 16;
+}
+
+std::vector<trigram> trigrams_of( const std::string &text )
+{
+    std::vector<trigram> res;
+    for( size_t i = 0; i + 3 <= text.size(); i++ ) {
+        res.push_back( trigram_at( text, i ) );
+    }
+    std::sort( res.begin(), res.end() );
+    res.erase( std::unique( res.begin(), res.end() ), res.end() );
+    return res;
+}
+
+/**
+ * Lower-cased search text of the recipes, one field per search type.
+ *
+ * A field is built the first time its search type is used after the recipes are finalized
+ * or the language changes, so the description text is rendered once instead of on every
+ * keystroke. Recipes that are not part of the dictionary are added when first searched.
+ * Queries of at least three bytes only compare the text of recipes containing all of their
+ * trigrams.
+ */
+class recipe_search_index
+{
+    public:
+        void clear() {
+            fields.clear();
+        }
+
+        std::vector<const recipe *> search( const std::set<const recipe *> &recipes,
+                                            const std::string &txt,
+                                            recipe_subset::search_type key );
+
+    private:
+        struct field {
+            std::unordered_map<const recipe *, std::string> text;
+            // Recipes containing each trigram, sorted by address like recipe_subset
+            std::unordered_map<trigram, std::vector<const recipe *>> postings;
+
+            const std::string &add( const recipe *r, recipe_subset::search_type key,
+                                    bool keep_sorted );
+            std::vector<const recipe *> candidates( const std::string &needle ) const;
+        };
+
+        field &get( recipe_subset::search_type key );
+
+        std::map<recipe_subset::search_type, field> fields;
+        int language_version = INVALID_LANGUAGE_VERSION;
+};
+
+const std::string &recipe_search_index::field::add( const recipe *r,
+        const recipe_subset::search_type key, const bool keep_sorted )
+{
+    const std::string &lower = text[r] = to_lower_case( search_text( *r, key ) );
+    for( const trigram t : trigrams_of( lower ) ) {
+        std::vector<const recipe *> &list = postings[t];
+        if( keep_sorted ) {
+            list.insert( std::lower_bound( list.begin(), list.end(), r ), r );
+        } else {
+            list.push_back( r );
+        }
+    }
+    return lower;
+}
+
+std::vector<const recipe *> recipe_search_index::field::candidates(
+    const std::string &needle ) const
+{
+    std::vector<const std::vector<const recipe *> *> lists;
+    for( const trigram t : trigrams_of( needle ) ) {
+        const auto iter = postings.find( t );
+        if( iter == postings.end() ) {
+            return {};
+        }
+        lists.push_back( &iter->second );
+    }
+    std::ranges::sort( lists, []( const auto * lhs, const auto * rhs ) {
+        return lhs->size() < rhs->size();
     } );
+
+    std::vector<const recipe *> res = *lists.front();
+    std::vector<const recipe *> narrowed;
+    for( auto iter = std::next( lists.begin() ); iter != lists.end() && !res.empty(); ++iter ) {
+        narrowed.clear();
+        std::set_intersection( res.begin(), res.end(), ( *iter )->begin(), ( *iter )->end(),
+                               std::back_inserter( narrowed ) );
+        res.swap( narrowed );
+    }
+    return res;
 }
 
+recipe_search_index::field &recipe_search_index::get( const recipe_subset::search_type key )
+{
+    if( language_version != detail::get_current_language_version() ) {
+        fields.clear();
+        language_version = detail::get_current_language_version();
+    }
+    const auto iter = fields.find( key );
+    if( iter != fields.end() ) {
+        return iter->second;
+    }
+
+    field &f = fields[key];
+    for( const auto &e : recipe_dict ) {
+        if( e.second && !e.second.obsolete ) {
+            f.add( &e.second, key, false );
+        }
+    }
+    for( auto &e : f.postings ) {
+        std::sort( e.second.begin(), e.second.end() );
+    }
+    return f;
+}
+
+std::vector<const recipe *> recipe_search_index::search( const std::set<const recipe *> &recipes,
+        const std::string &txt, const recipe_subset::search_type key )
+{
+    field &f = get( key );
+    const std::string needle = to_lower_case( txt );
+    const bool narrow = needle.size() >= 3;
+    const std::vector<const recipe *> candidates = narrow ? f.candidates( needle ) :
+            std::vector<const recipe *>();
+
+    std::vector<const recipe *> res;
+    std::copy_if( recipes.begin(), recipes.end(), std::back_inserter( res ), [&]( const recipe * r ) {
+        if( !*r || r->obsolete ) {
+            return false;
+        }
+        if( key == recipe_subset::search_type::name &&
+            uistate.favorite_recipes.contains( r->ident() ) ) {
+            // The favorite marker is part of the name shown in the list
+            return lcmatch( r->result_name( /*decorated=*/true ), txt );
+        }
+        const auto iter = f.text.find( r );
+        if( iter == f.text.end() ) {
+            return f.add( r, key, true ).find( needle ) != std::string::npos;
+        }
+        if( narrow && !std::binary_search( candidates.begin(), candidates.end(), r ) ) {
+            return false;
+        }
+        return iter->second.find( needle ) != std::string::npos;
+    } );
+
+    return res;
+}
+
+recipe_search_index search_index;
+
+} // namespace
+
 std::vector<const recipe *> recipe_subset::favorite() const
 {
     std::vector<const recipe *> res;
@@ -161,50 +367,7 @@ std::vector<const recipe *> recipe_subset::recent() const
 std::vector<const recipe *> recipe_subset::search( const std::string &txt,
         const search_type key ) const
 {
-    std::vector<const recipe *> res;
-
-    std::copy_if( recipes.begin(), recipes.end(), std::back_inserter( res ), [&]( const recipe * r ) {
-        if( !*r || r->obsolete ) {
-            return false;
-        }
-        switch( key ) {
-            case search_type::name:
-                return lcmatch( r->result_name( /*decorated=*/true ), txt );
-
-            case search_type::skill:
-                return lcmatch( r->required_skills_string( nullptr, true, false ), txt );
-
-            case search_type::primary_skill:
-                return lcmatch( r->skill_used->name(), txt );
-
-            case search_type::component:
-                return search_reqs( r->simple_requirements().get_components(), txt );
-
-            case search_type::tool:
-                return search_reqs( r->simple_requirements().get_tools(), txt );
-
-            case search_type::quality:
-                return search_reqs( r->simple_requirements().get_qualities(), txt );
-
-            case search_type::quality_result: {
-                const auto &quals = r->result()->qualities;
-                return std::any_of( quals.begin(), quals.end(), [&]( const std::pair<quality_id, int> &e ) {
-                    return lcmatch( e.first->name, txt );
-                } );
-            }
-
-            case search_type::description_result: {
-                //TODO!: push this up, it's a potentially infinite one I think
-                detached_ptr<item> result = r->create_result();
-                return lcmatch( remove_color_tags( result->info_string( iteminfo_query::no_conditions ) ), txt );
-            }
-
-            default:
-                return false;
-        }
-    } );
-
-    return res;
+    return search_index.search( recipes, txt, key );
 }
 
 recipe_subset::recipe_subset( const recipe_subset &src, const std::vector<const recipe *> &recipes )
@@ -491,6 +654,7 @@ void recipe_dictionary::finalize()
     }
 
     recipe_dict.find_items_on_loops();
+    search_index.clear();
 }
 
 void recipe_dictionary::reset()
@@ -501,6 +665,7 @@ void recipe_dictionary::reset()
     recipe_dict.recipes.clear();
     recipe_dict.uncraft.clear();
     recipe_dict.items_on_loops.clear();
+    search_index.clear();
 }
 
 void recipe_dictionary::delete_if( const std::function<bool( const recipe & )> &pred )
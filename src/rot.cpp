@@ -1,11 +1,24 @@
 #include "rot.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "debug.h"
+#include "enums.h"
+#include "game_constants.h"
 #include "item.h"
 #include "map.h"
 #include "vehicle.h"
 #include "vehicle_part.h"
 #include "veh_type.h"
 #include "vpart_position.h"
+#include "weather.h"
+#include "weather_gen.h"
 
 namespace rot
 {
@@ -73,4 +86,206 @@ auto temperature_flag_for_part( const vehicle &veh, size_t part_index ) -> tempe
     return temperature_flag::TEMP_NORMAL;
 }
 
+auto clip_by_temperature_flag( units::temperature temperature,
+                               temperature_flag flag ) -> units::temperature
+{
+    switch( flag ) {
+        case temperature_flag::TEMP_NORMAL:
+            // Just use the temperature normally
+            return temperature;
+        case temperature_flag::TEMP_FRIDGE:
+            return std::min( temperature, temperatures::fridge );
+        case temperature_flag::TEMP_FREEZER:
+            return std::min( temperature, temperatures::freezer );
+        case temperature_flag::TEMP_HEATER:
+            return std::max( temperature, temperatures::normal );
+        case temperature_flag::TEMP_ROOT_CELLAR:
+            return temperatures::root_cellar;
+        default:
+            debugmsg( "Temperature flag enum not valid: %d.  Using current temperature.",
+                      static_cast<int>( flag ) );
+            break;
+    }
+    return temperature;
+}
+
+namespace
+{
+
+constexpr size_t num_temperature_flags = static_cast<size_t>( temperature_flag::TEMP_ROOT_CELLAR ) + 1;
+
+auto hour_of( const time_point &t ) -> int64_t
+{
+    return to_turns<int64_t>( t - calendar::turn_zero ) / to_turns<int64_t>( 1_hours );
+}
+
+auto start_of_hour( const int64_t hour ) -> time_point
+{
+    return calendar::turn_zero + time_duration::from_hours( hour );
+}
+
+/**
+ * Temperatures of one submap, one per hour, and running sums of the rot points at
+ * these temperatures. Each hour uses the temperature at its start for all of it.
+ */
+class temperature_timeline
+{
+    public:
+        temperature_timeline( const weather_generator &wgen, unsigned int seed,
+                              const tripoint_abs_ms &location, units::temperature local_mod ) :
+            wgen( wgen ), seed( seed ), location( location ), local_mod( local_mod ) {}
+
+        /** Rot points between @p from and @p to, with from < to. */
+        auto rot_points( temperature_flag flag, time_point from, time_point to ) -> double {
+            const int64_t from_hour = hour_of( from );
+            // The hour of the last turn, so a stretch ending on the hour doesn't sample the next one
+            const int64_t to_hour = hour_of( to - 1_turns );
+            cover( from_hour, to_hour );
+            const std::vector<double> &sums = rot_sums( flag );
+            const auto sum_before = [&]( int64_t hour ) {
+                return sums[hour - first_hour];
+            };
+            const auto points_at = [&]( int64_t hour ) {
+                return sum_before( hour + 1 ) - sum_before( hour );
+            };
+
+            if( from_hour == to_hour ) {
+                return points_at( from_hour ) * ( ( to - from ) / 1_hours );
+            }
+            return points_at( from_hour ) * ( ( start_of_hour( from_hour + 1 ) - from ) / 1_hours ) +
+                   sum_before( to_hour ) - sum_before( from_hour + 1 ) +
+                   points_at( to_hour ) * ( ( to - start_of_hour( to_hour ) ) / 1_hours );
+        }
+
+    private:
+        auto sample( int64_t hour ) const -> units::temperature {
+            // Use weather if above ground, use map temp if below
+            if( location.z() < 0 ) {
+                return temperatures::annual_average + local_mod;
+            }
+            return wgen.get_weather_temperature( location, start_of_hour( hour ), calendar::config,
+                                                 seed ) + local_mod;
+        }
+
+        /** Samples the hours from @p first to @p last, unless they already are. */
+        void cover( int64_t first, int64_t last ) {
+            if( temperatures.empty() ) {
+                first_hour = first;
+            }
+            if( first < first_hour ) {
+                std::vector<units::temperature> earlier;
+                earlier.reserve( first_hour - first + temperatures.size() );
+                for( int64_t hour = first; hour < first_hour; hour++ ) {
+                    earlier.push_back( sample( hour ) );
+                }
+                earlier.insert( earlier.end(), temperatures.begin(), temperatures.end() );
+                temperatures = std::move( earlier );
+                first_hour = first;
+                sums_for_flag = {};
+            }
+            const int64_t end = first_hour + static_cast<int64_t>( temperatures.size() );
+            if( last >= end ) {
+                for( int64_t hour = end; hour <= last; hour++ ) {
+                    temperatures.push_back( sample( hour ) );
+                }
+                sums_for_flag = {};
+            }
+        }
+
+        auto rot_sums( temperature_flag flag ) -> const std::vector<double> & {
+            std::vector<double> &sums = sums_for_flag[static_cast<size_t>( flag )];
+            if( sums.empty() ) {
+                sums.reserve( temperatures.size() + 1 );
+                double sum = 0.0;
+                sums.push_back( sum );
+                for( const units::temperature &temperature : temperatures ) {
+                    sum += get_hourly_rotpoints_at_temp( clip_by_temperature_flag( temperature, flag ) );
+                    sums.push_back( sum );
+                }
+            }
+            return sums;
+        }
+
+        const weather_generator &wgen;
+        const unsigned int seed;
+        const tripoint_abs_ms location;
+        const units::temperature local_mod;
+
+        int64_t first_hour = 0;
+        std::vector<units::temperature> temperatures;
+        /** Rot points before each hour, built for each flag on first use. */
+        std::array<std::vector<double>, num_temperature_flags> sums_for_flag;
+};
+
+// Timelines are cheap to recreate, so rather than tracking which are still used,
+// they are all dropped once there are too many.
+constexpr size_t max_temperature_timelines = 1024;
+// Each timeline covers at most this many hours, starting at a multiple of it. Longer
+// stretches are split over several timelines, so the size of the cache stays bounded
+// however long items were left alone.
+constexpr int64_t timeline_hours = 7 * 24;
+
+/** Submap, temperature modifier in millidegrees and the index of the span of hours. */
+using timeline_key = std::tuple<tripoint_abs_sm, int, int64_t>;
+
+struct temperature_timelines {
+    const weather_generator *wgen = nullptr;
+    unsigned int seed = 0;
+    std::map<timeline_key, temperature_timeline> timelines;
+};
+
+auto floor_div( const int64_t a, const int64_t b ) -> int64_t
+{
+    return a / b - ( a % b < 0 ? 1 : 0 );
+}
+
+auto get_temperature_timelines() -> temperature_timelines &
+{
+    static temperature_timelines cache;
+    return cache;
+}
+
+} // namespace
+
+auto rot_points_between( const weather_generator &wgen, unsigned int seed,
+                         const tripoint_abs_ms &location, units::temperature local_mod,
+                         temperature_flag flag, time_point from, time_point to ) -> double
+{
+    if( to <= from ) {
+        return 0.0;
+    }
+
+    temperature_timelines &cache = get_temperature_timelines();
+    if( cache.wgen != &wgen || cache.seed != seed ) {
+        cache.timelines.clear();
+        cache.wgen = &wgen;
+        cache.seed = seed;
+    }
+
+    const tripoint_abs_sm submap = project_to<coords::sm>( location );
+    const int mod = units::to_millidegree_celsius( local_mod );
+    double points = 0.0;
+    time_point start = from;
+    for( int64_t span = floor_div( hour_of( from ), timeline_hours ); start < to; span++ ) {
+        const time_point span_end = std::min( to, start_of_hour( ( span + 1 ) * timeline_hours ) );
+        const timeline_key key( submap, mod, span );
+        auto iter = cache.timelines.find( key );
+        if( iter == cache.timelines.end() ) {
+            if( cache.timelines.size() >= max_temperature_timelines ) {
+                cache.timelines.clear();
+            }
+            iter = cache.timelines.emplace( std::piecewise_construct, std::forward_as_tuple( key ),
+                                            std::forward_as_tuple( wgen, seed, project_to<coords::ms>( submap ), local_mod ) ).first;
+        }
+        points += iter->second.rot_points( flag, start, span_end );
+        start = span_end;
+    }
+    return points;
+}
+
+void clear_temperature_timelines()
+{
+    get_temperature_timelines().timelines.clear();
+}
+
 } // namespace rot
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "calendar.h"
+#include "coordinates.h"
+#include "units_temperature.h"
+
 enum class temperature_flag : int;
 
 class map;
 class item;
+class weather_generator;
 
 namespace rot
 {
@@ -11,6 +16,23 @@ namespace rot
 // TODO: Move to item_location method?
 auto temperature_flag_for_location( const map &m, const item &loc ) -> temperature_flag;
 
-} // namespace rot
+/** The temperature an item stored according to @p flag is kept at. */
+auto clip_by_temperature_flag( units::temperature temperature,
+                               temperature_flag flag ) -> units::temperature;
+
+/**
+ * Hourly rot points integrated over the time between @p from and @p to, for catching up
+ * on rot of items that were outside of the reality bubble. The outdoor temperature of each
+ * hour is sampled once per submap and kept, so all items of a submap share the samples.
+ * @param location Where the item is, only its submap matters.
+ * @param local_mod Temperature modifier of that submap.
+ */
+auto rot_points_between( const weather_generator &wgen, unsigned int seed,
+                         const tripoint_abs_ms &location, units::temperature local_mod,
+                         temperature_flag flag, time_point from, time_point to ) -> double;
 
+/** Forgets all sampled temperatures. */
+void clear_temperature_timelines();
+
+} // namespace rot
 
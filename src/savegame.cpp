@@ -134,17 +134,32 @@ std::string scent_map::serialize( bool is_type ) const
     } else {
         int rle_lastval = -1;
         int rle_count = 0;
-        for( auto &elem : grscent ) {
-            for( auto &val : elem ) {
-                if( val == rle_lastval ) {
-                    rle_count++;
-                } else {
+        for( size_t i = 0; i < grscent.size(); ++i ) {
+            if( !active_layers[i] ) {
+                // Inactive layers are all zero, add them to the run without looking at them
+                if( rle_lastval != 0 ) {
                     if( rle_count ) {
                         rle_out << rle_count << " ";
                     }
-                    rle_out << val << " ";
-                    rle_lastval = val;
-                    rle_count = 1;
+                    rle_out << 0 << " ";
+                    rle_lastval = 0;
+                    rle_count = 0;
+                }
+                rle_count += MAPSIZE_X * MAPSIZE_Y;
+                continue;
+            }
+            for( auto &elem : grscent[i] ) {
+                for( auto &val : elem ) {
+                    if( val == rle_lastval ) {
+                        rle_count++;
+                    } else {
+                        if( rle_count ) {
+                            rle_out << rle_count << " ";
+                        }
+                        rle_out << val << " ";
+                        rle_lastval = val;
+                        rle_count = 1;
+                    }
                 }
             }
         }
@@ -288,15 +303,37 @@ void scent_map::deserialize( const std::string &data, bool is_type )
         buffer >> str;
         typescent = scenttype_id( str );
     } else {
+        std::vector<std::pair<int, int>> runs;
+        size_t total = 0;
         int stmp = 0;
         int count = 0;
-        for( auto &elem : grscent ) {
-            for( auto &val : elem ) {
-                if( count == 0 ) {
-                    buffer >> stmp >> count;
+        while( buffer >> stmp >> count ) {
+            runs.emplace_back( stmp, count );
+            total += count;
+        }
+        reset();
+        // Saves from before scent spread between z-levels only have the player's level
+        const bool single_level = total == static_cast<size_t>( MAPSIZE_X * MAPSIZE_Y );
+        auto run = runs.begin();
+        count = 0;
+        for( size_t i = 0; i < grscent.size(); ++i ) {
+            if( single_level && &grscent[i] != &layer( gm.get_levz() ) ) {
+                continue;
+            }
+            for( auto &elem : grscent[i] ) {
+                for( auto &val : elem ) {
+                    if( count == 0 ) {
+                        if( run == runs.end() ) {
+                            return;
+                        }
+                        stmp = run->first;
+                        count = run->second;
+                        ++run;
+                    }
+                    count--;
+                    val = stmp;
+                    active_layers[i] = active_layers[i] || val != 0;
                 }
-                count--;
-                val = stmp;
             }
         }
     }
@@ -818,7 +855,7 @@ struct mongroup_bin_eq {
                a.interest == b.interest &&
                a.dying == b.dying &&
                a.horde == b.horde &&
-               a.horde_behaviour == b.horde_behaviour &&
+               a.behaviour == b.behaviour &&
                a.diffuse == b.diffuse;
     }
 };
@@ -833,7 +870,7 @@ struct mongroup_hash {
         cata::hash_combine( ret, mg.interest );
         cata::hash_combine( ret, mg.dying );
         cata::hash_combine( ret, mg.horde );
-        cata::hash_combine( ret, mg.horde_behaviour );
+        cata::hash_combine( ret, mg.behaviour );
         cata::hash_combine( ret, mg.diffuse );
         return ret;
     }
@@ -1060,6 +1097,16 @@ void overmap::serialize( std::ostream &fout ) const
 
 ////////////////////////////////////////////////////////////////////////////////////////
 ///// mongroup
+// Hand-edited or mod-made saves may have behaviours the game doesn't know, those hordes pick a new one
+static horde_behaviour horde_behaviour_from_string( const std::string &name )
+{
+    if( !io::enum_is_valid<horde_behaviour>( name ) ) {
+        debugmsg( "Unknown horde behaviour \"%s\", ignoring it", name );
+        return horde_behaviour::none;
+    }
+    return io::string_to_enum<horde_behaviour>( name );
+}
+
 template<typename Archive>
 void mongroup::io( Archive &archive )
 {
@@ -1074,7 +1121,10 @@ void mongroup::io( Archive &archive )
     archive.io( "target", target, tripoint_om_sm() );
     archive.io( "nemesis_target", nemesis_target, tripoint_abs_sm() );
     archive.io( "interest", interest, 0 );
-    archive.io( "horde_behaviour", horde_behaviour, io::empty_default_tag() );
+    // Saved as its name, hordes that haven't picked one yet have an empty string
+    std::string behaviour_name = io::enum_to_string( behaviour );
+    archive.io( "horde_behaviour", behaviour_name, io::empty_default_tag() );
+    behaviour = horde_behaviour_from_string( behaviour_name );
     archive.io( "monsters", monsters, io::empty_default_tag() );
 }
 
@@ -1120,7 +1170,7 @@ void mongroup::deserialize_legacy( JsonIn &json )
         } else if( name == "interest" ) {
             interest = json.get_int();
         } else if( name == "horde_behaviour" ) {
-            horde_behaviour = json.get_string();
+            behaviour = horde_behaviour_from_string( json.get_string() );
         } else if( name == "monsters" ) {
             json.start_array();
             while( !json.end_array() ) {
@@ -1279,7 +1329,7 @@ void faction_manager::deserialize( JsonIn &jsin )
 void Creature_tracker::deserialize( JsonIn &jsin )
 {
     monsters_list.clear();
-    monsters_by_location.clear();
+    clear_locations();
     jsin.start_array();
     while( !jsin.end_array() ) {
         // TODO: would be nice if monster had a constructor using JsonIn or similar, so this could be one statement.
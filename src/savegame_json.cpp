@@ -3404,7 +3404,28 @@ struct mm_elem {
     }
 };
 
-void mm_submap::serialize( JsonOut &jsout ) const
+struct mm_name_table {
+    std::vector<memorized_tile_name> names;
+    std::unordered_map<uint32_t, int> indices;
+
+    int index_of( const memorized_tile_name &name ) {
+        const auto [iter, inserted] = indices.emplace( name.to_i(), static_cast<int>( names.size() ) );
+        if( inserted ) {
+            names.push_back( name );
+        }
+        return iter->second;
+    }
+
+    const memorized_tile_name &operator[]( const int index ) const {
+        if( index < 0 || static_cast<size_t>( index ) >= names.size() ) {
+            throw JsonError( string_format( "memorized tile name %d is missing from the name table",
+                                            index ) );
+        }
+        return names[index];
+    }
+};
+
+void mm_submap::serialize( JsonOut &jsout, mm_name_table &names ) const
 {
     jsout.start_array();
 
@@ -3414,15 +3435,11 @@ void mm_submap::serialize( JsonOut &jsout ) const
     int num_same = 1;
 
     const auto write_seq = [&]() {
-        jsout.start_array();
-        jsout.write( last.tile.tile );
+        jsout.write( names.index_of( last.tile.tile ) );
         jsout.write( last.tile.subtile );
         jsout.write( last.tile.rotation );
         jsout.write( last.symbol );
-        if( num_same != 1 ) {
-            jsout.write( num_same );
-        }
-        jsout.end_array();
+        jsout.write( num_same );
     };
 
     for( size_t y = 0; y < SEEY; y++ ) {
@@ -3447,7 +3464,7 @@ void mm_submap::serialize( JsonOut &jsout ) const
     jsout.end_array();
 }
 
-void mm_submap::deserialize( JsonIn &jsin )
+void mm_submap::deserialize( JsonIn &jsin, const mm_name_table *names )
 {
     jsin.start_array();
 
@@ -3460,9 +3477,15 @@ void mm_submap::deserialize( JsonIn &jsin )
         for( size_t x = 0; x < SEEX; x++ ) {
             if( remaining > 0 ) {
                 remaining -= 1;
+            } else if( names ) {
+                elem.tile.tile = ( *names )[jsin.get_int()];
+                elem.tile.subtile = jsin.get_int();
+                elem.tile.rotation = jsin.get_int();
+                elem.symbol = jsin.get_int();
+                remaining = jsin.get_int() - 1;
             } else {
                 jsin.start_array();
-                elem.tile.tile = jsin.get_string();
+                elem.tile.tile = memorized_tile_name( jsin.get_string() );
                 elem.tile.subtile = jsin.get_int();
                 elem.tile.rotation = jsin.get_int();
                 elem.symbol = jsin.get_int();
@@ -3486,6 +3509,29 @@ void mm_submap::deserialize( JsonIn &jsin )
 
 void mm_region::serialize( JsonOut &jsout ) const
 {
+    // Collect the names first, so they can be read before the submaps
+    mm_name_table names;
+    for( const auto &column : submaps ) {
+        for( const shared_ptr_fast<mm_submap> &sm : column ) {
+            if( sm->is_empty() ) {
+                continue;
+            }
+            for( int y = 0; y < SEEY; y++ ) {
+                for( int x = 0; x < SEEX; x++ ) {
+                    names.index_of( sm->tile( point( x, y ) ).tile );
+                }
+            }
+        }
+    }
+
+    jsout.start_object();
+    jsout.member( "names" );
+    jsout.start_array();
+    for( const memorized_tile_name &name : names.names ) {
+        jsout.write( name.str() );
+    }
+    jsout.end_array();
+    jsout.member( "submaps" );
     jsout.start_array();
     // NOLINTNEXTLINE(modernize-loop-convert): leaving as is for readability
     for( size_t y = 0; y < MM_REG_SIZE; y++ ) {
@@ -3495,15 +3541,32 @@ void mm_region::serialize( JsonOut &jsout ) const
             if( sm->is_empty() ) {
                 jsout.write_null();
             } else {
-                sm->serialize( jsout );
+                sm->serialize( jsout, names );
             }
         }
     }
     jsout.end_array();
+    jsout.end_object();
 }
 
 void mm_region::deserialize( JsonIn &jsin )
 {
+    // Regions saved before the name table was added are a plain array of submaps
+    const bool legacy = jsin.test_array();
+    mm_name_table names;
+    if( !legacy ) {
+        jsin.start_object();
+        if( jsin.get_member_name() != "names" ) {
+            jsin.error( "expected the names of the memorized tiles first" );
+        }
+        jsin.start_array();
+        while( !jsin.end_array() ) {
+            names.names.emplace_back( jsin.get_string() );
+        }
+        if( jsin.get_member_name() != "submaps" ) {
+            jsin.error( "expected memorized submaps" );
+        }
+    }
     jsin.start_array();
     // NOLINTNEXTLINE(modernize-loop-convert): leaving as is for readability
     for( size_t y = 0; y < MM_REG_SIZE; y++ ) {
@@ -3514,11 +3577,14 @@ void mm_region::deserialize( JsonIn &jsin )
             if( jsin.test_null() ) {
                 jsin.skip_null();
             } else {
-                sm->deserialize( jsin );
+                sm->deserialize( jsin, legacy ? nullptr : &names );
             }
         }
     }
     jsin.end_array();
+    if( !legacy ) {
+        jsin.end_object();
+    }
 }
 
 void map_memory::load_legacy( JsonIn &jsin )
@@ -3538,7 +3604,7 @@ void map_memory::load_legacy( JsonIn &jsin )
         p.y = jsin.get_int();
         p.z = jsin.get_int();
         mig_elem &elem = elems[p];
-        elem.tile.tile = jsin.get_string();
+        elem.tile.tile = memorized_tile_name( jsin.get_string() );
         elem.tile.subtile = jsin.get_int();
         elem.tile.rotation = jsin.get_int();
         jsin.end_array();
@@ -3909,20 +3975,6 @@ void submap::store( JsonOut &jsout ) const
     }
     jsout.end_array();
 
-    jsout.member( "items" );
-    jsout.start_array();
-    for( int j = 0; j < SEEY; j++ ) {
-        for( int i = 0; i < SEEX; i++ ) {
-            if( itm[i][j].empty() ) {
-                continue;
-            }
-            jsout.write( i );
-            jsout.write( j );
-            jsout.write( itm[i][j] );
-        }
-    }
-    jsout.end_array();
-
     jsout.member( "traps" );
     jsout.start_array();
     for( int j = 0; j < SEEY; j++ ) {
@@ -3941,6 +3993,25 @@ void submap::store( JsonOut &jsout ) const
     }
     jsout.end_array();
 
+    store_contents( jsout );
+}
+
+void submap::store_contents( JsonOut &jsout ) const
+{
+    jsout.member( "items" );
+    jsout.start_array();
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            if( itm[i][j].empty() ) {
+                continue;
+            }
+            jsout.write( i );
+            jsout.write( j );
+            jsout.write( itm[i][j] );
+        }
+    }
+    jsout.end_array();
+
     jsout.member( "fields" );
     jsout.start_array();
     for( int j = 0; j < SEEY; j++ ) {
@@ -4172,7 +4243,9 @@ void submap::load( JsonIn &jsin, const std::string &member_name, int version,
                 if( fld[i][j].find_field( ft ) == nullptr ) {
                     field_count++;
                 }
-                fld[i][j].add_field( ft, intensity, time_duration::from_turns( age ) );
+                if( fld[i][j].add_field( ft, intensity, time_duration::from_turns( age ) ) ) {
+                    field_tiles.mark( { i, j } );
+                }
             }
         }
     } else if( member_name == "graffiti" ) {
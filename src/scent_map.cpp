@@ -17,6 +17,8 @@
 #include "string_id.h"
 
 static constexpr int SCENT_RADIUS = 40;
+/** Scent spreads on this many z-levels above and below the player. */
+static constexpr int SCENT_Z_RADIUS = 2;
 
 static nc_color sev( const size_t level )
 {
@@ -50,20 +52,31 @@ static nc_color sev( const size_t level )
 
 void scent_map::reset()
 {
-    for( auto &elem : grscent ) {
-        for( auto &val : elem ) {
-            val = 0;
+    for( auto &level : grscent ) {
+        for( auto &elem : level ) {
+            for( auto &val : elem ) {
+                val = 0;
+            }
         }
     }
+    active_layers.fill( false );
     typescent = scenttype_id();
 }
 
 void scent_map::decay()
 {
-    for( auto &elem : grscent ) {
-        for( auto &val : elem ) {
-            val = std::max( 0, val - 1 );
+    for( size_t i = 0; i < grscent.size(); ++i ) {
+        if( !active_layers[i] ) {
+            continue;
+        }
+        int remaining = 0;
+        for( auto &elem : grscent[i] ) {
+            for( auto &val : elem ) {
+                val = std::max( 0, val - 1 );
+                remaining |= val;
+            }
         }
+        active_layers[i] = remaining != 0;
     }
 }
 
@@ -82,18 +95,24 @@ void scent_map::draw( const catacurses::window &win, const int div, const tripoi
 void scent_map::shift( point sm_shift )
 {
     scent_array<int> new_scent;
-    for( size_t x = 0; x < MAPSIZE_X; ++x ) {
-        for( size_t y = 0; y < MAPSIZE_Y; ++y ) {
-            const point p = point( x, y ) + sm_shift;
-            new_scent[x][y] = inbounds( p ) ? grscent[ p.x ][ p.y ] : 0;
+    for( size_t i = 0; i < grscent.size(); ++i ) {
+        if( !active_layers[i] ) {
+            continue;
         }
+        scent_array<int> &level = grscent[i];
+        for( size_t x = 0; x < MAPSIZE_X; ++x ) {
+            for( size_t y = 0; y < MAPSIZE_Y; ++y ) {
+                const point p = point( x, y ) + sm_shift;
+                new_scent[x][y] = inbounds( p ) ? level[ p.x ][ p.y ] : 0;
+            }
+        }
+        level = new_scent;
     }
-    grscent = new_scent;
 }
 
 int scent_map::get( const tripoint &p ) const
 {
-    if( inbounds( p ) && grscent[p.x][p.y] > 0 ) {
+    if( inbounds( p ) && layer( p.z )[p.x][p.y] > 0 ) {
         return get_unsafe( p );
     }
     return 0;
@@ -108,20 +127,23 @@ void scent_map::set( const tripoint &p, int value, const scenttype_id &type )
 
 void scent_map::set_unsafe( const tripoint &p, int value, const scenttype_id &type )
 {
-    grscent[p.x][p.y] = value;
+    layer( p.z )[p.x][p.y] = value;
+    if( value != 0 ) {
+        set_active( p.z );
+    }
     if( !type.is_empty() ) {
         typescent = type;
     }
 }
 int scent_map::get_unsafe( const tripoint &p ) const
 {
-    return grscent[p.x][p.y] - std::abs( gm.get_levz() - p.z );
+    return layer( p.z )[p.x][p.y];
 }
 
 scenttype_id scent_map::get_type( const tripoint &p ) const
 {
     scenttype_id id;
-    if( inbounds( p ) && grscent[p.x][p.y] > 0 ) {
+    if( inbounds( p ) && layer( p.z )[p.x][p.y] > 0 ) {
         id = typescent;
     }
     return id;
@@ -129,24 +151,29 @@ scenttype_id scent_map::get_type( const tripoint &p ) const
 
 bool scent_map::inbounds( const tripoint &p ) const
 {
-    // HACK: This weird long check here is a hack around the fact that scentmap is 2D
-    // A z-level can access scentmap if it is within SCENT_MAP_Z_REACH flying z-level move from player's z-level
-    // That is, if a flying critter could move directly up or down (or stand still) and be on same z-level as player
-    const int levz = gm.get_levz();
-    const bool scent_map_z_level_inbounds = ( p.z == levz ) ||
-                                            ( std::abs( p.z - levz ) == SCENT_MAP_Z_REACH &&
-                                                    get_map().valid_move( p, tripoint( p.xy(), levz ), false, true ) );
-    if( !scent_map_z_level_inbounds ) {
-        return false;
-    }
-    static constexpr point scent_map_boundary_min{};
-    static constexpr point scent_map_boundary_max( MAPSIZE_X, MAPSIZE_Y );
+    static constexpr tripoint scent_map_boundary_min( 0, 0, -OVERMAP_DEPTH );
+    static constexpr tripoint scent_map_boundary_max( MAPSIZE_X, MAPSIZE_Y, OVERMAP_HEIGHT + 1 );
 
-    static constexpr half_open_rectangle<point> scent_map_boundaries(
+    static constexpr half_open_cuboid<tripoint> scent_map_boundaries(
         scent_map_boundary_min, scent_map_boundary_max );
 
-    return scent_map_boundaries.contains( p.xy() );
+    return scent_map_boundaries.contains( p );
 }
+
+// Whether any tile of @p level in the given rectangle has scent on it
+template<typename Layer>
+static bool has_scent_in( const Layer &level, point min, point max )
+{
+    int any = 0;
+    for( int x = min.x; x <= max.x; ++x ) {
+        const int *scent = &level[x][min.y];
+        for( int y = 0; y <= max.y - min.y; ++y ) {
+            any |= scent[y];
+        }
+    }
+    return any != 0;
+}
+
 void scent_map::update( const tripoint &center, map &m )
 {
     // Stop updating scent after X turns of the player not moving.
@@ -158,93 +185,151 @@ void scent_map::update( const tripoint &center, map &m )
         return;
     }
 
-    //the block and reduce scent properties are folded into a single scent_transfer value here
-    //block=0 reduce=1 normal=5
-    scent_array<char> scent_transfer;
-
-    std::array < std::array < int, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > new_scent;
-    std::array < std::array < int, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > sum_3_scent_y;
-    std::array < std::array < char, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > squares_used_y;
-
-    diagonal_blocks( &blocked_cache )[MAPSIZE_X][MAPSIZE_Y] = m.access_cache(
-                center.z ).vehicle_obstructed_cache;
-
     // for loop constants
     const int scentmap_minx = center.x - SCENT_RADIUS;
     const int scentmap_maxx = center.x + SCENT_RADIUS;
     const int scentmap_miny = center.y - SCENT_RADIUS;
     const int scentmap_maxy = center.y + SCENT_RADIUS;
+    const point border_min( scentmap_minx - 1, scentmap_miny - 1 );
+    const point border_max( scentmap_maxx + 1, scentmap_maxy + 1 );
 
-    // The new scent flag searching function. Should be wayyy faster than the old one.
-    m.scent_blockers( scent_transfer, point( scentmap_minx - 1, scentmap_miny - 1 ),
-                      point( scentmap_maxx + 1, scentmap_maxy + 1 ) );
+    // Without z-levels the other levels aren't loaded, so scent stays on the player's level
+    const int zmin = m.has_zlevels() ? std::max( center.z - SCENT_Z_RADIUS, -OVERMAP_DEPTH ) : center.z;
+    const int zmax = m.has_zlevels() ? std::min( center.z + SCENT_Z_RADIUS, OVERMAP_HEIGHT ) : center.z;
 
-    for( int x = 0; x < SCENT_RADIUS * 2 + 3; ++x ) {
-        sum_3_scent_y[0][x] = 0;
-        squares_used_y[0][x] = 0;
-        sum_3_scent_y[SCENT_RADIUS * 2][x] = 0;
-        squares_used_y[SCENT_RADIUS * 2][x] = 0;
+    // Diffusing a level without scent leaves it without scent, so those are skipped
+    std::array<bool, SCENT_Z_RADIUS * 2 + 1> scented;
+    for( int z = zmin; z <= zmax; ++z ) {
+        scented[z - zmin] = has_scent_in( layer( z ), border_min, border_max );
     }
 
-    for( int x = 0; x < SCENT_RADIUS * 2 + 3; ++x ) {
-        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
+    //the block and reduce scent properties are folded into a single scent_transfer value here
+    //block=0 reduce=1 normal=5
+    std::array<scent_array<char>, SCENT_Z_RADIUS * 2 + 1> scent_transfer;
+    // Scent only moves between levels next to one with scent, their blockers are needed too
+    const auto needs_transfer = [&]( int z ) {
+        return scented[z - zmin] || ( z > zmin && scented[z - zmin - 1] ) ||
+               ( z < zmax && scented[z - zmin + 1] );
+    };
+    for( int z = zmin; z <= zmax; ++z ) {
+        if( needs_transfer( z ) ) {
+            // The new scent flag searching function. Should be wayyy faster than the old one.
+            m.scent_blockers( scent_transfer[z - zmin], border_min, border_max, z );
+        }
+    }
 
-            point abs( x + scentmap_minx - 1, y + scentmap_miny );
+    for( int z = zmin; z <= zmax; ++z ) {
+        if( scented[z - zmin] ) {
+            diffuse( center, z, m, scent_transfer[z - zmin] );
+        }
+    }
 
-            // remember the sum of the scent val for the 3 neighboring squares that can defuse into
-            sum_3_scent_y[y][x] = 0;
-            squares_used_y[y][x] = 0;
-            for( int i = abs.y - 1; i <= abs.y + 1; ++i ) {
-                sum_3_scent_y[y][x] += scent_transfer[abs.x][i] * grscent[abs.x][i];
-                squares_used_y[y][x] += scent_transfer[abs.x][i];
+    // Between levels, the side with less scent gains a fifth of the difference where both tiles
+    // pass scent freely. Like lingering scent, the side it comes from doesn't lose any.
+    scent_array<char> scent_opening;
+    for( int z = zmin; z < zmax; ++z ) {
+        if( !scented[z - zmin] && !scented[z - zmin + 1] ) {
+            continue;
+        }
+        m.scent_openings( scent_opening, point( scentmap_minx, scentmap_miny ),
+                          point( scentmap_maxx, scentmap_maxy ), z );
+        set_active( z );
+        set_active( z + 1 );
+        scent_array<int> &below = layer( z );
+        scent_array<int> &above = layer( z + 1 );
+        const scent_array<char> &transfer_below = scent_transfer[z - zmin];
+        const scent_array<char> &transfer_above = scent_transfer[z - zmin + 1];
+        for( int x = scentmap_minx; x <= scentmap_maxx; ++x ) {
+            for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
+                const int transfer = scent_opening[x][y] *
+                                     std::min( transfer_below[x][y], transfer_above[x][y] );
+                const int up = std::max( below[x][y] - above[x][y], 0 );
+                const int down = std::max( above[x][y] - below[x][y], 0 );
+                above[x][y] += up * transfer / 25;
+                below[x][y] += down * transfer / 25;
             }
         }
     }
+}
+
+void scent_map::diffuse( const tripoint &center, const int z, map &m,
+                         const scent_array<char> &scent_transfer )
+{
+    scent_array<int> &grscent = layer( z );
+    diagonal_blocks( &blocked_cache )[MAPSIZE_X][MAPSIZE_Y] = m.access_cache( z ).vehicle_obstructed_cache;
+
+    // for loop constants
+    const int scentmap_minx = center.x - SCENT_RADIUS;
+    const int scentmap_miny = center.y - SCENT_RADIUS;
 
-    for( int x = 1; x < SCENT_RADIUS * 2 + 2; ++x ) {
-        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
-            const point abs( x + scentmap_minx - 1, y + scentmap_miny );
+    // The scratch arrays are laid out like grscent, [x][y], so the inner loops below walk
+    // contiguous memory without branches and the compiler can vectorize them.
+    // Column x covers map column scentmap_minx - 1 + x, row y map row scentmap_miny + y.
+    static constexpr int window = SCENT_RADIUS * 2 + 1;
+    static constexpr int columns = window + 2;
+    using scent_column = std::array<int, window>;
+    std::array<scent_column, columns> sum_3_scent_y;
+    std::array<scent_column, columns> squares_used_y;
+    std::array<scent_column, columns> new_scent;
+
+    // remember the sum of the scent val for the 3 neighboring squares that can defuse into
+    for( int x = 0; x < columns; ++x ) {
+        const int abs_x = x + scentmap_minx - 1;
+        const char *transfer = &scent_transfer[abs_x][scentmap_miny - 1];
+        const int *scent = &grscent[abs_x][scentmap_miny - 1];
+        scent_column &sum = sum_3_scent_y[x];
+        scent_column &used = squares_used_y[x];
+        for( int y = 0; y < window; ++y ) {
+            sum[y] = transfer[y] * scent[y] + transfer[y + 1] * scent[y + 1] +
+                     transfer[y + 2] * scent[y + 2];
+            used[y] = transfer[y] + transfer[y + 1] + transfer[y + 2];
+        }
+    }
 
-            int squares_used = squares_used_y[y][x - 1] + squares_used_y[y][x] + squares_used_y[y][x + 1];
-            int total = sum_3_scent_y[y][x - 1] + sum_3_scent_y[y][x] + sum_3_scent_y[y][x + 1];
+    for( int x = 1; x < columns - 1; ++x ) {
+        const int abs_x = x + scentmap_minx - 1;
+        const char *transfer = &scent_transfer[abs_x][scentmap_miny];
+        const char *transfer_w = &scent_transfer[abs_x - 1][scentmap_miny];
+        const char *transfer_e = &scent_transfer[abs_x + 1][scentmap_miny];
+        const int *scent = &grscent[abs_x][scentmap_miny];
+        const int *scent_w = &grscent[abs_x - 1][scentmap_miny];
+        const int *scent_e = &grscent[abs_x + 1][scentmap_miny];
+        const diagonal_blocks *blocked = &blocked_cache[abs_x][scentmap_miny];
+        const diagonal_blocks *blocked_w = &blocked_cache[abs_x - 1][scentmap_miny];
+        const diagonal_blocks *blocked_e = &blocked_cache[abs_x + 1][scentmap_miny];
+        for( int y = 0; y < window; ++y ) {
+            int squares_used = squares_used_y[x - 1][y] + squares_used_y[x][y] +
+                               squares_used_y[x + 1][y];
+            int total = sum_3_scent_y[x - 1][y] + sum_3_scent_y[x][y] + sum_3_scent_y[x + 1][y];
 
             //handle vehicle holes
-            if( blocked_cache[abs.x][abs.y].nw && scent_transfer[abs.x + 1][abs.y + 1] == 5 ) {
-                squares_used -= 4;
-                total -= 4 * grscent[abs.x + 1][abs.y + 1];
-            }
-            if( blocked_cache[abs.x][abs.y].ne && scent_transfer[abs.x - 1][abs.y + 1] == 5 ) {
-                squares_used -= 4;
-                total -= 4 * grscent[abs.x - 1][abs.y + 1];
-            }
-            if( blocked_cache[abs.x - 1][abs.y - 1].nw && scent_transfer[abs.x - 1][abs.y - 1] == 5 ) {
-                squares_used -= 4;
-                total -= 4 * grscent[abs.x - 1][abs.y - 1];
-            }
-            if( blocked_cache[abs.x + 1][abs.y - 1].ne && scent_transfer[abs.x + 1][abs.y - 1] == 5 ) {
-                squares_used -= 4;
-                total -= 4 * grscent[abs.x + 1][abs.y - 1];
-            }
+            const int hole_se = blocked[y].nw && transfer_e[y + 1] == 5;
+            const int hole_sw = blocked[y].ne && transfer_w[y + 1] == 5;
+            const int hole_nw = blocked_w[y - 1].nw && transfer_w[y - 1] == 5;
+            const int hole_ne = blocked_e[y - 1].ne && transfer_e[y - 1] == 5;
+            squares_used -= 4 * ( hole_se + hole_sw + hole_nw + hole_ne );
+            total -= 4 * ( hole_se * scent_e[y + 1] + hole_sw * scent_w[y + 1] +
+                           hole_nw * scent_w[y - 1] + hole_ne * scent_e[y - 1] );
 
             //Lingering scent
-            int temp_scent =  grscent[abs.x][abs.y] * ( 250 - squares_used  *
-                              scent_transfer[abs.x][abs.y] ) ;
-            temp_scent -=  grscent[abs.x][abs.y] * scent_transfer[abs.x][abs.y] *
-                           ( 45 - squares_used ) / 5;
-
-            new_scent[y][x] = ( temp_scent + total * scent_transfer[abs.x][abs.y] ) / 250;
+            const int scent_here = scent[y];
+            const int transfer_here = transfer[y];
+            int temp_scent = scent_here * ( 250 - squares_used * transfer_here );
+            temp_scent -= scent_here * transfer_here * ( 45 - squares_used ) / 5;
 
+            new_scent[x][y] = ( temp_scent + total * transfer_here ) / 250;
         }
     }
-    for( int x = 1; x < SCENT_RADIUS * 2 + 2; ++x ) {
-        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
-            // Don't spread scent into water unless the source is in water.
-            // Keep scent trails in the water when we exit until rain disturbs them.
-            if( ( get_map().has_flag( TFLAG_LIQUID, center ) &&
-                  rl_dist( center, tripoint( point( x + scentmap_minx - 1, y + scentmap_miny ),
-                                             g->get_levz() ) ) <= 8 ) ||
-                !get_map().has_flag( TFLAG_LIQUID, point( x + scentmap_minx - 1, y + scentmap_miny ) ) ) {
-                grscent[x + scentmap_minx - 1 ][y + scentmap_miny] = new_scent[y][x];
+
+    // Don't spread scent into water unless the source is in water.
+    // Keep scent trails in the water when we exit until rain disturbs them.
+    const bool center_in_liquid = z == center.z && m.has_flag( TFLAG_LIQUID, center );
+    for( int x = 1; x < columns - 1; ++x ) {
+        for( int y = 0; y < window; ++y ) {
+            const tripoint abs( x + scentmap_minx - 1, y + scentmap_miny, z );
+            if( ( center_in_liquid && rl_dist( center, abs ) <= 8 ) ||
+                !m.has_flag( TFLAG_LIQUID, abs ) ) {
+                grscent[abs.x][abs.y] = new_scent[x][y];
             }
         }
     }
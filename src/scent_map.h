@@ -12,6 +12,7 @@
 #include "point.h"
 #include "type_id.h"
 
+/** How many z-levels up or down a monster following scent looks for a stronger one. */
 static constexpr int SCENT_MAP_Z_REACH = 1;
 
 class game;
@@ -43,13 +44,32 @@ class scent_map
         template<typename T>
         using scent_array = std::array<std::array<T, MAPSIZE_Y>, MAPSIZE_X>;
 
-        scent_array<int> grscent;
+        /** One layer per z-level, from -OVERMAP_DEPTH up. */
+        std::array<scent_array<int>, OVERMAP_LAYERS> grscent;
+        /**
+         * Whether a layer of @ref grscent may have scent on it. Layers that aren't active
+         * are all zero, so decaying, shifting and saving them is skipped.
+         */
+        std::array<bool, OVERMAP_LAYERS> active_layers = {};
         scenttype_id typescent;
         std::optional<tripoint> player_last_position;
         time_point player_last_moved = calendar::before_time_starts;
 
         const game &gm;
 
+        scent_array<int> &layer( int z ) {
+            return grscent[z + OVERMAP_DEPTH];
+        }
+        const scent_array<int> &layer( int z ) const {
+            return grscent[z + OVERMAP_DEPTH];
+        }
+        void set_active( int z ) {
+            active_layers[z + OVERMAP_DEPTH] = true;
+        }
+
+        /** Spreads scent around @p center on z-level @p z, one turn worth. */
+        void diffuse( const tripoint &center, int z, map &m, const scent_array<char> &scent_transfer );
+
     public:
         scent_map( const game &g ) : gm( g ) { }
 
@@ -58,6 +78,10 @@ class scent_map
 
         void draw( const catacurses::window &win, int div, const tripoint &center ) const;
 
+        /**
+         * Spreads scent around @p center on its z-level and the ones next to it,
+         * and between z-levels through stairs and open air.
+         */
         void update( const tripoint &center, map &m );
         void reset();
         void decay();
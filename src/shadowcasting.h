@@ -2,9 +2,16 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <functional>
 #include <string>
+#include <type_traits>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "cached_options.h"
 #include "game_constants.h"
 #include "lightmap.h"
 
@@ -108,6 +115,49 @@ inline float sight_from_lookup( const float &numerator, const float &transparenc
     return numerator * transparency;
 }
 
+// Hoisted to header so the test in tests/shadowcasting_test.cpp can compare it with and without SSE2.
+// Length of the run of values equal to `value`, starting at `values` and going `stride` elements
+//   at a time, looking at no more than `max_count` values.
+template<typename T>
+inline int shadowcasting_run_length( const T *values, const int stride, const int max_count,
+        const T &value )
+{
+    int count = 0;
+#if defined(__SSE2__)
+    if constexpr( std::is_same_v<T, float> ) {
+        if( simd_shadowcasting ) {
+            // Rows that run along the inner dimension of the cache are contiguous, compare 4 at a time
+            const __m128 wanted = _mm_set1_ps( value );
+            if( stride == 1 ) {
+                for( ; count + 4 <= max_count; count += 4 ) {
+                    const int equal = _mm_movemask_ps( _mm_cmpeq_ps( _mm_loadu_ps( values + count ), wanted ) );
+                    if( equal != 0xF ) {
+                        // Lowest clear bit is the first value that differs
+                        return count + std::countr_one( static_cast<unsigned int>( equal ) );
+                    }
+                }
+            } else if( stride == -1 ) {
+                for( ; count + 4 <= max_count; count += 4 ) {
+                    const int equal = _mm_movemask_ps( _mm_cmpeq_ps( _mm_loadu_ps( values - count - 3 ),
+                                                       wanted ) );
+                    if( equal != 0xF ) {
+                        // Values are loaded back to front, so the highest clear bit comes first
+                        return count + std::countl_one( static_cast<unsigned int>( equal << 28 ) );
+                    }
+                }
+            }
+        }
+    }
+#endif
+    for( ; count < max_count; count++ ) {
+        if( values[count * stride] != value ) {
+            break;
+        }
+    }
+    return count;
+}
+
+
 template<typename T, typename Out, T( *calc )( const T &, const T &, const int & ),
          bool( *check )( const T &, const T & ),
          void( *update_output )( Out &, const T &, quadrant ),
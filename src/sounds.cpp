@@ -15,6 +15,7 @@
 #include "coordinate_conversions.h"
 #include "character.h"
 #include "creature.h"
+#include "creature_tracker.h"
 #include "debug.h"
 #include "enums.h"
 #include "game.h"
@@ -357,12 +358,14 @@ void sounds::process_sounds()
             overmap_buffer.signal_hordes( target, sig_power );
         }
         // Alert all monsters (that can hear) to the sound.
-        for( monster &critter : g->all_monsters() ) {
+        // sound_distance is never below the horizontal distance or 5 times the vertical one
+        const int max_dist = vol * 2;
+        for( monster *critter : g->critter_tracker->find_in_radius( source, max_dist, max_dist / 5 ) ) {
             // TODO: Generalize this to Creature::hear_sound
-            const int dist = sound_distance( source, critter.pos() );
-            if( vol * 2 > dist ) {
+            const int dist = sound_distance( source, critter->pos() );
+            if( max_dist > dist ) {
                 // Exclude monsters that certainly won't hear the sound
-                critter.hear_sound( source, vol, dist );
+                critter->hear_sound( source, vol, dist );
             }
         }
     }
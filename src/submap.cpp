@@ -38,6 +38,7 @@ void submap::swap( submap &first, submap &second )
     std::swap( first.is_uniform, second.is_uniform );
     std::swap( first.active_items, second.active_items );
     std::swap( first.field_count, second.field_count );
+    std::swap( first.field_tiles, second.field_tiles );
     std::swap( first.last_touched, second.last_touched );
     std::swap( first.spawns, second.spawns );
     std::swap( first.vehicles, second.vehicles );
@@ -533,4 +534,21 @@ void submap::rotate( int turns )
         rot_active_furn.emplace( point_sm_ms( rotate_point( elem.first.raw() ) ), elem.second );
     }
     active_furniture = rot_active_furn;
+
+    rebuild_field_tiles();
+}
+
+void submap::rebuild_field_tiles()
+{
+    field_tiles.clear();
+    if( field_count == 0 ) {
+        return;
+    }
+    for( int x = 0; x < SEEX; x++ ) {
+        for( int y = 0; y < SEEY; y++ ) {
+            if( fld[x][y].displayed_field_type() ) {
+                field_tiles.mark( { x, y } );
+            }
+        }
+    }
 }
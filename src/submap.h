@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -23,7 +25,10 @@
 
 class JsonIn;
 class JsonOut;
+class binary_reader;
+class binary_writer;
 class map;
+struct submap_palette;
 struct trap;
 struct ter_t;
 struct furn_t;
@@ -66,6 +71,64 @@ struct spawn_point {
     }
 };
 
+/**
+ * Tiles of a submap that may hold fields, so field processing can skip the empty ones.
+ *
+ * Whatever puts a field on a tile marks it, tiles are only unmarked by field processing once
+ * it finds them empty. Tiles are numbered column by column, the order they are processed in.
+ */
+class field_tile_set
+{
+    public:
+        static constexpr int tile_count = SEEX * SEEY;
+
+        static int index( point p ) {
+            return p.x * SEEY + p.y;
+        }
+        static point tile( int index ) {
+            return point( index / SEEY, index % SEEY );
+        }
+
+        void mark( point p ) {
+            const int i = index( p );
+            bits[i / 64] |= uint64_t( 1 ) << ( i % 64 );
+        }
+        void unmark( point p ) {
+            const int i = index( p );
+            bits[i / 64] &= ~( uint64_t( 1 ) << ( i % 64 ) );
+        }
+        bool is_marked( point p ) const {
+            const int i = index( p );
+            return bits[i / 64] & ( uint64_t( 1 ) << ( i % 64 ) );
+        }
+        void clear() {
+            bits.fill( 0 );
+        }
+
+        /**
+         * Returns the index of the first marked tile at or after @p from, or -1 if there is none.
+         * Tiles marked ahead of a running iteration are still found by it.
+         */
+        int next( int from ) const {
+            if( from >= tile_count ) {
+                return -1;
+            }
+            int word = from / 64;
+            uint64_t rest = bits[word] & ( ~uint64_t( 0 ) << ( from % 64 ) );
+            while( rest == 0 ) {
+                if( ++word == word_count ) {
+                    return -1;
+                }
+                rest = bits[word];
+            }
+            return word * 64 + std::countr_zero( rest );
+        }
+
+    private:
+        static constexpr int word_count = ( tile_count + 63 ) / 64;
+        std::array<uint64_t, word_count> bits = {};
+};
+
 template<int sx, int sy>
 struct maptile_soa {
     protected:
@@ -213,10 +276,20 @@ class submap : maptile_soa<SEEX, SEEY>
         bool contains_vehicle( vehicle * );
 
         void rotate( int turns );
+        /** Marks exactly the tiles that hold fields in @ref field_tiles. */
+        void rebuild_field_tiles();
 
         void store( JsonOut &jsout ) const;
         void load( JsonIn &jsin, const std::string &member_name, int version, const tripoint offset );
 
+        /**
+         * Binary map format: the per-tile layers are stored as indices into @p palette,
+         * everything else is stored like in @ref store, as a length-prefixed JSON object.
+         */
+        void store_binary( binary_writer &out, submap_palette &palette ) const;
+        void load_binary( binary_reader &in, const submap_palette &palette, int version,
+                          const tripoint &offset );
+
         // If is_uniform is true, this submap is a solid block of terrain
         // Uniform submaps aren't saved/loaded, because regenerating them is faster
         bool is_uniform;
@@ -226,6 +299,7 @@ class submap : maptile_soa<SEEX, SEEY>
         active_item_cache active_items;
 
         int field_count = 0;
+        field_tile_set field_tiles;
         time_point last_touched = calendar::turn_zero;
         std::vector<spawn_point> spawns;
         /**
@@ -245,6 +319,8 @@ class submap : maptile_soa<SEEX, SEEY>
         int temperature = 0;
 
         void update_legacy_computer();
+        /** Everything but the per-tile layers, which the binary format stores on its own. */
+        void store_contents( JsonOut &jsout ) const;
 
         static constexpr size_t elements = SEEX * SEEY;
 };
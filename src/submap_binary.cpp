@@ -0,0 +1,220 @@
+#include "submap_binary.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "binary_io.h"
+#include "calendar.h"
+#include "coordinate_conversions.h"
+#include "game.h"
+#include "game_constants.h"
+#include "json.h"
+#include "mapdata.h"
+#include "string_id.h"
+#include "submap.h"
+#include "trap.h"
+
+static constexpr char quad_magic[4] = { 'B', 'N', 'S', 'M' };
+// Bump when the layout changes, older layouts have to stay readable
+static constexpr uint16_t quad_format_version = 1;
+
+template<typename T>
+uint16_t id_palette<T>::index_of( const int_id<T> &id )
+{
+    const auto [iter, inserted] = indices.emplace( id.to_i(), static_cast<uint16_t>( ids.size() ) );
+    if( inserted ) {
+        ids.push_back( id );
+    }
+    return iter->second;
+}
+
+template<typename T>
+const int_id<T> &id_palette<T>::operator[]( const uint16_t index ) const
+{
+    if( index >= ids.size() ) {
+        throw std::runtime_error( "binary submap refers to an id missing from its palette" );
+    }
+    return ids[index];
+}
+
+template<typename T>
+void id_palette<T>::write( binary_writer &out ) const
+{
+    out.write<uint16_t>( ids.size() );
+    for( const int_id<T> &id : ids ) {
+        out.write_string( id.id().str() );
+    }
+}
+
+template<typename T>
+void id_palette<T>::read( binary_reader &in )
+{
+    const uint16_t count = in.read<uint16_t>();
+    ids.clear();
+    ids.reserve( count );
+    for( uint16_t i = 0; i < count; i++ ) {
+        ids.push_back( string_id<T>( in.read_string() ).id() );
+    }
+}
+
+template class id_palette<ter_t>;
+template class id_palette<furn_t>;
+template class id_palette<trap>;
+
+// Tiles are laid out row by row, like in the JSON format
+using tile_values = std::array<uint16_t, SEEX * SEEY>;
+using radiation_values = std::array<int32_t, SEEX * SEEY>;
+
+template<typename T>
+static void write_runs( binary_writer &out, const std::array<T, SEEX * SEEY> &values )
+{
+    for( size_t i = 0; i < values.size(); ) {
+        size_t run = 1;
+        while( i + run < values.size() && values[i + run] == values[i] ) {
+            run++;
+        }
+        out.write<T>( values[i] );
+        out.write<uint16_t>( run );
+        i += run;
+    }
+}
+
+template<typename T>
+static std::array<T, SEEX * SEEY> read_runs( binary_reader &in )
+{
+    std::array<T, SEEX * SEEY> values;
+    for( size_t i = 0; i < values.size(); ) {
+        const T value = in.read<T>();
+        const uint16_t run = in.read<uint16_t>();
+        if( run == 0 || run > values.size() - i ) {
+            throw std::runtime_error( "binary submap has a corrupt run length" );
+        }
+        std::fill_n( values.begin() + i, run, value );
+        i += run;
+    }
+    return values;
+}
+
+void submap::store_binary( binary_writer &out, submap_palette &palette ) const
+{
+    out.write<int64_t>( to_turns<int64_t>( last_touched - calendar::turn_zero ) );
+    out.write<int32_t>( temperature );
+
+    tile_values terrain;
+    tile_values furniture;
+    tile_values traps;
+    radiation_values radiation;
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const int cell = j * SEEX + i;
+            terrain[cell] = palette.ter.index_of( ter[i][j] );
+            furniture[cell] = palette.furn.index_of( frn[i][j] );
+            traps[cell] = palette.trp.index_of( trp[i][j] );
+            radiation[cell] = rad[i][j];
+        }
+    }
+    write_runs( out, terrain );
+    write_runs( out, furniture );
+    write_runs( out, traps );
+    write_runs( out, radiation );
+
+    std::ostringstream contents;
+    JsonOut jsout( contents );
+    jsout.start_object();
+    store_contents( jsout );
+    jsout.end_object();
+    out.write_string( contents.str() );
+}
+
+void submap::load_binary( binary_reader &in, const submap_palette &palette, int version,
+                          const tripoint &offset )
+{
+    last_touched = calendar::turn_zero + time_duration::from_turns( in.read<int64_t>() );
+    temperature = in.read<int32_t>();
+
+    const tile_values terrain = read_runs<uint16_t>( in );
+    const tile_values furniture = read_runs<uint16_t>( in );
+    const tile_values traps = read_runs<uint16_t>( in );
+    const radiation_values radiation = read_runs<int32_t>( in );
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const int cell = j * SEEX + i;
+            ter[i][j] = palette.ter[terrain[cell]];
+            frn[i][j] = palette.furn[furniture[cell]];
+            trp[i][j] = palette.trp[traps[cell]];
+            rad[i][j] = radiation[cell];
+        }
+    }
+
+    std::istringstream contents( in.read_string() );
+    JsonIn jsin( contents );
+    jsin.start_object();
+    while( !jsin.end_object() ) {
+        const std::string member_name = jsin.get_member_name();
+        load( jsin, member_name, version, offset );
+    }
+}
+
+void serialize_submap_quad( std::ostream &out,
+                            const std::vector<std::pair<tripoint, const submap *>> &submaps )
+{
+    // The palette is only complete once every submap has been written
+    submap_palette palette;
+    std::ostringstream body;
+    binary_writer body_out( body );
+    body_out.write<uint8_t>( submaps.size() );
+    for( const auto &[pos, sm] : submaps ) {
+        body_out.write<int32_t>( pos.x );
+        body_out.write<int32_t>( pos.y );
+        body_out.write<int32_t>( pos.z );
+        sm->store_binary( body_out, palette );
+    }
+
+    binary_writer header( out );
+    header.write_bytes( quad_magic, sizeof( quad_magic ) );
+    header.write<uint16_t>( quad_format_version );
+    header.write<int32_t>( savegame_version );
+    palette.ter.write( header );
+    palette.furn.write( header );
+    palette.trp.write( header );
+    const std::string data = body.str();
+    header.write_bytes( data.data(), data.size() );
+}
+
+std::vector<std::pair<tripoint, std::unique_ptr<submap>>> deserialize_submap_quad(
+            std::istream &in )
+{
+    binary_reader reader( in );
+    char magic[sizeof( quad_magic )];
+    reader.read_bytes( magic, sizeof( magic ) );
+    if( std::memcmp( magic, quad_magic, sizeof( magic ) ) != 0 ) {
+        throw std::runtime_error( "not a binary submap quad" );
+    }
+    const uint16_t format = reader.read<uint16_t>();
+    if( format > quad_format_version ) {
+        throw std::runtime_error( "binary submap quad is from a newer version of the game" );
+    }
+    const int version = reader.read<int32_t>();
+
+    submap_palette palette;
+    palette.ter.read( reader );
+    palette.furn.read( reader );
+    palette.trp.read( reader );
+
+    std::vector<std::pair<tripoint, std::unique_ptr<submap>>> result;
+    const uint8_t count = reader.read<uint8_t>();
+    for( uint8_t i = 0; i < count; i++ ) {
+        tripoint pos;
+        pos.x = reader.read<int32_t>();
+        pos.y = reader.read<int32_t>();
+        pos.z = reader.read<int32_t>();
+        auto sm = std::make_unique<submap>( sm_to_ms_copy( pos ) );
+        sm->load_binary( reader, palette, version, sm_to_ms_copy( pos ) );
+        result.emplace_back( pos, std::move( sm ) );
+    }
+    return result;
+}
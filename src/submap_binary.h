@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "int_id.h"
+#include "point.h"
+#include "type_id.h"
+
+class binary_reader;
+class binary_writer;
+class submap;
+
+/**
+ * Maps the terrain, furniture and trap ids of a submap quad to small indices,
+ * so each tile only takes two bytes per layer and the ids are only spelled out once.
+ */
+template<typename T>
+class id_palette
+{
+    public:
+        uint16_t index_of( const int_id<T> &id );
+        const int_id<T> &operator[]( uint16_t index ) const;
+
+        void write( binary_writer &out ) const;
+        void read( binary_reader &in );
+
+    private:
+        std::vector<int_id<T>> ids;
+        std::unordered_map<int, uint16_t> indices;
+};
+
+struct submap_palette {
+    id_palette<ter_t> ter;
+    id_palette<furn_t> furn;
+    id_palette<trap> trp;
+};
+
+/** Writes up to four submaps of one quad in the binary map format. */
+void serialize_submap_quad( std::ostream &out,
+                            const std::vector<std::pair<tripoint, const submap *>> &submaps );
+/**
+ * Reads a quad written by @ref serialize_submap_quad.
+ * Throws if the data is truncated or not in the binary map format.
+ */
+std::vector<std::pair<tripoint, std::unique_ptr<submap>>> deserialize_submap_quad(
+            std::istream &in );
@@ -190,6 +190,7 @@ class DefaultRemovePartHandler : public RemovePartHandler
             }
 
             here.dirty_vehicle_list.insert( &veh );
+            here.set_pathfinding_cache_dirty( veh.global_part_pos3( part ) );
         }
         void spawn_animal_from_part( item &base, const tripoint &loc ) override {
             base.release_monster( loc, 1 );
@@ -295,6 +296,7 @@ void vehicle::copy_static_from( const vehicle &source )
     sails = source.sails;
     funnels = source.funnels;
     emitters = source.emitters;
+    accessories = source.accessories;
     loose_parts = source.loose_parts;
     wheelcache = source.wheelcache;
     rotors = source.rotors;
@@ -1933,6 +1935,9 @@ int vehicle::install_part( point dp, vehicle_part &&new_part )
 
     refresh();
     coeff_air_changed = true;
+    if( is_loaded() ) {
+        get_map().set_pathfinding_cache_dirty( global_part_pos3( parts.back() ) );
+    }
     return parts.size() - 1;
 }
 
@@ -2118,6 +2123,7 @@ bool vehicle::merge_rackable_vehicle( vehicle *carry_veh, const std::vector<int>
         carry_veh->part_removal_cleanup();
         here.dirty_vehicle_list.insert( this );
         here.set_transparency_cache_dirty( sm_pos.z );
+        here.set_pathfinding_cache_dirty( sm_pos.z );
         here.set_seen_cache_dirty( tripoint_zero );
         refresh();
     } else {
@@ -2269,6 +2275,7 @@ void vehicle::part_removal_cleanup()
             }
             const tripoint &pt = global_part_pos3( *it );
             here.clear_vehicle_point_from_cache( this, pt );
+            here.set_pathfinding_cache_dirty( pt );
             it = parts.erase( it );
             changed = true;
         } else {
@@ -2681,6 +2688,7 @@ bool vehicle::split_vehicles( const std::vector<std::vector <int>> &new_vehs,
         map &here = get_map();
         here.dirty_vehicle_list.insert( new_vehicle );
         here.set_transparency_cache_dirty( sm_pos.z );
+        here.set_pathfinding_cache_dirty( sm_pos.z );
         here.set_seen_cache_dirty( tripoint_zero );
         if( !new_labels.empty() ) {
             new_vehicle->labels = new_labels;
@@ -5241,8 +5249,11 @@ std::vector<vehicle_part *> vehicle::lights( bool active )
 int vehicle::total_accessory_epower_w() const
 {
     int epower = 0;
-    for( const vpart_reference &vp : get_enabled_parts( VPFLAG_ENABLED_DRAINS_EPOWER ) ) {
-        epower += vp.info().epower;
+    for( int p : accessories ) {
+        const vehicle_part &vp = parts[ p ];
+        if( vp.enabled && !vp.removed && !vp.is_broken() && vp.is_available() ) {
+            epower += vp.info().epower;
+        }
     }
     return epower;
 }
@@ -5392,12 +5403,19 @@ void vehicle::power_parts()
     int engine_epower = total_engine_epower_w();
     int epower = engine_epower + total_accessory_epower_w() + total_alternator_epower_w();
 
-    int delta_energy_bat = power_to_energy_bat( epower, 1_turns );
-    int storage_deficit_bat = std::max( 0, fuel_capacity( fuel_type_battery ) -
-                                        fuel_left( fuel_type_battery ) - delta_energy_bat );
+    // Parked vehicles without running engines or accessories have nothing to settle
+    if( epower == 0 && reactors.empty() ) {
+        return;
+    }
+
+    int delta_energy_bat = epower != 0 ? power_to_energy_bat( epower, 1_turns ) : 0;
     // Reactors trigger only on demand. If we'd otherwise run out of power, see
     // if we can spin up the reactors.
-    if( !reactors.empty() && storage_deficit_bat > 0 ) {
+    // Counting the stored charge walks the whole power network, so only do it for reactors
+    const int storage_deficit_bat = reactors.empty() ? 0 :
+                                    std::max( 0, fuel_capacity( fuel_type_battery ) -
+                                              fuel_left( fuel_type_battery ) - delta_energy_bat );
+    if( storage_deficit_bat > 0 ) {
         // Still not enough surplus epower to fully charge battery
         // Produce additional epower from any reactors
         bool reactor_working = false;
@@ -6283,6 +6301,7 @@ void vehicle::refresh()
     water_wheels.clear();
     funnels.clear();
     emitters.clear();
+    accessories.clear();
     relative_parts.clear();
     loose_parts.clear();
     wheelcache.clear();
@@ -6339,6 +6358,11 @@ void vehicle::refresh()
         if( vpi.has_flag( VPFLAG_FLOATS ) ) {
             floating.push_back( p );
         }
+        // Broken accessories can be repaired without a refresh, so they are
+        // filtered when summing instead
+        if( vpi.has_flag( VPFLAG_ENABLED_DRAINS_EPOWER ) ) {
+            accessories.push_back( p );
+        }
 
         if( vp.part().is_unavailable() ) {
             continue;
@@ -1620,6 +1620,7 @@ class vehicle
         std::vector<int> sails;            // List of sail indices
         std::vector<int> funnels;          // List of funnel indices
         std::vector<int> emitters;         // List of emitter parts
+        std::vector<int> accessories;      // List of ENABLED_DRAINS_EPOWER parts
         std::vector<int> loose_parts;      // List of UNMOUNT_ON_MOVE parts
         std::vector<int> wheelcache;       // List of wheels
         std::vector<int> rotors;           // List of rotors
@@ -0,0 +1,69 @@
+#include "vehicle_move_queue.h"
+
+#include <algorithm>
+
+#include "vehicle.h"
+
+void vehicle_move_queue::assign( const std::vector<vehicle *> &vehicles )
+{
+    clear();
+    states.reserve( vehicles.size() );
+    for( vehicle *veh : vehicles ) {
+        const auto inserted = states.emplace( veh, queued{ states.size(), 0.0f, 0, false } );
+        if( inserted.second ) {
+            push( veh, inserted.first->second );
+        }
+    }
+}
+
+void vehicle_move_queue::update( vehicle &veh )
+{
+    const auto iter = states.find( &veh );
+    if( iter == states.end() ) {
+        return;
+    }
+    queued &state = iter->second;
+    if( !state.in_heap || state.of_turn != veh.of_turn ) {
+        push( &veh, state );
+    }
+}
+
+vehicle *vehicle_move_queue::next()
+{
+    while( !heap.empty() ) {
+        std::pop_heap( heap.begin(), heap.end() );
+        const entry top = heap.back();
+        heap.pop_back();
+
+        queued &state = states[top.veh];
+        if( !state.in_heap || state.version != top.version ) {
+            // Superseded by a later push
+            continue;
+        }
+        state.in_heap = false;
+        push( top.veh, state );
+        if( state.in_heap && state.of_turn == top.of_turn ) {
+            return top.veh;
+        }
+    }
+    return nullptr;
+}
+
+void vehicle_move_queue::clear()
+{
+    heap.clear();
+    states.clear();
+}
+
+void vehicle_move_queue::push( vehicle *veh, queued &state )
+{
+    // Only vehicles with movement left are moved, same as when no queue is used
+    state.in_heap = veh->of_turn > 0;
+    if( !state.in_heap ) {
+        return;
+    }
+    state.of_turn = veh->of_turn;
+    state.version++;
+    heap.push_back( entry{ veh->of_turn, state.order, state.version, veh } );
+    std::push_heap( heap.begin(), heap.end() );
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+class vehicle;
+
+/**
+ * Order in which vehicles move during map::vehmove, the vehicle with the most movement left
+ * (vehicle::of_turn) goes first, ties go to the vehicle that was added first.
+ *
+ * Keys aren't updated when a vehicle moves: an entry whose key is out of date is pushed back
+ * with the current value when it reaches the top. A move only ever lowers the mover's of_turn,
+ * anything that raises it for another vehicle (collisions) must call @ref update.
+ */
+class vehicle_move_queue
+{
+    public:
+        /** Replaces the queue with the given vehicles, in this order. */
+        void assign( const std::vector<vehicle *> &vehicles );
+        /** Re-keys a queued vehicle after its of_turn was changed, other vehicles are ignored. */
+        void update( vehicle &veh );
+        /**
+         * Returns the vehicle with the most movement left, it stays queued.
+         * Returns nullptr if no vehicle has any movement left.
+         */
+        vehicle *next();
+        void clear();
+
+        bool empty() const {
+            return heap.empty();
+        }
+
+    private:
+        struct entry {
+            float of_turn;
+            size_t order;
+            unsigned version;
+            vehicle *veh;
+
+            bool operator<( const entry &rhs ) const {
+                return of_turn < rhs.of_turn || ( of_turn == rhs.of_turn && order > rhs.order );
+            }
+        };
+        struct queued {
+            size_t order;
+            // Key and version of the vehicle's live entry, entries of older versions are skipped
+            float of_turn;
+            unsigned version;
+            bool in_heap;
+        };
+
+        void push( vehicle *veh, queued &state );
+
+        std::vector<entry> heap;
+        std::unordered_map<const vehicle *, queued> states;
+};
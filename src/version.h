@@ -0,0 +1,3 @@
+// NOLINT(cata-header-guard)
+#define VERSION "7acf04f"
+#define BUILD_TIMESTAMP "2026-10-16-2216"
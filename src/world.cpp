@@ -1,9 +1,22 @@
 #include "world.h"
 
 #include <algorithm>
+#include <cstdio>
 #include <sstream>
 #include <cstring>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "catacharset.h"
 #include "game.h"
@@ -20,9 +33,97 @@
 #include "zlib.h"
 
 #define dbg(x) DebugLogFL((x),DC::Main)
-static sqlite3 *open_db( const std::string &path )
+/**
+ * An open SQLite database, along with the statements prepared on it.
+ *
+ * While a transaction is open, file writes are queued and upserted in batches
+ * of several rows per statement rather than one statement per file.
+ *
+ * Overmaps are loaded from several threads at once, so the cached statements
+ * are guarded by a mutex.
+ */
+class sqlite_db
+{
+    public:
+        explicit sqlite_db( const std::string &path );
+        ~sqlite_db();
+        sqlite_db( const sqlite_db & ) = delete;
+        sqlite_db &operator=( const sqlite_db & ) = delete;
+
+        void begin();
+        void commit();
+
+        bool exists( const std::string &path );
+        /**
+         * Returns the decompressed contents of @p path, or nothing if there is no such file.
+         * If @p binary is given, it is set to whether the file is in a binary format.
+         */
+        std::optional<std::string> read( const std::string &path, bool optional,
+                                         bool *binary = nullptr );
+        /**
+         * Compress new files with zstd rather than zlib. The first time this is enabled,
+         * a dictionary is trained on the files already stored and used from then on.
+         */
+        void set_zstd( bool enable );
+        /** Compresses @p data like new files are, returns the tag for the compression column. */
+        std::string compress( const std::string &data, std::vector<std::byte> &output );
+        /** Stores @p data, compressed as tagged by @p compression, at @p path. */
+        void write( const std::string &path, std::vector<std::byte> &&data,
+                    const std::string &compression );
+        /** Paths starting with @p prefix that are stored in JSON, not in a binary format. */
+        std::vector<std::string> json_paths( const std::string &prefix );
+        /** Moves the contents of the write-ahead log into the database file. */
+        void checkpoint();
+
+    private:
+        struct pending_write {
+            std::string path;
+            std::string parent;
+            std::vector<std::byte> data;
+            std::string compression;
+        };
+
+        /** Returns the statement for @p sql, reset and unbound, preparing it on first use. */
+        sqlite3_stmt *statement( const std::string &sql );
+        /** Executes all queued writes, must be done before anything is read. */
+        void flush();
+        /** Upserts @p count queued rows starting at @p begin, either one or a full batch. */
+        void flush_rows( size_t begin, size_t count );
+        /** Decompresses a blob, @p codec being its compression tag without the binary suffix. */
+        std::string decompress( const void *data, int size, const std::string &codec );
+        const zstd_dictionary *dictionary( unsigned int id );
+        void load_or_train_dictionary();
+
+        sqlite3 *db = nullptr;
+        std::mutex mutex;
+        std::unordered_map<std::string, sqlite3_stmt *> statements;
+        std::vector<pending_write> pending;
+        bool in_transaction = false;
+
+        bool use_zstd = false;
+        bool dictionary_ready = false;
+        /** The dictionary new files are compressed with, if any. */
+        std::shared_ptr<const zstd_dictionary> zstd_dict;
+        std::map<unsigned int, std::shared_ptr<const zstd_dictionary>> dictionaries;
+};
+
+// Rows per multi-row upsert, four parameters each.
+static constexpr size_t max_batched_writes = 64;
+
+// Values of the compression column, followed by binary_suffix for files in a
+// binary format, which readers must not parse as JSON.
+static const std::string compression_zlib = "zlib";
+static const std::string compression_zstd = "zstd";
+static const std::string binary_suffix = "-binary";
+
+// Samples bigger than this are mostly player saves, which don't compress like the rest
+static constexpr size_t max_dictionary_sample = 128 * 1024;
+// Files read to train a dictionary on, and how much they may add up to once decompressed
+static constexpr int64_t max_dictionary_samples = 2000;
+static constexpr size_t dictionary_sample_budget = 8 * 1024 * 1024;
+
+sqlite_db::sqlite_db( const std::string &path )
 {
-    sqlite3 *db = nullptr;
     int ret;
 
     ret = sqlite3_initialize();
@@ -34,26 +135,788 @@ static sqlite3 *open_db( const std::string &path )
     ret = sqlite3_open_v2( path.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL );
     if( ret != SQLITE_OK ) {
         dbg( DL::Error ) << "Failed to open db" << path << " (Error " << ret << ")";
+        sqlite3_close( db );
         throw std::runtime_error( "Failed to open db" );
     }
 
-    auto sql = R"sql(
+    // With a write-ahead log a commit only appends to the log instead of rewriting
+    // pages in place, and the synchronous level decides how often that gets fsync'd.
+    const std::string sql = R"sql(
+        PRAGMA journal_mode = WAL;
+        PRAGMA synchronous = )sql" + get_option<std::string>( "SAVE_SYNCHRONOUS" ) + R"sql(;
         CREATE TABLE IF NOT EXISTS files (
             path           TEXT PRIMARY KEY NOT NULL,
             parent         TEXT NOT NULL,
             compression    TEXT DEFAULT NULL,
             data           BLOB NOT NULL
         );
+        CREATE TABLE IF NOT EXISTS dictionaries (
+            id             INTEGER PRIMARY KEY NOT NULL,
+            data           BLOB NOT NULL
+        );
     )sql";
 
     char *sqlErrMsg = 0;
-    ret = sqlite3_exec( db, sql, NULL, NULL, &sqlErrMsg );
+    ret = sqlite3_exec( db, sql.c_str(), NULL, NULL, &sqlErrMsg );
     if( ret != SQLITE_OK ) {
         dbg( DL::Error ) << "Failed to init db" << path << " (" << sqlErrMsg << ")";
+        sqlite3_free( sqlErrMsg );
+        sqlite3_close( db );
         throw std::runtime_error( "Failed to open db" );
     }
+}
+
+sqlite_db::~sqlite_db()
+{
+    for( const auto &elem : statements ) {
+        sqlite3_finalize( elem.second );
+    }
+    sqlite3_close( db );
+}
+
+sqlite3_stmt *sqlite_db::statement( const std::string &sql )
+{
+    auto it = statements.find( sql );
+    if( it != statements.end() ) {
+        sqlite3_reset( it->second );
+        sqlite3_clear_bindings( it->second );
+        return it->second;
+    }
+
+    sqlite3_stmt *stmt = nullptr;
+    if( sqlite3_prepare_v3( db, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &stmt,
+                            nullptr ) != SQLITE_OK ) {
+        dbg( DL::Error ) << "Failed to prepare statement: " << sqlite3_errmsg( db ) << '\n';
+        throw std::runtime_error( "DB query failed" );
+    }
+    statements.emplace( sql, stmt );
+    return stmt;
+}
+
+void sqlite_db::begin()
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    sqlite3_exec( db, "BEGIN TRANSACTION", NULL, NULL, NULL );
+    in_transaction = true;
+}
+
+void sqlite_db::commit()
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    // A failed write only undoes its own statement, the rest of the transaction is still committed
+    on_out_of_scope end_transaction( [this]() {
+        sqlite3_exec( db, "COMMIT", NULL, NULL, NULL );
+        in_transaction = false;
+    } );
+    flush();
+}
+
+bool sqlite_db::exists( const std::string &path )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    int fileCount = 0;
+    flush();
+    sqlite3_stmt *stmt = statement( "SELECT count() FROM files WHERE path = :path" );
+
+    if( sqlite3_bind_text( stmt, sqlite3_bind_parameter_index( stmt, ":path" ), path.c_str(), -1,
+                           SQLITE_TRANSIENT ) != SQLITE_OK ) {
+        dbg( DL::Error ) << "Failed to bind parameter: " << sqlite3_errmsg( db ) << '\n';
+        throw std::runtime_error( "DB query failed" );
+    }
+
+    if( sqlite3_step( stmt ) == SQLITE_ROW ) {
+        // Retrieve the count result
+        fileCount = sqlite3_column_int( stmt, 0 );
+    } else {
+        dbg( DL::Error ) << "Failed to execute query: " << sqlite3_errmsg( db ) << '\n';
+        sqlite3_reset( stmt );
+        throw std::runtime_error( "DB query failed" );
+    }
+
+    sqlite3_reset( stmt );
+
+    return fileCount > 0;
+}
+
+std::optional<std::string> sqlite_db::read( const std::string &path, bool optional,
+                                            bool *binary )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    flush();
+    sqlite3_stmt *stmt =
+        statement( "SELECT data, compression FROM files WHERE path = :path LIMIT 1" );
+
+    if( sqlite3_bind_text( stmt, sqlite3_bind_parameter_index( stmt, ":path" ), path.c_str(), -1,
+                           SQLITE_TRANSIENT ) != SQLITE_OK ) {
+        dbg( DL::Error ) << "Failed to bind parameter: " << sqlite3_errmsg( db ) << '\n';
+        throw std::runtime_error( "DB query failed" );
+    }
+
+    if( sqlite3_step( stmt ) != SQLITE_ROW ) {
+        auto err = sqlite3_errmsg( db );
+        if( !optional ) {
+            dbg( DL::Error ) << "Failed to execute query: " << err << '\n';
+            sqlite3_reset( stmt );
+            throw std::runtime_error( "DB query failed" );
+        }
+        sqlite3_reset( stmt );
+        return std::nullopt;
+    }
+
+    const void *blobData = sqlite3_column_blob( stmt, 0 );
+    int blobSize = sqlite3_column_bytes( stmt, 0 );
+    auto compression_raw = sqlite3_column_text( stmt, 1 );
+    std::string compression = compression_raw ? reinterpret_cast<const char *>( compression_raw ) : "";
+
+    if( blobData == nullptr ) {
+        sqlite3_reset( stmt );
+        return std::nullopt;
+    }
+
+    const bool is_binary = compression.ends_with( binary_suffix );
+    if( is_binary ) {
+        compression.resize( compression.size() - binary_suffix.size() );
+    }
+    std::string dataString;
+    try {
+        dataString = decompress( blobData, blobSize, compression );
+    } catch( ... ) {
+        sqlite3_reset( stmt );
+        throw;
+    }
+    sqlite3_reset( stmt );
+    if( binary ) {
+        *binary = is_binary;
+    }
+    return dataString;
+}
+
+std::string sqlite_db::decompress( const void *data, const int size, const std::string &codec )
+{
+    std::string output;
+    if( codec.empty() ) {
+        output = std::string( static_cast<const char *>( data ), size );
+    } else if( codec == compression_zlib ) {
+        zlib_decompress( data, size, output );
+    } else if( codec == compression_zstd ) {
+        const unsigned int id = zstd_blob_dictionary_id( data, size );
+        zstd_decompress( data, size, output, id != 0 ? dictionary( id ) : nullptr );
+    } else {
+        throw std::runtime_error( "Unknown compression format: " + codec );
+    }
+    return output;
+}
+
+const zstd_dictionary *sqlite_db::dictionary( const unsigned int id )
+{
+    const auto iter = dictionaries.find( id );
+    if( iter != dictionaries.end() ) {
+        return iter->second.get();
+    }
+
+    sqlite3_stmt *stmt = statement( "SELECT data FROM dictionaries WHERE id = :id" );
+    if( sqlite3_bind_int64( stmt, sqlite3_bind_parameter_index( stmt, ":id" ), id ) != SQLITE_OK ) {
+        dbg( DL::Error ) << "Failed to bind parameter: " << sqlite3_errmsg( db ) << '\n';
+        throw std::runtime_error( "DB query failed" );
+    }
+    if( sqlite3_step( stmt ) != SQLITE_ROW ) {
+        sqlite3_reset( stmt );
+        throw std::runtime_error( "Missing zstd dictionary " + std::to_string( id ) );
+    }
+    std::shared_ptr<const zstd_dictionary> loaded = zstd_load_dictionary(
+                sqlite3_column_blob( stmt, 0 ), sqlite3_column_bytes( stmt, 0 ) );
+    sqlite3_reset( stmt );
+    dictionaries.emplace( id, loaded );
+    return loaded.get();
+}
+
+void sqlite_db::load_or_train_dictionary()
+{
+    sqlite3_stmt *stmt = statement( "SELECT id FROM dictionaries LIMIT 1" );
+    if( sqlite3_step( stmt ) == SQLITE_ROW ) {
+        const unsigned int id = sqlite3_column_int64( stmt, 0 );
+        sqlite3_reset( stmt );
+        dictionary( id );
+        zstd_dict = dictionaries[id];
+        dictionary_ready = true;
+        return;
+    }
+    sqlite3_reset( stmt );
+
+    // Pick files spread evenly over the rowids and look each one up by rowid, so only the
+    //   sampled files are read, not every file in the world
+    stmt = statement( "SELECT max(rowid) FROM files" );
+    const int64_t max_rowid = sqlite3_step( stmt ) == SQLITE_ROW ? sqlite3_column_int64( stmt, 0 ) : 0;
+    sqlite3_reset( stmt );
+
+    std::vector<std::string> samples;
+    size_t sample_bytes = 0;
+    int64_t last_rowid = 0;
+    const int64_t stride = std::max<int64_t>( 1, max_rowid / max_dictionary_samples );
+    stmt = statement(
+               "SELECT rowid, data, compression FROM files WHERE rowid >= :rowid ORDER BY rowid LIMIT 1" );
+    for( int64_t next = 1; next <= max_rowid && sample_bytes < dictionary_sample_budget;
+         next += stride ) {
+        // Rowids freed by replaced files lead to the same file more than once
+        if( next <= last_rowid ) {
+            continue;
+        }
+        if( sqlite3_bind_int64( stmt, sqlite3_bind_parameter_index( stmt, ":rowid" ),
+                                next ) != SQLITE_OK ) {
+            dbg( DL::Error ) << "Failed to bind parameter: " << sqlite3_errmsg( db ) << '\n';
+            sqlite3_reset( stmt );
+            throw std::runtime_error( "DB query failed" );
+        }
+        if( sqlite3_step( stmt ) != SQLITE_ROW ) {
+            sqlite3_reset( stmt );
+            break;
+        }
+        last_rowid = sqlite3_column_int64( stmt, 0 );
+        const auto compression_raw = sqlite3_column_text( stmt, 2 );
+        std::string codec = compression_raw ? reinterpret_cast<const char *>( compression_raw ) : "";
+        if( codec.ends_with( binary_suffix ) ) {
+            codec.resize( codec.size() - binary_suffix.size() );
+        }
+        std::string sample = decompress( sqlite3_column_blob( stmt, 1 ),
+                                         sqlite3_column_bytes( stmt, 1 ), codec );
+        sqlite3_reset( stmt );
+        if( sample.size() <= max_dictionary_sample ) {
+            sample_bytes += sample.size();
+            samples.push_back( std::move( sample ) );
+        }
+    }
+
+    const std::vector<std::byte> trained = zstd_train_dictionary( samples );
+    if( trained.empty() ) {
+        // Not enough data yet, try again on the next save
+        return;
+    }
+    std::shared_ptr<const zstd_dictionary> loaded = zstd_load_dictionary( trained.data(),
+            trained.size() );
+    const unsigned int id = zstd_dictionary_id( *loaded );
+
+    stmt = statement( "INSERT INTO dictionaries(id, data) VALUES (:id, :data)" );
+    if( sqlite3_bind_int64( stmt, sqlite3_bind_parameter_index( stmt, ":id" ), id ) != SQLITE_OK ||
+        sqlite3_bind_blob( stmt, sqlite3_bind_parameter_index( stmt, ":data" ), trained.data(),
+                           trained.size(), SQLITE_STATIC ) != SQLITE_OK ) {
+        dbg( DL::Error ) << "Failed to bind parameters: " << sqlite3_errmsg( db ) << '\n';
+        sqlite3_reset( stmt );
+        throw std::runtime_error( "DB query failed" );
+    }
+    if( sqlite3_step( stmt ) != SQLITE_DONE ) {
+        dbg( DL::Error ) << "Failed to execute query: " << sqlite3_errmsg( db ) << '\n';
+        sqlite3_reset( stmt );
+        throw std::runtime_error( "DB query failed" );
+    }
+    sqlite3_reset( stmt );
+
+    dictionaries.emplace( id, loaded );
+    zstd_dict = loaded;
+    dictionary_ready = true;
+}
+
+void sqlite_db::set_zstd( const bool enable )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    use_zstd = enable;
+    if( !enable || dictionary_ready ) {
+        return;
+    }
+    flush();
+    try {
+        load_or_train_dictionary();
+    } catch( const std::exception &err ) {
+        // Compressing without a dictionary is still better than failing to save
+        dbg( DL::Error ) << "Failed to prepare zstd dictionary: " << err.what();
+    }
+}
+
+std::string sqlite_db::compress( const std::string &data, std::vector<std::byte> &output )
+{
+    bool zstd;
+    std::shared_ptr<const zstd_dictionary> dict;
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        zstd = use_zstd;
+        dict = zstd_dict;
+    }
 
-    return db;
+    if( zstd ) {
+        zstd_compress( data, output, dict.get() );
+        return compression_zstd;
+    }
+    zlib_compress( data, output );
+    return compression_zlib;
+}
+
+void sqlite_db::write( const std::string &path, std::vector<std::byte> &&data,
+                       const std::string &compression )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    size_t basePos = path.find_last_of( "/\\" );
+    auto parent = ( basePos == std::string::npos ) ? "" : path.substr( 0, basePos );
+    pending.push_back( { path, parent, std::move( data ), compression } );
+
+    if( !in_transaction || pending.size() >= max_batched_writes ) {
+        flush();
+    }
+}
+
+void sqlite_db::flush()
+{
+    // The rows are dropped even if writing them fails, so the failure is reported only once
+    on_out_of_scope clear_pending( [this]() {
+        pending.clear();
+    } );
+    size_t done = 0;
+    for( ; pending.size() - done >= max_batched_writes; done += max_batched_writes ) {
+        flush_rows( done, max_batched_writes );
+    }
+    for( ; done < pending.size(); done++ ) {
+        flush_rows( done, 1 );
+    }
+}
+
+static std::string upsert_sql( const size_t rows )
+{
+    std::string sql = "INSERT INTO files(path, parent, data, compression) VALUES ";
+    for( size_t i = 0; i < rows; i++ ) {
+        sql += i == 0 ? "(?, ?, ?, ?)" : ", (?, ?, ?, ?)";
+    }
+    // Rows are inserted in order, so a path queued twice keeps its last data.
+    sql += R"sql(
+        ON CONFLICT(path) DO UPDATE
+            SET data = excluded.data,
+                parent = excluded.parent,
+                compression = excluded.compression;
+    )sql";
+    return sql;
+}
+
+void sqlite_db::flush_rows( const size_t begin, const size_t count )
+{
+    static const std::string single_sql = upsert_sql( 1 );
+    static const std::string batch_sql = upsert_sql( max_batched_writes );
+    sqlite3_stmt *stmt = statement( count == max_batched_writes ? batch_sql : single_sql );
+
+    for( size_t i = 0; i < count; i++ ) {
+        const pending_write &row = pending[begin + i];
+        const int first = static_cast<int>( i ) * 4 + 1;
+        // The queued rows outlive the statement execution, so they need not be copied.
+        if( sqlite3_bind_text( stmt, first, row.path.c_str(), -1, SQLITE_STATIC ) != SQLITE_OK ||
+            sqlite3_bind_text( stmt, first + 1, row.parent.c_str(), -1, SQLITE_STATIC ) != SQLITE_OK ||
+            sqlite3_bind_blob( stmt, first + 2, row.data.data(), row.data.size(),
+                               SQLITE_STATIC ) != SQLITE_OK ||
+            sqlite3_bind_text( stmt, first + 3, row.compression.c_str(), -1,
+                               SQLITE_STATIC ) != SQLITE_OK ) {
+            dbg( DL::Error ) << "Failed to bind parameters: " << sqlite3_errmsg( db ) << '\n';
+            sqlite3_reset( stmt );
+            throw std::runtime_error( "DB query failed" );
+        }
+    }
+
+    if( sqlite3_step( stmt ) != SQLITE_DONE ) {
+        dbg( DL::Error ) << "Failed to execute query: " << sqlite3_errmsg( db ) << '\n';
+        sqlite3_reset( stmt );
+        sqlite3_clear_bindings( stmt );
+        throw std::runtime_error( "DB query failed" );
+    }
+    sqlite3_reset( stmt );
+    sqlite3_clear_bindings( stmt );
+}
+
+std::vector<std::string> sqlite_db::json_paths( const std::string &prefix )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    flush();
+    sqlite3_stmt *stmt = statement(
+                             "SELECT path FROM files WHERE path LIKE :prefix AND compression NOT LIKE :binary" );
+
+    const std::string pattern = prefix + "%";
+    const std::string binary_pattern = "%" + binary_suffix;
+    if( sqlite3_bind_text( stmt, sqlite3_bind_parameter_index( stmt, ":prefix" ), pattern.c_str(), -1,
+                           SQLITE_TRANSIENT ) != SQLITE_OK ||
+        sqlite3_bind_text( stmt, sqlite3_bind_parameter_index( stmt, ":binary" ),
+                           binary_pattern.c_str(), -1, SQLITE_TRANSIENT ) != SQLITE_OK ) {
+        dbg( DL::Error ) << "Failed to bind parameter: " << sqlite3_errmsg( db ) << '\n';
+        throw std::runtime_error( "DB query failed" );
+    }
+
+    std::vector<std::string> paths;
+    int ret;
+    while( ( ret = sqlite3_step( stmt ) ) == SQLITE_ROW ) {
+        paths.emplace_back( reinterpret_cast<const char *>( sqlite3_column_text( stmt, 0 ) ) );
+    }
+    if( ret != SQLITE_DONE ) {
+        dbg( DL::Error ) << "Failed to execute query: " << sqlite3_errmsg( db ) << '\n';
+        sqlite3_reset( stmt );
+        throw std::runtime_error( "DB query failed" );
+    }
+    sqlite3_reset( stmt );
+    return paths;
+}
+
+void sqlite_db::checkpoint()
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    flush();
+    sqlite3_wal_checkpoint_v2( db, nullptr, SQLITE_CHECKPOINT_TRUNCATE, nullptr, nullptr );
+}
+
+static void store_in_db( sqlite_db &db, const std::string &path, const std::string &data,
+                         bool binary )
+{
+    std::vector<std::byte> compressedData;
+    std::string compression = db.compress( data, compressedData );
+    if( binary ) {
+        compression += binary_suffix;
+    }
+
+    db.write( path, std::move( compressedData ), compression );
+}
+
+/**
+ * Compresses and stores the files of one save on a thread of its own, so that the
+ * game only has to serialize them before it can carry on.
+ */
+class save_writer
+{
+    public:
+        save_writer();
+        ~save_writer();
+        save_writer( const save_writer & ) = delete;
+        save_writer &operator=( const save_writer & ) = delete;
+
+        void write( sqlite_db &db, const std::string &path, std::string &&data, bool binary );
+        /** Commits @p dbs once everything queued before has been written. */
+        void commit( std::vector<sqlite_db *> dbs );
+        bool committing();
+        /** Whether everything queued so far has been written, and committed if that was requested. */
+        bool is_idle();
+        /** Blocks until everything queued so far has been written, and committed if that was requested. */
+        void wait_idle();
+        /** Whether the thread has committed the save, or given up on it. finish() won't block then. */
+        bool is_done();
+        /**
+         * Blocks until the thread is done, rethrowing the first error it ran into.
+         * If no commit was requested, queued files are dropped.
+         */
+        void finish();
+
+    private:
+        struct job {
+            sqlite_db *db = nullptr;
+            std::string path;
+            std::string data;
+            bool binary = false;
+        };
+
+        void run();
+        /** Expects @ref mutex to be held. */
+        bool idle_locked() const;
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable idle;
+        std::deque<job> jobs;
+        std::vector<sqlite_db *> commit_dbs;
+        bool busy = false;
+        bool commit_requested = false;
+        bool abandoned = false;
+        bool done = false;
+        std::exception_ptr error;
+        std::thread thread;
+};
+
+save_writer::save_writer()
+{
+    thread = std::thread( &save_writer::run, this );
+}
+
+save_writer::~save_writer()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        abandoned = !commit_requested;
+    }
+    wake.notify_one();
+    if( thread.joinable() ) {
+        thread.join();
+    }
+}
+
+void save_writer::write( sqlite_db &db, const std::string &path, std::string &&data,
+                         bool binary )
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        jobs.push_back( { &db, path, std::move( data ), binary } );
+    }
+    wake.notify_one();
+}
+
+void save_writer::commit( std::vector<sqlite_db *> dbs )
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        commit_dbs = std::move( dbs );
+        commit_requested = true;
+    }
+    wake.notify_one();
+}
+
+bool save_writer::committing()
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    return commit_requested;
+}
+
+bool save_writer::idle_locked() const
+{
+    // A requested commit counts as queued work until it has run
+    return done || ( jobs.empty() && !busy && !commit_requested );
+}
+
+bool save_writer::is_idle()
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    return idle_locked();
+}
+
+void save_writer::wait_idle()
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    idle.wait( lock, [this] {
+        return idle_locked();
+    } );
+}
+
+bool save_writer::is_done()
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    return done;
+}
+
+void save_writer::finish()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        abandoned = !commit_requested;
+    }
+    wake.notify_one();
+    if( thread.joinable() ) {
+        thread.join();
+    }
+    if( error ) {
+        std::rethrow_exception( std::exchange( error, nullptr ) );
+    }
+}
+
+void save_writer::run()
+{
+    while( true ) {
+        job next;
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            wake.wait( lock, [this] {
+                return !jobs.empty() || commit_requested || abandoned;
+            } );
+            if( abandoned ) {
+                jobs.clear();
+                done = true;
+                idle.notify_all();
+                return;
+            }
+            if( !jobs.empty() ) {
+                next = std::move( jobs.front() );
+                jobs.pop_front();
+            }
+            busy = true;
+        }
+
+        // An empty queue at this point means the commit was requested
+        const bool last = next.db == nullptr;
+        try {
+            if( last ) {
+                for( sqlite_db *db : commit_dbs ) {
+                    db->commit();
+                }
+            } else {
+                store_in_db( *next.db, next.path, next.data, next.binary );
+            }
+        } catch( ... ) {
+            std::lock_guard<std::mutex> lock( mutex );
+            if( !error ) {
+                error = std::current_exception();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            busy = false;
+            done = last;
+        }
+        idle.notify_all();
+        if( last ) {
+            return;
+        }
+    }
+}
+
+/**
+ * Reads map quads from the database on a thread of its own, ahead of the map needing them.
+ *
+ * The quads are read and decompressed, but parsing them creates items, vehicles and
+ * the like, which has to happen on the main thread. Quads that aren't in the database
+ * are remembered as missing, so the game can go straight to generating them.
+ */
+class map_quad_prefetcher
+{
+    public:
+        struct quad_data {
+            /** Nothing if the quad isn't saved. */
+            std::optional<std::string> data;
+            bool binary = false;
+        };
+
+        explicit map_quad_prefetcher( sqlite_db &db );
+        ~map_quad_prefetcher();
+        map_quad_prefetcher( const map_quad_prefetcher & ) = delete;
+        map_quad_prefetcher &operator=( const map_quad_prefetcher & ) = delete;
+
+        /**
+         * Replaces the queued quads with @p quads, which are read in order.
+         * Read quads that aren't requested again are dropped.
+         */
+        void request( std::vector<std::pair<tripoint, std::string>> &&quads );
+        /**
+         * Returns what was read for @p om_addr and forgets it, or nothing if it wasn't requested.
+         * If the quad is being read right now, waits for it.
+         */
+        std::optional<quad_data> take( const tripoint &om_addr );
+        /** Forgets @p om_addr, the quad changed since it was requested. */
+        void forget( const tripoint &om_addr );
+
+    private:
+        void run();
+
+        sqlite_db &db;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable read_done;
+        std::deque<std::pair<tripoint, std::string>> queue;
+        std::map<tripoint, quad_data> results;
+        /** The quad being read on the thread, if any. */
+        std::optional<tripoint> reading;
+        /** Whether the quad being read was forgotten in the meantime. */
+        bool reading_forgotten = false;
+        bool stopping = false;
+        std::thread thread;
+};
+
+map_quad_prefetcher::map_quad_prefetcher( sqlite_db &db ) : db( db )
+{
+    thread = std::thread( &map_quad_prefetcher::run, this );
+}
+
+map_quad_prefetcher::~map_quad_prefetcher()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    wake.notify_one();
+    if( thread.joinable() ) {
+        thread.join();
+    }
+}
+
+void map_quad_prefetcher::request( std::vector<std::pair<tripoint, std::string>> &&quads )
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        std::map<tripoint, quad_data> kept;
+        queue.clear();
+        for( auto &quad : quads ) {
+            const auto iter = results.find( quad.first );
+            if( iter != results.end() ) {
+                kept.emplace( quad.first, std::move( iter->second ) );
+            } else if( reading != quad.first && !kept.contains( quad.first ) ) {
+                queue.push_back( std::move( quad ) );
+            }
+        }
+        results = std::move( kept );
+    }
+    wake.notify_one();
+}
+
+std::optional<map_quad_prefetcher::quad_data> map_quad_prefetcher::take( const tripoint &om_addr )
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    read_done.wait( lock, [&] {
+        return reading != om_addr;
+    } );
+    const auto iter = results.find( om_addr );
+    if( iter == results.end() ) {
+        std::erase_if( queue, [&]( const std::pair<tripoint, std::string> &quad ) {
+            return quad.first == om_addr;
+        } );
+        return std::nullopt;
+    }
+    quad_data result = std::move( iter->second );
+    results.erase( iter );
+    return result;
+}
+
+void map_quad_prefetcher::forget( const tripoint &om_addr )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    results.erase( om_addr );
+    std::erase_if( queue, [&]( const std::pair<tripoint, std::string> &quad ) {
+        return quad.first == om_addr;
+    } );
+    if( reading == om_addr ) {
+        reading_forgotten = true;
+    }
+}
+
+void map_quad_prefetcher::run()
+{
+    while( true ) {
+        std::pair<tripoint, std::string> next;
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            wake.wait( lock, [this] {
+                return !queue.empty() || stopping;
+            } );
+            if( stopping ) {
+                return;
+            }
+            next = std::move( queue.front() );
+            queue.pop_front();
+            reading = next.first;
+            reading_forgotten = false;
+        }
+
+        std::optional<quad_data> read;
+        try {
+            quad_data quad;
+            quad.data = db.read( next.second, true, &quad.binary );
+            read = std::move( quad );
+        } catch( const std::exception &err ) {
+            // Leave it to the main thread, which reads it again and reports the error
+            dbg( DL::Warn ) << "Failed to prefetch " << next.second << ": " << err.what();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            if( read && !reading_forgotten ) {
+                results.emplace( next.first, std::move( *read ) );
+            }
+            reading.reset();
+        }
+        read_done.notify_all();
+    }
 }
 
 save_t::save_t( const std::string &name ): name( name ) {}
@@ -209,8 +1072,7 @@ bool WORLDINFO::save( const bool is_conversion ) const
     // choice of world save format.
     if( world_save_format == save_format::V2_COMPRESSED_SQLITE3 &&
         !file_exist( folder_path() + "/map.sqlite3" ) ) {
-        sqlite3 *db = open_db( folder_path() + "/map.sqlite3" );
-        sqlite3_close( db );
+        sqlite_db db( folder_path() + "/map.sqlite3" );
     }
     return true;
 }
@@ -258,140 +1120,47 @@ void load_external_option( const JsonObject &jo )
     }
 }
 
-static bool file_exist_in_db( sqlite3 *db, const std::string &path )
+static bool file_exist_in_db( sqlite_db &db, const std::string &path )
 {
-    int fileCount = 0;
-    const char *sql = "SELECT count() FROM files WHERE path = :path";
-    sqlite3_stmt *stmt = nullptr;
-
-    if( sqlite3_prepare_v2( db, sql, -1, &stmt, nullptr ) != SQLITE_OK ) {
-        dbg( DL::Error ) << "Failed to prepare statement: " << sqlite3_errmsg( db ) << '\n';
-        throw std::runtime_error( "DB query failed" );
-    }
-
-    if( sqlite3_bind_text( stmt, sqlite3_bind_parameter_index( stmt, ":path" ), path.c_str(), -1,
-                           SQLITE_TRANSIENT ) != SQLITE_OK ) {
-        dbg( DL::Error ) << "Failed to bind parameter: " << sqlite3_errmsg( db ) << '\n';
-        sqlite3_finalize( stmt );
-        throw std::runtime_error( "DB query failed" );
-    }
-
-    if( sqlite3_step( stmt ) == SQLITE_ROW ) {
-        // Retrieve the count result
-        fileCount = sqlite3_column_int( stmt, 0 );
-    } else {
-        dbg( DL::Error ) << "Failed to execute query: " << sqlite3_errmsg( db ) << '\n';
-        sqlite3_finalize( stmt );
-        throw std::runtime_error( "DB query failed" );
-    }
-
-    sqlite3_finalize( stmt );
-
-    return fileCount > 0;
+    return db.exists( path );
 }
 
-static void write_to_db( sqlite3 *db, const std::string &path, file_write_fn writer )
+void world::write_to_db( sqlite_db &db, const std::string &path, file_write_fn writer,
+                         bool binary ) const
 {
     std::ostringstream oss;
     writer( oss );
-    auto data = oss.str();
-
-    std::vector<std::byte> compressedData;
-    zlib_compress( data, compressedData );
 
-    size_t basePos = path.find_last_of( "/\\" );
-    auto parent = ( basePos == std::string::npos ) ? "" : path.substr( 0, basePos );
-
-    auto sql = R"sql(
-        INSERT INTO files(path, parent, data, compression)
-        VALUES (:path, :parent, :data, 'zlib')
-        ON CONFLICT(path) DO UPDATE
-            SET data = excluded.data,
-                parent = excluded.parent,
-                compression = excluded.compression;
-    )sql";
-
-    sqlite3_stmt *stmt = nullptr;
-
-    if( sqlite3_prepare_v2( db, sql, -1, &stmt, nullptr ) != SQLITE_OK ) {
-        dbg( DL::Error ) << "Failed to prepare statement: " << sqlite3_errmsg( db ) << '\n';
-        throw std::runtime_error( "DB query failed" );
-    }
-
-    if( sqlite3_bind_text( stmt, sqlite3_bind_parameter_index( stmt, ":path" ), path.c_str(), -1,
-                           SQLITE_TRANSIENT ) != SQLITE_OK ||
-        sqlite3_bind_text( stmt, sqlite3_bind_parameter_index( stmt, ":parent" ), parent.c_str(), -1,
-                           SQLITE_TRANSIENT ) != SQLITE_OK ||
-        sqlite3_bind_blob( stmt, sqlite3_bind_parameter_index( stmt, ":data" ), compressedData.data(),
-                           compressedData.size(), SQLITE_TRANSIENT ) != SQLITE_OK ) {
-        dbg( DL::Error ) << "Failed to bind parameters: " << sqlite3_errmsg( db ) << '\n';
-        sqlite3_finalize( stmt );
-        throw std::runtime_error( "DB query failed" );
+    if( async_save && !async_save->committing() ) {
+        async_save->write( db, path, oss.str(), binary );
+        return;
     }
+    // Don't let an older copy still in the queue overwrite this one
+    wait_for_queued_writes();
+    store_in_db( db, path, oss.str(), binary );
+}
 
-    if( sqlite3_step( stmt ) != SQLITE_DONE ) {
-        dbg( DL::Error ) << "Failed to execute query: " << sqlite3_errmsg( db ) << '\n';
+void world::wait_for_queued_writes() const
+{
+    if( async_save ) {
+        async_save->wait_idle();
     }
-    sqlite3_finalize( stmt );
 }
 
-static bool read_from_db( sqlite3 *db, const std::string &path, file_read_fn reader,
+static bool read_from_db( sqlite_db &db, const std::string &path, file_read_fn reader,
                           bool optional )
 {
-    const char *sql = "SELECT data, compression FROM files WHERE path = :path LIMIT 1";
-
-    sqlite3_stmt *stmt = nullptr;
-
-    if( sqlite3_prepare_v2( db, sql, -1, &stmt, nullptr ) != SQLITE_OK ) {
-        dbg( DL::Error ) << "Failed to prepare statement: " << sqlite3_errmsg( db ) << '\n';
-        throw std::runtime_error( "DB query failed" );
-    }
-
-    if( sqlite3_bind_text( stmt, sqlite3_bind_parameter_index( stmt, ":path" ), path.c_str(), -1,
-                           SQLITE_TRANSIENT ) != SQLITE_OK ) {
-        dbg( DL::Error ) << "Failed to bind parameter: " << sqlite3_errmsg( db ) << '\n';
-        sqlite3_finalize( stmt );
-        throw std::runtime_error( "DB query failed" );
-    }
-
-    if( sqlite3_step( stmt ) == SQLITE_ROW ) {
-        // Retrieve the count result
-        const void *blobData = sqlite3_column_blob( stmt, 0 );
-        int blobSize = sqlite3_column_bytes( stmt, 0 );
-        auto compression_raw = sqlite3_column_text( stmt, 1 );
-        std::string compression = compression_raw ? reinterpret_cast<const char *>( compression_raw ) : "";
-
-        if( blobData == nullptr ) {
-            return false; // Return an empty string if there's no data
-        }
-
-        std::string dataString;
-        if( compression.empty() ) {
-            dataString = std::string( static_cast<const char *>( blobData ), blobSize );
-        } else if( compression == "zlib" ) {
-            zlib_decompress( blobData, blobSize, dataString );
-        } else {
-            throw std::runtime_error( "Unknown compression format: " + compression );
-        }
-
-        std::istringstream stream( dataString );
-        reader( stream );
-        sqlite3_finalize( stmt );
-    } else {
-        auto err = sqlite3_errmsg( db );
-        sqlite3_finalize( stmt );
-
-        if( !optional ) {
-            dbg( DL::Error ) << "Failed to execute query: " << err << '\n';
-            throw std::runtime_error( "DB query failed" );
-        }
+    const std::optional<std::string> data = db.read( path, optional );
+    if( !data ) {
         return false;
     }
 
+    std::istringstream stream( *data );
+    reader( stream );
     return true;
 }
 
-static bool read_from_db_json( sqlite3 *db, const std::string &path, file_read_json_fn reader,
+static bool read_from_db_json( sqlite_db &db, const std::string &path, file_read_json_fn reader,
                                bool optional )
 {
     return read_from_db( db, path, [&]( std::istream & fin ) {
@@ -409,7 +1178,7 @@ world::world( WORLDINFO *info )
     }
 
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
-        map_db = open_db( info->folder_path() + "/map.sqlite3" );
+        map_db = std::make_unique<sqlite_db>( info->folder_path() + "/map.sqlite3" );
     } else {
         if( !assure_dir_exist( "/maps" ) ) {
             dbg( DL::Error ) << "Unable to create or open world directory structure: " << info->folder_path();
@@ -423,12 +1192,10 @@ world::~world()
         dbg( DL::Error ) << "Save transaction was not committed before world destruction";
     }
 
-    if( map_db ) {
-        sqlite3_close( map_db );
-    }
-
-    if( save_db ) {
-        sqlite3_close( save_db );
+    try {
+        wait_for_pending_saves();
+    } catch( const std::exception &err ) {
+        dbg( DL::Error ) << "Failed to finish saving: " << err.what();
     }
 }
 
@@ -437,16 +1204,34 @@ void world::start_save_tx()
     if( save_tx_start_ts != 0 ) {
         throw std::runtime_error( "Attempted to start a save transaction while one was already in progress" );
     }
+    wait_for_pending_saves();
+
+    zstd_saves = get_option<std::string>( "SAVE_COMPRESSION" ) == "zstd";
+    if( zstd_saves && !zstd_available() ) {
+        dbg( DL::Warn ) << "Zstd save compression is selected, but this build does not support it";
+        zstd_saves = false;
+    }
+    if( map_db ) {
+        map_db->set_zstd( zstd_saves );
+    }
+    if( save_db ) {
+        save_db->set_zstd( zstd_saves );
+    }
+
     save_tx_start_ts = std::chrono::duration_cast< std::chrono::milliseconds >(
                            std::chrono::system_clock::now().time_since_epoch()
                        ).count();
 
     if( map_db ) {
-        sqlite3_exec( map_db, "BEGIN TRANSACTION", NULL, NULL, NULL );
+        map_db->begin();
     }
 
     if( save_db ) {
-        sqlite3_exec( save_db, "BEGIN TRANSACTION", NULL, NULL, NULL );
+        save_db->begin();
+    }
+
+    if( map_db && get_option<bool>( "ASYNC_SAVE" ) ) {
+        async_save = std::make_unique<save_writer>();
     }
 }
 
@@ -456,12 +1241,23 @@ int64_t world::commit_save_tx()
         throw std::runtime_error( "Attempted to commit a save transaction while none was in progress" );
     }
 
-    if( map_db ) {
-        sqlite3_exec( map_db, "COMMIT", NULL, NULL, NULL );
-    }
+    if( async_save ) {
+        std::vector<sqlite_db *> dbs;
+        if( map_db ) {
+            dbs.push_back( map_db.get() );
+        }
+        if( save_db ) {
+            dbs.push_back( save_db.get() );
+        }
+        async_save->commit( std::move( dbs ) );
+    } else {
+        if( map_db ) {
+            map_db->commit();
+        }
 
-    if( save_db ) {
-        sqlite3_exec( save_db, "COMMIT", NULL, NULL, NULL );
+        if( save_db ) {
+            save_db->commit();
+        }
     }
 
     int64_t now = std::chrono::duration_cast< std::chrono::milliseconds >(
@@ -472,6 +1268,27 @@ int64_t world::commit_save_tx()
     return duration;
 }
 
+void world::wait_for_pending_saves()
+{
+    if( async_save ) {
+        // Reset first, so a failed save doesn't get rethrown again
+        std::unique_ptr<save_writer> writer = std::move( async_save );
+        writer->finish();
+    }
+}
+
+bool world::is_saving_in_background() const
+{
+    return async_save && !async_save->is_done();
+}
+
+void world::finish_background_save()
+{
+    if( async_save && async_save->is_done() ) {
+        wait_for_pending_saves();
+    }
+}
+
 /**
  * DOMAIN SPECIFIC: MAP
  */
@@ -487,14 +1304,35 @@ static std::string get_quad_filename( const tripoint &om_addr )
     return string_format( "%d.%d.%d.map", om_addr.x, om_addr.y, om_addr.z );
 }
 
-bool world::read_map_quad( const tripoint &om_addr, file_read_json_fn reader ) const
+bool world::read_map_quad( const tripoint &om_addr, file_read_json_fn reader,
+                           file_read_fn binary_quad_reader ) const
 {
     const std::string dirname = get_quad_dirname( om_addr );
     std::string quad_path = dirname + "/" + get_quad_filename( om_addr );
 
     // V2 logic
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
-        return read_from_db_json( map_db, quad_path, reader, true );
+        std::optional<map_quad_prefetcher::quad_data> quad;
+        if( prefetcher ) {
+            quad = prefetcher->take( om_addr );
+        }
+        if( !quad ) {
+            wait_for_queued_writes();
+            quad.emplace();
+            quad->data = map_db->read( quad_path, true, &quad->binary );
+        }
+        if( !quad->data ) {
+            return false;
+        }
+
+        std::istringstream stream( *quad->data );
+        if( quad->binary ) {
+            binary_quad_reader( stream );
+        } else {
+            JsonIn jsin( stream, quad_path );
+            reader( jsin );
+        }
+        return true;
     } else {
         if( !file_exist( quad_path ) ) {
             // Fix for old saves where the path was generated using std::stringstream, which
@@ -512,21 +1350,74 @@ bool world::read_map_quad( const tripoint &om_addr, file_read_json_fn reader ) c
     }
 }
 
-bool world::write_map_quad( const tripoint &om_addr, file_write_fn writer ) const
+void world::prefetch_map_quads( const std::vector<tripoint> &om_addrs )
+{
+    if( info->world_save_format != save_format::V2_COMPRESSED_SQLITE3 ) {
+        return;
+    }
+    // The database doesn't have the files queued for writing yet, reading them now would
+    // get the old versions. Once the save is written, writing a quad forgets its prefetch.
+    if( save_tx_start_ts != 0 || ( async_save && !async_save->is_idle() ) ) {
+        return;
+    }
+    if( !prefetcher ) {
+        prefetcher = std::make_unique<map_quad_prefetcher>( *map_db );
+    }
+
+    std::vector<std::pair<tripoint, std::string>> quads;
+    quads.reserve( om_addrs.size() );
+    for( const tripoint &om_addr : om_addrs ) {
+        quads.emplace_back( om_addr, get_quad_dirname( om_addr ) + "/" + get_quad_filename( om_addr ) );
+    }
+    prefetcher->request( std::move( quads ) );
+}
+
+bool world::write_map_quad( const tripoint &om_addr, file_write_fn writer, bool binary ) const
 {
     const std::string dirname = get_quad_dirname( om_addr );
     std::string quad_path = dirname + "/" + get_quad_filename( om_addr );
 
     // V2 logic
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
-        write_to_db( map_db, quad_path, writer );
+        if( prefetcher ) {
+            prefetcher->forget( om_addr );
+        }
+        write_to_db( *map_db, quad_path, writer, binary );
         return true;
     } else {
+        if( binary ) {
+            throw std::runtime_error( "Binary map quads need a V2 world" );
+        }
         assure_dir_exist( dirname );
         return write_to_file( quad_path, writer );
     }
 }
 
+bool world::supports_binary_map_quads() const
+{
+    return info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 &&
+           get_option<bool>( "BINARY_MAP_SAVES" );
+}
+
+std::vector<tripoint> world::list_json_map_quads() const
+{
+    std::vector<tripoint> quads;
+    if( info->world_save_format != save_format::V2_COMPRESSED_SQLITE3 ) {
+        return quads;
+    }
+
+    wait_for_queued_writes();
+    for( const std::string &path : map_db->json_paths( "maps/" ) ) {
+        const std::string filename = path.substr( path.find_last_of( '/' ) + 1 );
+        tripoint om_addr;
+        if( std::sscanf( filename.c_str(), "%d.%d.%d.map", &om_addr.x, &om_addr.y,
+                         &om_addr.z ) == 3 ) {
+            quads.push_back( om_addr );
+        }
+    }
+    return quads;
+}
+
 /**
  * DOMAIN SPECIFIC: OVERMAP
  */
@@ -544,7 +1435,8 @@ std::string world::overmap_player_filename( const point_abs_om &p ) const
 bool world::overmap_exists( const point_abs_om &p ) const
 {
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
-        return file_exist_in_db( map_db, overmap_terrain_filename( p ) );
+        wait_for_queued_writes();
+        return file_exist_in_db( *map_db, overmap_terrain_filename( p ) );
     } else {
         return file_exist( overmap_terrain_filename( p ) );
     }
@@ -553,7 +1445,8 @@ bool world::overmap_exists( const point_abs_om &p ) const
 bool world::read_overmap( const point_abs_om &p, file_read_fn reader ) const
 {
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
-        return read_from_db( map_db, overmap_terrain_filename( p ), reader, true );
+        wait_for_queued_writes();
+        return read_from_db( *map_db, overmap_terrain_filename( p ), reader, true );
     } else {
         return read_from_file( overmap_terrain_filename( p ), reader, true );
     }
@@ -562,7 +1455,8 @@ bool world::read_overmap( const point_abs_om &p, file_read_fn reader ) const
 bool world::read_overmap_player_visibility( const point_abs_om &p, file_read_fn reader )
 {
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
-        sqlite3 *playerdb = get_player_db();
+        sqlite_db &playerdb = get_player_db();
+        wait_for_queued_writes();
         return read_from_db( playerdb, overmap_player_filename( p ), reader, true );
     } else {
         return read_from_player_file( overmap_player_filename( p ), reader, true );
@@ -572,7 +1466,7 @@ bool world::read_overmap_player_visibility( const point_abs_om &p, file_read_fn
 bool world::write_overmap( const point_abs_om &p, file_write_fn writer ) const
 {
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
-        write_to_db( map_db, overmap_terrain_filename( p ), writer );
+        write_to_db( *map_db, overmap_terrain_filename( p ), writer );
         return true;
     } else {
         return write_to_file( overmap_terrain_filename( p ), writer );
@@ -582,7 +1476,7 @@ bool world::write_overmap( const point_abs_om &p, file_write_fn writer ) const
 bool world::write_overmap_player_visibility( const point_abs_om &p, file_write_fn writer )
 {
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
-        sqlite3 *playerdb = get_player_db();
+        sqlite_db &playerdb = get_player_db();
         write_to_db( playerdb, overmap_player_filename( p ), writer );
         return true;
     } else {
@@ -601,7 +1495,8 @@ static std::string get_mm_filename( const tripoint &p )
 bool world::read_player_mm_quad( const tripoint &p, file_read_json_fn reader )
 {
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
-        sqlite3 *playerdb = get_player_db();
+        sqlite_db &playerdb = get_player_db();
+        wait_for_queued_writes();
         return read_from_db_json( playerdb, get_mm_filename( p ), reader, true );
     } else {
         return read_from_player_file_json( ".mm1/" + get_mm_filename( p ), reader, true );
@@ -611,7 +1506,7 @@ bool world::read_player_mm_quad( const tripoint &p, file_read_json_fn reader )
 bool world::write_player_mm_quad( const tripoint &p, file_write_fn writer )
 {
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
-        sqlite3 *playerdb = get_player_db();
+        sqlite_db &playerdb = get_player_db();
         write_to_db( playerdb, get_mm_filename( p ), writer );
         return true;
     } else {
@@ -633,22 +1528,29 @@ std::string world::get_player_path() const
     return base64_encode( g->u.get_save_id() );
 }
 
-sqlite3 *world::get_player_db()
+sqlite_db &world::get_player_db()
 {
     if( !save_db ) {
-        save_db = open_db( info->folder_path() + "/" + get_player_path() + ".sqlite3" );
+        save_db = std::make_unique<sqlite_db>( info->folder_path() + "/" + get_player_path() + ".sqlite3" );
+        save_db->set_zstd( zstd_saves );
         last_save_id = g->u.get_save_id();
     }
 
     if( last_save_id != g->u.get_save_id() ) {
+        // Nothing queued may refer to the db that is about to be replaced, and neither may
+        //   a commit the writer has yet to get to
+        wait_for_queued_writes();
+        // Recent commits may still only be in the write-ahead log next to the db file
+        save_db->checkpoint();
         copy_file(
             info->folder_path() + "/" + base64_encode( last_save_id ) + ".sqlite3",
             info->folder_path() + "/" + base64_encode( g->u.get_save_id() ) + ".sqlite3"
         );
-        save_db = open_db( info->folder_path() + "/" + get_player_path() + ".sqlite3" );
+        save_db = std::make_unique<sqlite_db>( info->folder_path() + "/" + get_player_path() + ".sqlite3" );
+        save_db->set_zstd( zstd_saves );
     }
 
-    return save_db;
+    return *save_db;
 }
 
 bool world::player_file_exist( const std::string &path )
@@ -725,10 +1627,10 @@ void world::convert_from_v1( const std::unique_ptr<WORLDINFO> &old_world )
     // The map database should already be loaded via the constructor.
     // The save database(s) will need to be created separately here.
     // Transactions are mostly being used for performance reasons rather than consistency.
-    sqlite3_exec( map_db, "BEGIN TRANSACTION", NULL, NULL, NULL );
+    map_db->begin();
 
     // Keep track of the last used save DB
-    sqlite3 *last_save_db = nullptr;
+    std::unique_ptr<sqlite_db> last_save_db;
     std::string last_save_id;
 
     // Begin copying files to the new world folder.
@@ -752,7 +1654,7 @@ void world::convert_from_v1( const std::unique_ptr<WORLDINFO> &old_world )
                     continue;
                 }
                 ::read_from_file( subpath, [&]( std::istream & fin ) {
-                    write_to_db( map_db, map_path, [&]( std::ostream & fout ) {
+                    write_to_db( *map_db, map_path, [&]( std::ostream & fout ) {
                         fout << fin.rdbuf();
                     } );
                 } );
@@ -763,7 +1665,7 @@ void world::convert_from_v1( const std::unique_ptr<WORLDINFO> &old_world )
         // Migrate o.* files into the map database
         if( part.starts_with( "o." ) ) {
             ::read_from_file( file_path, [&]( std::istream & fin ) {
-                write_to_db( map_db, part, [&]( std::ostream & fout ) {
+                write_to_db( *map_db, part, [&]( std::ostream & fout ) {
                     fout << fin.rdbuf();
                 } );
             } );
@@ -775,17 +1677,16 @@ void world::convert_from_v1( const std::unique_ptr<WORLDINFO> &old_world )
             auto save_id = part.substr( 0, part.find( '.' ) );
             if( save_id != last_save_id ) {
                 if( last_save_db ) {
-                    sqlite3_exec( last_save_db, "COMMIT", NULL, NULL, NULL );
-                    sqlite3_close( last_save_db );
+                    last_save_db->commit();
                 }
-                last_save_db = open_db( info->folder_path() + "/" + save_id + ".sqlite3" );
+                last_save_db = std::make_unique<sqlite_db>( info->folder_path() + "/" + save_id + ".sqlite3" );
                 last_save_id = save_id;
-                sqlite3_exec( last_save_db, "BEGIN TRANSACTION", NULL, NULL, NULL );
+                last_save_db->begin();
             }
 
             if( part.find( ".seen." ) != std::string::npos ) {
                 ::read_from_file( file_path, [&]( std::istream & fin ) {
-                    write_to_db( last_save_db, part.substr( save_id.size() ), [&]( std::ostream & fout ) {
+                    write_to_db( *last_save_db, part.substr( save_id.size() ), [&]( std::ostream & fout ) {
                         fout << fin.rdbuf();
                     } );
                 } );
@@ -799,7 +1700,7 @@ void world::convert_from_v1( const std::unique_ptr<WORLDINFO> &old_world )
                         continue;
                     }
                     ::read_from_file( subpath, [&]( std::istream & fin ) {
-                        write_to_db( last_save_db, map_path, [&]( std::ostream & fout ) {
+                        write_to_db( *last_save_db, map_path, [&]( std::ostream & fout ) {
                             fout << fin.rdbuf();
                         } );
                     } );
@@ -816,9 +1717,8 @@ void world::convert_from_v1( const std::unique_ptr<WORLDINFO> &old_world )
     }
 
     if( last_save_db ) {
-        sqlite3_exec( last_save_db, "COMMIT", NULL, NULL, NULL );
-        sqlite3_close( last_save_db );
+        last_save_db->commit();
     }
 
-    sqlite3_exec( map_db, "COMMIT", NULL, NULL, NULL );
+    map_db->commit();
 }
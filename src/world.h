@@ -1,7 +1,9 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 #include "json.h"
 #include "options.h"
 #include "type_id.h"
@@ -9,7 +11,9 @@
 #include "fstream_utils.h"
 
 class avatar;
-class sqlite3;
+class map_quad_prefetcher;
+class save_writer;
+class sqlite_db;
 
 class save_t
 {
@@ -103,13 +107,41 @@ class world
         int64_t commit_save_tx();
         /**@}*/
 
+        /**
+         * With the ASYNC_SAVE option, files written during a save transaction are
+         * compressed and stored on a background thread, and commit_save_tx returns
+         * before they are on disk. This blocks until the last save is complete.
+         */
+        void wait_for_pending_saves();
+        /** Whether the last save is still being written on the background thread. */
+        bool is_saving_in_background() const;
+        /**
+         * Cleans up after the last background save once it is on disk, without blocking.
+         * Rethrows the error it ran into, if any. Called every turn so that a failed save
+         * is reported right after it happens instead of at the next save.
+         */
+        void finish_background_save();
+
         /*
          * Targeted/domain-specific file operations. Different save formats may choose to
          * lay out files differently, so centralize file placement logic here rather than
          * scattering it throughout the codebase.
          */
-        bool read_map_quad( const tripoint &om_addr, file_read_json_fn reader ) const;
-        bool write_map_quad( const tripoint &om_addr, file_write_fn writer ) const;
+        /** Quads stored in the binary map format are passed to @p binary_quad_reader instead. */
+        bool read_map_quad( const tripoint &om_addr, file_read_json_fn reader,
+                            file_read_fn binary_quad_reader ) const;
+        /** @param binary The quad is in the binary map format, see @ref supports_binary_map_quads */
+        bool write_map_quad( const tripoint &om_addr, file_write_fn writer, bool binary = false ) const;
+        /**
+         * Starts reading the map quads at @p om_addrs in the background, nearest first, so
+         * a later @ref read_map_quad of them only has to parse them. Replaces the quads
+         * requested before. Does nothing for V1 worlds or while a save is being written.
+         */
+        void prefetch_map_quads( const std::vector<tripoint> &om_addrs );
+        /** Whether map quads can be written in the binary format, which needs a V2 world. */
+        bool supports_binary_map_quads() const;
+        /** Saved map quads that are still stored as JSON. */
+        std::vector<tripoint> list_json_map_quads() const;
 
         bool overmap_exists( const point_abs_om &p ) const;
         bool read_overmap( const point_abs_om &p, file_read_fn reader ) const;
@@ -171,11 +203,23 @@ class world
         std::string overmap_player_filename( const point_abs_om &p ) const;
         std::string get_player_path() const;
 
-        sqlite3 *map_db = nullptr;
+        std::unique_ptr<sqlite_db> map_db;
 
-        sqlite3 *save_db = nullptr;
+        std::unique_ptr<sqlite_db> save_db;
         std::string last_save_id = "";
-        sqlite3 *get_player_db();
+        /** Whether the current save compresses with zstd, see the SAVE_COMPRESSION world option. */
+        bool zstd_saves = false;
+        sqlite_db &get_player_db();
+
+        /** Writes the save in progress, if saving in the background. */
+        std::unique_ptr<save_writer> async_save;
+        void write_to_db( sqlite_db &db, const std::string &path, file_write_fn writer,
+                          bool binary = false ) const;
+        /** Reads must see the files queued for writing, so let the writer catch up first. */
+        void wait_for_queued_writes() const;
+
+        /** Reads map quads ahead of time, see @ref prefetch_map_quads. Goes before map_db does. */
+        std::unique_ptr<map_quad_prefetcher> prefetcher;
 };
 
 
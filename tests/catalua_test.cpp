@@ -878,10 +878,10 @@ static auto init_test_lua_hook_state( cata::lua_state &state ) -> void
 
     sol::table cata_tbl = lua.create_table();
     cata_tbl.set_function( "run_hooks", [&state]( const std::string & name ) -> sol::table {
-        return cata::run_hooks( name, nullptr, { .state = &state } );
+        return cata::run_hooks( cata::hook_id{ name }, nullptr, { .state = &state } );
     } );
     cata_tbl.set_function( "run_hooks_exit_early", [&state]( const std::string & name ) -> sol::table {
-        return cata::run_hooks( name, nullptr, { .exit_early = true, .state = &state } );
+        return cata::run_hooks( cata::hook_id{ name }, nullptr, { .exit_early = true, .state = &state } );
     } );
     lua.globals()["cata"] = cata_tbl;
 }
@@ -929,3 +929,30 @@ TEST_CASE( "lua_hooks_exit_early", "[lua]" )
     CHECK( results_tbl.get<bool>( "allowed" ) == false );
     CHECK( log_tbl.get<sol::optional<std::string>>( 2 ) == sol::nullopt );
 }
+
+TEST_CASE( "lua_hooks_without_entries_skip_params", "[lua]" )
+{
+    cata::lua_state state;
+    state.lua = make_lua_state();
+    sol::state &lua = state.lua;
+    lua.globals()["game"] = lua.create_table();
+    cata::define_hooks( state );
+
+    int inits = 0;
+    const auto count_init = [&inits]( sol::table & ) {
+        inits++;
+    };
+
+    const sol::table skipped = cata::run_hooks( "on_shoot", count_init, { .state = &state } );
+    CHECK( inits == 0 );
+    CHECK( skipped.get_or( "allowed", false ) );
+
+    run_lua_script( lua, "tests/lua/hooks_skip_test.lua" );
+
+    cata::run_hooks( "on_shoot", count_init, { .state = &state } );
+    CHECK( inits == 1 );
+    CHECK( lua.globals()["shots_seen"].get<int>() == 1 );
+    CHECK( lua.globals()["hook_lists_seen"].get<size_t>() == cata::hook_names.size() );
+    cata::run_hooks( "on_throw", count_init, { .state = &state } );
+    CHECK( inits == 1 );
+}
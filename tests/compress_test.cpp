@@ -0,0 +1,62 @@
+#include "catch/catch.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "compress.h"
+#include "string_formatter.h"
+
+static std::string sample_quad( int i )
+{
+    return string_format( R"([{"version":33,"coordinates":[%d,%d,0],"terrain":[["t_dirt",%d],)"
+                          R"("t_floor","t_wall"],"items":[%d,%d,[{"typeid":"rock"}]]}])", i, i * 7, 100 + i % 40,
+                          i % 12, i % 5 );
+}
+
+TEST_CASE( "zlib_blobs_roundtrip", "[compress]" )
+{
+    const std::string input = sample_quad( 3 );
+    std::vector<std::byte> compressed;
+    zlib_compress( input, compressed );
+    std::string output;
+    zlib_decompress( compressed.data(), compressed.size(), output );
+    CHECK( output == input );
+}
+
+TEST_CASE( "zstd_blobs_roundtrip_with_dictionary", "[compress]" )
+{
+    if( !zstd_available() ) {
+        std::vector<std::byte> compressed;
+        CHECK_THROWS( zstd_compress( sample_quad( 0 ), compressed ) );
+        return;
+    }
+
+    std::vector<std::string> samples;
+    for( int i = 0; i < 500; i++ ) {
+        samples.push_back( sample_quad( i ) );
+    }
+    const std::vector<std::byte> trained = zstd_train_dictionary( samples );
+    REQUIRE_FALSE( trained.empty() );
+    std::shared_ptr<const zstd_dictionary> dictionary = zstd_load_dictionary( trained.data(),
+            trained.size() );
+
+    const std::string input = sample_quad( 1000 );
+    std::vector<std::byte> plain;
+    std::vector<std::byte> with_dictionary;
+    zstd_compress( input, plain );
+    zstd_compress( input, with_dictionary, dictionary.get() );
+    CHECK( with_dictionary.size() < plain.size() );
+    CHECK( zstd_blob_dictionary_id( plain.data(), plain.size() ) == 0 );
+    CHECK( zstd_blob_dictionary_id( with_dictionary.data(), with_dictionary.size() ) ==
+           zstd_dictionary_id( *dictionary ) );
+
+    std::string output;
+    zstd_decompress( plain.data(), plain.size(), output );
+    CHECK( output == input );
+    zstd_decompress( with_dictionary.data(), with_dictionary.size(), output, dictionary.get() );
+    CHECK( output == input );
+
+    CHECK( zstd_train_dictionary( { input } ).empty() );
+}
@@ -35,6 +35,7 @@
 #include "requirements.h"
 #include "state_helpers.h"
 #include "string_id.h"
+#include "string_utils.h"
 #include "type_id.h"
 #include "value_ptr.h"
 
@@ -128,6 +129,48 @@ TEST_CASE( "recipe_subset" )
     }
 }
 
+TEST_CASE( "recipe_subset_search_matches_plain_text_search", "[crafting][recipes]" )
+{
+    recipe_subset subset;
+    for( const auto &e : recipe_dict ) {
+        subset.include( &e.second );
+    }
+    REQUIRE( subset.size() > 0 );
+
+    const auto has_component = []( const recipe * r, const std::string & txt ) {
+        for( const std::vector<item_comp> &opts : r->simple_requirements().get_components() ) {
+            for( const item_comp &ic : opts ) {
+                if( lcmatch( item::nname( ic.type ), txt ) ) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    // Short queries skip the trigram lookup, the last one can't match anything
+    for( const std::string txt : {
+             "", "a", "Ro", "rope", "ROPE", "ed s", "zzqx"
+         } ) {
+        CAPTURE( txt );
+        std::vector<const recipe *> by_name;
+        std::vector<const recipe *> by_component;
+        for( const recipe *r : subset ) {
+            if( !*r || r->obsolete ) {
+                continue;
+            }
+            if( lcmatch( r->result_name( /*decorated=*/true ), txt ) ) {
+                by_name.push_back( r );
+            }
+            if( has_component( r, txt ) ) {
+                by_component.push_back( r );
+            }
+        }
+        CHECK( subset.search( txt ) == by_name );
+        CHECK( subset.search( txt, recipe_subset::search_type::component ) == by_component );
+    }
+}
+
 TEST_CASE( "available_recipes", "[recipes]" )
 {
     clear_all_state();
@@ -779,3 +822,36 @@ TEST_CASE( "tool selection ui", "[crafting][ui]" )
         }
     }
 }
+
+TEST_CASE( "crafting_inventory_follows_nearby_items", "[crafting]" )
+{
+    clear_all_state();
+    map &m = get_map();
+    avatar &u = get_avatar();
+    const tripoint start_pos( 60, 60, 0 );
+    u.setpos( start_pos );
+    clear_avatar();
+    const itype_id hammer( "hammer" );
+    const tripoint nearby = start_pos + point_east;
+
+    REQUIRE_FALSE( u.crafting_inventory().has_amount( hammer, 1 ) );
+
+    // No invalidation, the next action alone has to pick up the changes
+    m.add_item( nearby, item::spawn( hammer ) );
+    u.mod_moves( -100 );
+    CHECK( u.crafting_inventory().has_amount( hammer, 1 ) );
+    CHECK( u.crafting_inventory().get_quality_cache().contains( quality_id( "HAMMER" ) ) );
+
+    u.mod_moves( -100 );
+    CHECK( u.crafting_inventory().has_amount( hammer, 1 ) );
+
+    m.i_clear( nearby );
+    u.mod_moves( -100 );
+    CHECK_FALSE( u.crafting_inventory().has_amount( hammer, 1 ) );
+    CHECK_FALSE( u.crafting_inventory().get_quality_cache().contains( quality_id( "HAMMER" ) ) );
+
+    m.add_item( nearby, item::spawn( hammer ) );
+    m.furn_set( nearby, furn_str_id( "f_chair" ) );
+    u.mod_moves( -100 );
+    CHECK( u.crafting_inventory().has_amount( hammer, 1 ) );
+}
@@ -0,0 +1,56 @@
+#include "catch/catch.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "creature_tracker.h"
+#include "game.h"
+#include "map_helpers.h"
+#include "mapdata.h"
+#include "monster.h"
+#include "point.h"
+#include "state_helpers.h"
+
+static bool contains( const std::vector<monster *> &monsters, const monster &mon )
+{
+    return std::ranges::find( monsters, &mon ) != monsters.end();
+}
+
+TEST_CASE( "creature_tracker_radius_queries_follow_monsters", "[creature_tracker]" )
+{
+    clear_all_state();
+    build_test_map( t_floor );
+    const Creature_tracker &tracker = *g->critter_tracker;
+
+    const tripoint center( 60, 60, 0 );
+    monster &near = spawn_test_monster( "mon_zombie", center + point( 3, 0 ) );
+    monster &mid = spawn_test_monster( "mon_zombie", center + point( -10, 7 ) );
+    monster &far = spawn_test_monster( "mon_zombie", center + point( 30, -30 ) );
+
+    SECTION( "radius query uses square distance" ) {
+        const std::vector<monster *> found = tracker.find_in_radius( center, 10 );
+        CHECK( found.size() == 2 );
+        CHECK( contains( found, near ) );
+        CHECK( contains( found, mid ) );
+        CHECK_FALSE( contains( found, far ) );
+        CHECK( tracker.find_in_radius( center + tripoint_above, 10 ).empty() );
+        CHECK( tracker.find_in_radius( center + tripoint_above, 10, 1 ).size() == 2 );
+    }
+
+    SECTION( "moved monsters are found at their new position" ) {
+        far.setpos( center + point( 0, 2 ) );
+        near.setpos( center + point( 40, 40 ) );
+        const std::vector<monster *> found = tracker.find_in_radius( center, 10 );
+        CHECK( found.size() == 2 );
+        CHECK( contains( found, far ) );
+        CHECK( contains( found, mid ) );
+        CHECK_FALSE( contains( found, near ) );
+    }
+
+    SECTION( "dead monsters are not returned" ) {
+        mid.die( nullptr );
+        const std::vector<monster *> found = tracker.find_in_radius( center, 10 );
+        CHECK( found.size() == 1 );
+        CHECK( contains( found, near ) );
+    }
+}
@@ -0,0 +1,67 @@
+#include "catch/catch.hpp"
+
+#include <vector>
+
+#include "game_constants.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "mapdata.h"
+#include "point.h"
+#include "shadowcasting.h"
+#include "state_helpers.h"
+
+static const tripoint lamp( 40, 40, 0 );
+static const tripoint gap = lamp + point( 4, 0 );
+static const tripoint behind_gap = lamp + point( 10, 0 );
+
+static void build_lamp_room()
+{
+    map &here = get_map();
+    for( int d = -4; d <= 4; d++ ) {
+        here.ter_set( lamp + point( d, -4 ), t_wall );
+        here.ter_set( lamp + point( d, 4 ), t_wall );
+        here.ter_set( lamp + point( -4, d ), t_wall );
+        here.ter_set( lamp + point( 4, d ), t_wall );
+    }
+    here.ter_set( lamp, t_utility_light );
+    here.ter_set( lamp + point( 2, 2 ), t_utility_light );
+    // Outside of the room, so it is never affected by the wall
+    here.ter_set( lamp + point( 30, 30 ), t_utility_light );
+}
+
+static std::vector<four_quadrants> copy_lightmap()
+{
+    const level_cache &cache = get_map().get_cache_ref( 0 );
+    return std::vector<four_quadrants>( &cache.lm[0][0], &cache.lm[0][0] + MAPSIZE_X * MAPSIZE_Y );
+}
+
+TEST_CASE( "lightmap_reuses_light_sources_only_while_unchanged", "[lightmap]" )
+{
+    map &here = get_map();
+
+    clear_all_state();
+    build_lamp_room();
+    here.ter_set( gap, t_floor );
+    here.build_map_cache( 0 );
+    const std::vector<four_quadrants> expected = copy_lightmap();
+
+    clear_all_state();
+    build_lamp_room();
+    here.build_map_cache( 0 );
+    const float dark = here.ambient_light_at( behind_gap );
+    here.build_map_cache( 0 );
+    CHECK( here.ambient_light_at( behind_gap ) == dark );
+
+    here.ter_set( gap, t_floor );
+    here.build_map_cache( 0 );
+    CHECK( here.ambient_light_at( behind_gap ) > dark );
+
+    const std::vector<four_quadrants> actual = copy_lightmap();
+    int mismatches = 0;
+    for( size_t i = 0; i < actual.size(); i++ ) {
+        if( actual[i].values != expected[i].values ) {
+            mismatches++;
+        }
+    }
+    CHECK( mismatches == 0 );
+}
@@ -0,0 +1,50 @@
+#include "catch/catch.hpp"
+
+#include <optional>
+
+#include "los_cache.h"
+#include "point.h"
+
+TEST_CASE( "los_cache_remembers_pairs_until_invalidated", "[map][vision]" )
+{
+    const tripoint a( 10, 20, 0 );
+    const tripoint b( 40, 25, 1 );
+    const tripoint c( 41, 25, 1 );
+
+    los_cache cache;
+    cache.insert( a, b, true );
+    CHECK_FALSE( cache.get( a, b ) );
+
+    cache.invalidate();
+    cache.insert( a, b, true );
+    cache.insert( a, c, false );
+    CHECK( cache.get( a, b ) == std::optional<bool>( true ) );
+    CHECK( cache.get( b, a ) == std::optional<bool>( true ) );
+    CHECK( cache.get( c, a ) == std::optional<bool>( false ) );
+    CHECK_FALSE( cache.get( b, c ) );
+    CHECK( cache.current_stats().hits == 3 );
+    CHECK( cache.current_stats().misses == 1 );
+
+    SECTION( "squares outside of the packable range aren't cached" ) {
+        const tripoint outside( -1, 20, 0 );
+        cache.insert( outside, b, true );
+        CHECK_FALSE( cache.get( outside, b ) );
+    }
+
+    SECTION( "invalidating forgets everything" ) {
+        cache.invalidate();
+        CHECK_FALSE( cache.get( a, b ) );
+        CHECK( cache.current_stats().hits == 0 );
+        cache.insert( a, b, false );
+        CHECK( cache.get( a, b ) == std::optional<bool>( false ) );
+    }
+
+    SECTION( "generations wrap around" ) {
+        for( int i = 0; i < 40000; i++ ) {
+            cache.invalidate();
+        }
+        CHECK_FALSE( cache.get( a, b ) );
+        cache.insert( a, c, true );
+        CHECK( cache.get( c, a ) == std::optional<bool>( true ) );
+    }
+}
@@ -0,0 +1,14 @@
+shots_seen = 0
+
+-- appending straight to the list has to be noticed as well, not only game.add_hook
+table.insert(game.hooks.on_shoot, function(params)
+  shots_seen = shots_seen + 1
+end)
+
+-- game.hooks is a proxy, pairs() still has to see every hook list
+hook_lists_seen = 0
+for _, list in pairs(game.hooks) do
+  if type(list) == "table" then
+    hook_lists_seen = hook_lists_seen + 1
+  end
+end
@@ -0,0 +1,117 @@
+#include "catch/catch.hpp"
+
+#include <vector>
+
+#include "cached_options.h"
+#include "cata_utility.h"
+#include "game_constants.h"
+#include "map.h"
+#include "mapdata.h"
+#include "point.h"
+#include "state_helpers.h"
+#include "type_id.h"
+#include "weather.h"
+
+struct level_snapshot {
+    std::vector<bool> outside;
+    std::vector<bool> floor;
+    std::vector<float> transparency;
+};
+
+static void build_layered_terrain()
+{
+    map &here = get_map();
+    for( int z = -2; z <= 2; z++ ) {
+        for( int x = 20; x < 100; x += 7 ) {
+            for( int y = 20; y < 100; y += 3 ) {
+                here.ter_set( tripoint( x, y, z ), ( x + y + z ) % 2 == 0 ? t_wall : t_open_air );
+            }
+        }
+    }
+    here.add_field( tripoint( 60, 60, 0 ), field_type_id( "fd_smoke" ), 3 );
+}
+
+static std::vector<level_snapshot> rebuild_all_levels()
+{
+    map &here = get_map();
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+        here.invalidate_map_cache( z );
+    }
+    here.build_map_cache( 0, true );
+
+    std::vector<level_snapshot> levels;
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+        const level_cache &cache = here.get_cache_ref( z );
+        level_snapshot &level = levels.emplace_back();
+        level.outside.assign( &cache.outside_cache[0][0],
+                              &cache.outside_cache[0][0] + MAPSIZE_X * MAPSIZE_Y );
+        level.floor.assign( &cache.floor_cache[0][0],
+                            &cache.floor_cache[0][0] + MAPSIZE_X * MAPSIZE_Y );
+        level.transparency.assign( &cache.transparency_cache[0][0],
+                                   &cache.transparency_cache[0][0] + MAPSIZE_X * MAPSIZE_Y );
+    }
+    return levels;
+}
+
+static int count_levels_built_differently_in_parallel()
+{
+    parallel_map_cache = false;
+    const std::vector<level_snapshot> serial = rebuild_all_levels();
+    parallel_map_cache = true;
+    const std::vector<level_snapshot> parallel = rebuild_all_levels();
+
+    REQUIRE( serial.size() == parallel.size() );
+    int mismatched_levels = 0;
+    for( size_t i = 0; i < serial.size(); i++ ) {
+        if( serial[i].outside != parallel[i].outside || serial[i].floor != parallel[i].floor ||
+            serial[i].transparency != parallel[i].transparency ) {
+            mismatched_levels++;
+        }
+    }
+    return mismatched_levels;
+}
+
+TEST_CASE( "parallel_map_cache_matches_serial_build", "[map][lightmap]" )
+{
+    restore_on_out_of_scope<bool> restore_parallel( parallel_map_cache );
+    restore_on_out_of_scope<unsigned> restore_task_count( map_cache_task_count );
+    clear_all_state();
+    restore_on_out_of_scope<weather_type_id> restore_weather( get_weather().weather_id );
+    build_layered_terrain();
+    // Split the levels even if this machine has a single core
+    map_cache_task_count = 4;
+
+    SECTION( "in clear weather" ) {
+        get_weather().weather_id = weather_type_id( "clear" );
+        CHECK( count_levels_built_differently_in_parallel() == 0 );
+    }
+    SECTION( "in weather that limits sight outside" ) {
+        get_weather().weather_id = weather_type_id( "heavy_rain" );
+        CHECK( count_levels_built_differently_in_parallel() == 0 );
+    }
+}
+
+TEST_CASE( "map_cache_rebuild_benchmark", "[.][map][benchmark]" )
+{
+    restore_on_out_of_scope<bool> restore_parallel( parallel_map_cache );
+    clear_all_state();
+    build_layered_terrain();
+    map &here = get_map();
+
+    const auto rebuild = [&here]() {
+        for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+            here.invalidate_map_cache( z );
+        }
+        here.build_map_cache( 0, true );
+        return here.get_cache_ref( 0 ).floor_cache[0][0];
+    };
+
+    parallel_map_cache = false;
+    BENCHMARK( "serial" ) {
+        return rebuild();
+    };
+    parallel_map_cache = true;
+    BENCHMARK( "parallel" ) {
+        return rebuild();
+    };
+}
@@ -10,6 +10,7 @@
 #include "lru_cache.h"
 #include "map.h"
 #include "map_memory.h"
+#include "memory_fast.h"
 #include "point.h"
 #include "string_formatter.h"
 
@@ -75,7 +76,72 @@ TEST_CASE( "map_memory_forgets", "[map_memory]" )
     memory.memorize_symbol( p3, 1 );
 }
 
-// TODO: map memory save / load
+static mm_region make_test_region()
+{
+    mm_region region;
+    for( auto &column : region.submaps ) {
+        for( shared_ptr_fast<mm_submap> &sm : column ) {
+            sm = make_shared_fast<mm_submap>();
+        }
+    }
+    region.submaps[0][0]->set_tile( point( 1, 2 ), { memorized_tile_name( "t_dirt" ), 0, 0 } );
+    region.submaps[0][0]->set_tile( point( 2, 2 ), { memorized_tile_name( "t_dirt" ), 0, 0 } );
+    region.submaps[0][0]->set_tile( point( 3, 2 ), { memorized_tile_name( "t_wall" ), 3, 1 } );
+    region.submaps[1][0]->set_symbol( point( 4, 4 ), '#' );
+    return region;
+}
+
+static void check_test_region( const mm_region &region )
+{
+    const mm_submap &first = *region.submaps[0][0];
+    CHECK( first.tile( point( 1, 2 ) ).tile.str() == "t_dirt" );
+    CHECK( first.tile( point( 2, 2 ) ).tile == memorized_tile_name( "t_dirt" ) );
+    CHECK( first.tile( point( 3, 2 ) ) ==
+           memorized_terrain_tile{ memorized_tile_name( "t_wall" ), 3, 1 } );
+    CHECK( first.tile( point( 4, 2 ) ) == mm_submap::default_tile );
+    CHECK( region.submaps[1][0]->symbol( point( 4, 4 ) ) == '#' );
+    CHECK( region.submaps[1][0]->tile( point( 4, 4 ) ) == mm_submap::default_tile );
+    CHECK( region.submaps[1][1]->is_empty() );
+}
+
+TEST_CASE( "map_memory_region_roundtrip", "[map_memory]" )
+{
+    const mm_region region = make_test_region();
+    std::ostringstream out;
+    JsonOut jsout( out );
+    region.serialize( jsout );
+
+    // Names are only spelled out once
+    const std::string saved = out.str();
+    CHECK( saved.find( "t_dirt" ) == saved.rfind( "t_dirt" ) );
+
+    std::istringstream in( saved );
+    JsonIn jsin( in );
+    mm_region loaded;
+    loaded.deserialize( jsin );
+    check_test_region( loaded );
+}
+
+TEST_CASE( "map_memory_region_reads_per_tile_names", "[map_memory]" )
+{
+    // The format used before regions had a name table
+    std::string legacy = "[";
+    for( int i = 0; i < MM_REG_SIZE * MM_REG_SIZE; i++ ) {
+        if( i == 0 ) {
+            legacy += R"([["",0,0,0,25],["t_dirt",0,0,0,2],["t_wall",3,1,0],["",0,0,0,116]])";
+        } else if( i == 1 ) {
+            legacy += R"([["",0,0,0,52],["",0,0,35],["",0,0,0,91]])";
+        } else {
+            legacy += "null";
+        }
+        legacy += i + 1 < MM_REG_SIZE * MM_REG_SIZE ? "," : "]";
+    }
+    std::istringstream in( legacy );
+    JsonIn jsin( in );
+    mm_region loaded;
+    loaded.deserialize( jsin );
+    check_test_region( loaded );
+}
 
 #include <chrono>
 
@@ -0,0 +1,58 @@
+#include "catch/catch.hpp"
+
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "game.h"
+#include "json.h"
+#include "point.h"
+#include "world.h"
+
+static void write_quad( world &w, const tripoint &om_addr, const std::string &contents )
+{
+    w.write_map_quad( om_addr, [&]( std::ostream & fout ) {
+        JsonOut jsout( fout );
+        jsout.start_array();
+        jsout.write( contents );
+        jsout.end_array();
+    } );
+}
+
+static std::optional<std::string> read_quad( world &w, const tripoint &om_addr )
+{
+    std::string contents;
+    const bool found = w.read_map_quad( om_addr, [&]( JsonIn & jsin ) {
+        jsin.start_array();
+        contents = jsin.get_string();
+        jsin.end_array();
+    }, []( std::istream & ) {
+        FAIL( "quad was not written in the binary format" );
+    } );
+    if( !found ) {
+        return std::nullopt;
+    }
+    return contents;
+}
+
+TEST_CASE( "prefetched_map_quads_read_like_direct_reads", "[map][savegame]" )
+{
+    world &w = *g->get_active_world();
+    const tripoint saved( 9001, -9001, 3 );
+    const tripoint changed( 9002, -9001, 3 );
+    const tripoint missing( 9003, -9001, 3 );
+    write_quad( w, saved, "saved" );
+    write_quad( w, changed, "old" );
+
+    w.prefetch_map_quads( { saved, changed, missing } );
+    write_quad( w, changed, "new" );
+
+    CHECK( read_quad( w, saved ) == "saved" );
+    CHECK( read_quad( w, changed ) == "new" );
+    CHECK( read_quad( w, missing ) == std::nullopt );
+
+    // Prefetched quads are handed out once, later reads go to the database again
+    write_quad( w, saved, "saved again" );
+    CHECK( read_quad( w, saved ) == "saved again" );
+}
@@ -0,0 +1,41 @@
+#include "catch/catch.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "coordinate_conversions.h"
+#include "mapbuffer.h"
+#include "point.h"
+#include "submap.h"
+
+TEST_CASE( "mapbuffer_finds_submaps_of_partial_quads", "[map]" )
+{
+    mapbuffer buffer;
+    // Both signs, so that quads straddling the origin are covered
+    const std::vector<tripoint> positions = {
+        { 0, 0, 0 }, { 1, 1, 0 }, { -1, 0, 0 }, { -1, -1, 0 }, { -2, -1, 0 }, { 5, -3, -2 }, { 5, -4, -2 }
+    };
+    for( const tripoint &p : positions ) {
+        auto sm = std::make_unique<submap>( sm_to_ms_copy( p ) );
+        const submap *added = sm.get();
+        REQUIRE( buffer.add_submap( p, sm ) );
+        CHECK( buffer.lookup_submap( p ) == added );
+    }
+    CHECK( buffer.size() == positions.size() );
+
+    for( const tripoint &p : positions ) {
+        CHECK( buffer.is_submap_loaded( p ) );
+    }
+    CHECK_FALSE( buffer.is_submap_loaded( { 1, 0, 0 } ) );
+    CHECK_FALSE( buffer.is_submap_loaded( { -2, -2, 0 } ) );
+    CHECK_FALSE( buffer.is_submap_loaded( { 5, -3, -1 } ) );
+
+    auto duplicate = std::make_unique<submap>( tripoint_zero );
+    CHECK_FALSE( buffer.add_submap( tripoint( -1, -1, 0 ), duplicate ) );
+    CHECK( duplicate != nullptr );
+    CHECK( buffer.size() == positions.size() );
+
+    buffer.clear();
+    CHECK( buffer.size() == 0 );
+    CHECK_FALSE( buffer.is_submap_loaded( tripoint_zero ) );
+}
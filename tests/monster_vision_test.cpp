@@ -1,6 +1,10 @@
 #include "catch/catch.hpp"
 
+#include <algorithm>
+#include <future>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "calendar.h"
 #include "game.h"
@@ -101,3 +105,48 @@ TEST_CASE( "monsters_dont_see_through_vehicle_holes", "[vision]" )
     CHECK( !outside.sees( inside ) );
 
 }
+
+TEST_CASE( "map_sees_gives_the_same_results_on_several_threads", "[vision]" )
+{
+    clear_all_state();
+    map &here = get_map();
+    // Scattered pillars, so that some of the lines are blocked
+    for( int x = 20; x < 100; x += 7 ) {
+        for( int y = 20; y < 100; y += 5 ) {
+            here.ter_set( tripoint( x + y % 3, y, 0 ), t_wall );
+        }
+    }
+    here.build_map_cache( 0 );
+
+    std::vector<std::pair<tripoint, tripoint>> lines;
+    for( int i = 0; i < 4000; i++ ) {
+        lines.emplace_back( tripoint( 20 + i % 80, 20 + i * 7 % 80, 0 ),
+                            tripoint( 20 + i * 13 % 80, 20 + i * 31 % 80, 0 ) );
+    }
+    const auto check_lines = [&here, &lines]() {
+        std::vector<bool> visible;
+        for( const auto &line : lines ) {
+            visible.push_back( here.sees( line.first, line.second, -1 ) );
+        }
+        return visible;
+    };
+
+    // All threads check the same lines, so they race on the same memo entries
+    std::vector<std::future<std::vector<bool>>> tasks;
+    for( int task = 0; task < 4; task++ ) {
+        tasks.push_back( std::async( std::launch::async, check_lines ) );
+    }
+    std::vector<std::vector<bool>> results;
+    for( std::future<std::vector<bool>> &task : tasks ) {
+        results.push_back( task.get() );
+    }
+
+    // Forget the memo, so that these are worked out again on one thread
+    here.set_seen_cache_dirty( 0 );
+    here.build_map_cache( 0 );
+    const std::vector<bool> expected = check_lines();
+    CHECK( std::ranges::count( expected, false ) > 0 );
+    for( const std::vector<bool> &result : results ) {
+        CHECK( result == expected );
+    }
+}
@@ -2,11 +2,17 @@
 
 #include <algorithm>
 #include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "calendar.h"
+#include "debug.h"
 #include "enums.h"
 #include "game_constants.h"
+#include "json.h"
+#include "mongroup.h"
 #include "numeric_interval.h"
 #include "omdata.h"
 #include "overmap.h"
@@ -39,6 +45,49 @@ TEST_CASE( "set_and_get_overmap_scents", "[overmap]" )
     REQUIRE( test_overmap->scent_at( { 75, 85, 0} ).initial_strength == 90 );
 }
 
+TEST_CASE( "horde_behaviour_is_saved_by_name", "[overmap]" )
+{
+    const std::pair<horde_behaviour, std::string> cases[] = {
+        { horde_behaviour::none, "" },
+        { horde_behaviour::city, "city" },
+        { horde_behaviour::roam, "roam" },
+        { horde_behaviour::nemesis, "nemesis" },
+    };
+    for( const auto &[behaviour, name] : cases ) {
+        CAPTURE( name );
+        mongroup saved( mongroup_id( "GROUP_ZOMBIE" ), tripoint_om_sm( 10, 20, 0 ), 1, 5 );
+        saved.horde = true;
+        saved.behaviour = behaviour;
+
+        std::ostringstream os;
+        JsonOut jsout( os );
+        saved.serialize( jsout );
+        // Hordes that haven't picked a behaviour yet don't save one
+        CHECK( ( os.str().find( "\"horde_behaviour\":\"" + name + "\"" ) != std::string::npos ) ==
+               !name.empty() );
+
+        std::istringstream is( os.str() );
+        JsonIn jsin( is );
+        mongroup loaded;
+        loaded.deserialize( jsin );
+        CHECK( loaded.behaviour == behaviour );
+    }
+}
+
+TEST_CASE( "unknown_horde_behaviour_loads_as_none", "[overmap]" )
+{
+    std::istringstream is(
+        R"({"type":"GROUP_ZOMBIE","horde":true,"horde_behaviour":"from_some_mod"})" );
+    JsonIn jsin( is );
+    mongroup loaded;
+    const std::string dmsg = capture_debugmsg_during( [&]() {
+        loaded.deserialize( jsin );
+    } );
+    CHECK( dmsg.find( "from_some_mod" ) != std::string::npos );
+    CHECK( loaded.horde );
+    CHECK( loaded.behaviour == horde_behaviour::none );
+}
+
 TEST_CASE( "default_overmap_generation_always_succeeds", "[overmap][slow]" )
 {
     clear_all_state();
@@ -0,0 +1,181 @@
+#include "catch/catch.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "map.h"
+#include "map_helpers.h"
+#include "mapdata.h"
+#include "options_helpers.h"
+#include "pathfinding.h"
+#include "point.h"
+#include "state_helpers.h"
+#include "type_id.h"
+#include "units.h"
+#include "vehicle.h"
+
+static bool path_contains( const std::vector<tripoint> &path, const tripoint &p )
+{
+    return std::ranges::find( path, p ) != path.end();
+}
+
+static void test_d_map_follows_terrain_changes()
+{
+    map &here = get_map();
+
+    const tripoint from( 50, 60, 0 );
+    const tripoint to( 70, 60, 0 );
+    const tripoint gap( 60, 60, 0 );
+    // Straight line, both ends included
+    const size_t straight_length = 21;
+
+    for( int y = 40; y <= 80; y++ ) {
+        here.ter_set( tripoint( 60, y, 0 ), t_wall );
+    }
+    Pathfinding::clear_d_maps();
+
+    const std::vector<tripoint> around = Pathfinding::route( from, to );
+    REQUIRE( !around.empty() );
+    CHECK( around.back() == to );
+    CHECK( around.size() > straight_length );
+    Pathfinding::end_turn();
+
+    WHEN( "a hole is made in the wall" ) {
+        here.ter_set( gap, t_floor );
+        Pathfinding::end_turn();
+
+        THEN( "the route goes through the hole" ) {
+            const std::vector<tripoint> through = Pathfinding::route( from, to );
+            REQUIRE( !through.empty() );
+            CHECK( through.back() == to );
+            CHECK( path_contains( through, gap ) );
+            CHECK( through.size() == straight_length );
+
+            AND_WHEN( "the hole is walled up again" ) {
+                here.ter_set( gap, t_wall );
+                Pathfinding::end_turn();
+
+                THEN( "the route goes around the wall again" ) {
+                    const std::vector<tripoint> around_again = Pathfinding::route( from, to );
+                    REQUIRE( !around_again.empty() );
+                    CHECK( around_again.back() == to );
+                    CHECK_FALSE( path_contains( around_again, gap ) );
+                    CHECK( around_again.size() > straight_length );
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE( "pathfinding_d_map_follows_terrain_changes", "[pathfinding]" )
+{
+    clear_all_state();
+    build_test_map( t_floor );
+
+    SECTION( "incremental d_maps" ) {
+        override_option opt( "PATHFINDING_INCREMENTAL", "true" );
+        test_d_map_follows_terrain_changes();
+    }
+    SECTION( "d_maps rebuilt every turn" ) {
+        override_option opt( "PATHFINDING_INCREMENTAL", "false" );
+        test_d_map_follows_terrain_changes();
+    }
+}
+
+TEST_CASE( "pathfinding_hierarchical_route_is_contiguous", "[pathfinding]" )
+{
+    clear_all_state();
+    build_test_map( t_floor );
+    map &here = get_map();
+
+    const tripoint from( 30, 60, 0 );
+    const tripoint to( 100, 60, 0 );
+    const tripoint gap( 60, 70, 0 );
+    for( int y = 30; y <= 90; y++ ) {
+        if( y != gap.y ) {
+            here.ter_set( tripoint( 60, y, 0 ), t_wall );
+        }
+    }
+    Pathfinding::clear_d_maps();
+
+    RouteSettings route_settings;
+    route_settings.hierarchical_min_dist = 0.0;
+    const std::vector<tripoint> route = Pathfinding::route( from, to, std::nullopt, route_settings );
+
+    REQUIRE( !route.empty() );
+    CHECK( route.front() == from );
+    CHECK( route.back() == to );
+    CHECK( path_contains( route, gap ) );
+    for( size_t i = 1; i < route.size(); i++ ) {
+        CAPTURE( route[i - 1], route[i] );
+        CHECK( square_dist( route[i - 1], route[i] ) == 1 );
+        CHECK( here.passable( route[i] ) );
+    }
+}
+
+static void test_d_map_follows_vehicle_changes()
+{
+    map &here = get_map();
+
+    const tripoint from( 50, 60, 0 );
+    const tripoint to( 70, 60, 0 );
+    const tripoint gap( 60, 60, 0 );
+    // Straight line, both ends included
+    const size_t straight_length = 21;
+
+    for( int y = 40; y <= 80; y++ ) {
+        here.ter_set( tripoint( 60, y, 0 ), y == gap.y ? t_floor : t_wall );
+    }
+    Pathfinding::clear_d_maps();
+
+    const std::vector<tripoint> through = Pathfinding::route( from, to );
+    REQUIRE( !through.empty() );
+    CHECK( path_contains( through, gap ) );
+    CHECK( through.size() == straight_length );
+    Pathfinding::end_turn();
+
+    WHEN( "a vehicle part blocks the hole" ) {
+        vehicle *veh = here.add_vehicle( vproto_id( "none" ), gap, 0_degrees, 0, 0 );
+        REQUIRE( veh != nullptr );
+        REQUIRE( veh->install_part( point_zero, vpart_id( "frame_vertical" ), true ) >= 0 );
+        REQUIRE( veh->install_part( point_zero, vpart_id( "board_vertical" ), true ) >= 0 );
+        here.add_vehicle_to_cache( veh );
+        Pathfinding::end_turn();
+
+        THEN( "the route goes around the wall" ) {
+            const std::vector<tripoint> around = Pathfinding::route( from, to );
+            REQUIRE( !around.empty() );
+            CHECK( around.back() == to );
+            CHECK_FALSE( path_contains( around, gap ) );
+            CHECK( around.size() > straight_length );
+
+            AND_WHEN( "the vehicle is removed" ) {
+                Pathfinding::end_turn();
+                here.destroy_vehicle( veh );
+                Pathfinding::end_turn();
+
+                THEN( "the route goes through the hole again" ) {
+                    const std::vector<tripoint> through_again = Pathfinding::route( from, to );
+                    REQUIRE( !through_again.empty() );
+                    CHECK( path_contains( through_again, gap ) );
+                    CHECK( through_again.size() == straight_length );
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE( "pathfinding_d_map_follows_vehicle_changes", "[pathfinding]" )
+{
+    clear_all_state();
+    build_test_map( t_floor );
+
+    SECTION( "incremental d_maps" ) {
+        override_option opt( "PATHFINDING_INCREMENTAL", "true" );
+        test_d_map_follows_vehicle_changes();
+    }
+    SECTION( "d_maps rebuilt every turn" ) {
+        override_option opt( "PATHFINDING_INCREMENTAL", "false" );
+        test_d_map_follows_vehicle_changes();
+    }
+}
@@ -9,8 +9,10 @@
 #include "map_helpers.h"
 #include "game.h" // Just for get_convection_temperature(), TODO: Remove
 #include "point.h"
+#include "rot.h"
 #include "units_temperature.h"
 #include "weather.h"
+#include "weather_gen.h"
 
 static const furn_str_id f_atomic_freezer( "f_atomic_freezer" );
 
@@ -204,3 +206,88 @@ TEST_CASE( "Items don't rot away on map load if in a freezer" )
     auto normal_stack_after = m.i_at( normal_pnt );
     REQUIRE( normal_stack_after.empty() );
 }
+
+TEST_CASE( "Rot catch-up integrates hourly temperatures of the submap" )
+{
+    const weather_generator &wgen = get_weather().get_cur_weather_gen();
+    const unsigned int seed = 42;
+    const tripoint_abs_ms location( 1200, 1200, 0 );
+    const time_point hour_start = calendar::turn_zero + 30_days;
+    const time_point from = hour_start + 17_minutes;
+    const time_point to = from + 7_days;
+    rot::clear_temperature_timelines();
+
+    const auto points = [&]( const tripoint_abs_ms & where, temperature_flag flag, time_point a,
+    time_point b ) {
+        return rot::rot_points_between( wgen, seed, where, 0_c, flag, a, b );
+    };
+
+    // Every hour uses the temperature at its start
+    const units::temperature first_temperature = wgen.get_weather_temperature( location, hour_start,
+            calendar::config, seed );
+    CHECK( points( location, temperature_flag::TEMP_NORMAL, hour_start, hour_start + 1_hours ) ==
+           Approx( get_hourly_rotpoints_at_temp( first_temperature ) ) );
+    CHECK( points( location, temperature_flag::TEMP_NORMAL, hour_start, hour_start + 30_minutes ) ==
+           Approx( get_hourly_rotpoints_at_temp( first_temperature ) / 2.0 ) );
+
+    // Stretches of time add up, however they are split
+    const double whole = points( location, temperature_flag::TEMP_NORMAL, from, to );
+    const time_point middle = from + 3_days + 5_hours + 41_minutes;
+    CHECK( whole > 0.0 );
+    CHECK( points( location, temperature_flag::TEMP_NORMAL, from, middle ) +
+           points( location, temperature_flag::TEMP_NORMAL, middle, to ) == Approx( whole ) );
+    CHECK( points( location, temperature_flag::TEMP_NORMAL, from - 2_days, to ) > whole );
+    // Long stretches are spread over several timelines
+    const time_point long_after = to + 90_days;
+    CHECK( points( location, temperature_flag::TEMP_NORMAL, from, to ) +
+           points( location, temperature_flag::TEMP_NORMAL, to, long_after ) ==
+           Approx( points( location, temperature_flag::TEMP_NORMAL, from, long_after ) ) );
+
+    // Tiles of the same submap share the temperatures
+    CHECK( points( location + tripoint( 5, 7, 0 ), temperature_flag::TEMP_NORMAL, from, to ) == whole );
+
+    CHECK( points( location, temperature_flag::TEMP_FREEZER, from, to ) == 0.0 );
+    CHECK( points( location, temperature_flag::TEMP_ROOT_CELLAR, from, to ) ==
+           Approx( get_hourly_rotpoints_at_temp( temperatures::root_cellar ) * ( ( to - from ) / 1_hours ) ) );
+}
+
+TEST_CASE( "Rot catch-up is only skipped for items already past twice their shelf life" )
+{
+    weather_manager &weather = get_weather();
+    const tripoint pos = tripoint_zero;
+    ensure_no_temperature_mods( pos );
+    calendar::turn = calendar::start_of_cataclysm + 1_minutes;
+    rot::clear_temperature_timelines();
+
+    const time_point start = calendar::turn;
+    const time_point now = start + 10_days;
+    const double points = rot::rot_points_between( weather.get_cur_weather_gen(), g->get_seed(),
+                          tripoint_abs_ms( get_map().getabs( pos ) ), 0_c, temperature_flag::TEMP_HEATER,
+                          start, now - 1_hours );
+    REQUIRE( points > 0.0 );
+
+    // Sets the rot of a fresh item, then leaves it alone for the whole stretch
+    const auto catch_up = [&]( const double relative_rot ) {
+        calendar::turn = start;
+        detached_ptr<item> food = item::spawn( "meat_cooked" );
+        food->set_relative_rot( relative_rot );
+        const time_duration before = food->get_rot();
+        calendar::turn = now;
+        food = item::process_rot( std::move( food ), true, pos, nullptr,
+                                  temperature_flag::TEMP_HEATER, weather );
+        REQUIRE( food );
+        return std::make_pair( before, food->get_rot() );
+    };
+
+    // The catch-up is added in one go, so the cap isn't checked again part way through it.
+    // Once the item is past the cap the remaining hour isn't added on top.
+    SECTION( "Item below the cap gets all of the catch-up" ) {
+        const auto [before, after] = catch_up( 1.5 );
+        CHECK( to_turns<double>( after - before ) == Approx( points ).margin( 1 ) );
+    }
+
+    SECTION( "Item above the cap gets none of it" ) {
+        const auto [before, after] = catch_up( 2.01 );
+        CHECK( after == before );
+    }
+}
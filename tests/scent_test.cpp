@@ -4,8 +4,11 @@
 #include "map.h"
 #include "map_helpers.h"
 #include "game.h"
+#include "rng.h"
 #include "state_helpers.h"
 
+#include <algorithm>
+
 void old_scent_map_update( const tripoint &center, map &m,
                            std::array<std::array<int, MAPSIZE_Y>, MAPSIZE_X> &grscent );
 
@@ -42,7 +45,7 @@ void old_scent_map_update( const tripoint &center, map &m,
 
     // The new scent flag searching function. Should be wayyy faster than the old one.
     m.scent_blockers( monkey, point( scentmap_minx - 1, scentmap_miny - 1 ),
-                      point( scentmap_maxx + 1, scentmap_maxy + 1 ) );
+                      point( scentmap_maxx + 1, scentmap_maxy + 1 ), center.z );
 
     for( int x = 0; x < MAPSIZE_X; x++ ) {
         for( int y = 0; y < MAPSIZE_Y; y++ ) {
@@ -170,3 +173,259 @@ TEST_CASE( "scent_matches_old", "[.]" )
     }
 }
 
+
+using scent_grid = std::array<std::array<int, MAPSIZE_Y>, MAPSIZE_X>;
+
+// scent_map::update before its loops were restructured for vectorization
+static void scalar_scent_map_update( const tripoint &center, map &m, scent_grid &grscent )
+{
+    std::array<std::array<char, MAPSIZE_Y>, MAPSIZE_X> scent_transfer;
+
+    std::array < std::array < int, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > new_scent;
+    std::array < std::array < int, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > sum_3_scent_y;
+    std::array < std::array < char, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > squares_used_y;
+
+    diagonal_blocks( &blocked_cache )[MAPSIZE_X][MAPSIZE_Y] = m.access_cache(
+                center.z ).vehicle_obstructed_cache;
+
+    const int scentmap_minx = center.x - SCENT_RADIUS;
+    const int scentmap_maxx = center.x + SCENT_RADIUS;
+    const int scentmap_miny = center.y - SCENT_RADIUS;
+    const int scentmap_maxy = center.y + SCENT_RADIUS;
+
+    m.scent_blockers( scent_transfer, point( scentmap_minx - 1, scentmap_miny - 1 ),
+                      point( scentmap_maxx + 1, scentmap_maxy + 1 ), center.z );
+
+    for( int x = 0; x < SCENT_RADIUS * 2 + 3; ++x ) {
+        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
+            point abs( x + scentmap_minx - 1, y + scentmap_miny );
+            sum_3_scent_y[y][x] = 0;
+            squares_used_y[y][x] = 0;
+            for( int i = abs.y - 1; i <= abs.y + 1; ++i ) {
+                sum_3_scent_y[y][x] += scent_transfer[abs.x][i] * grscent[abs.x][i];
+                squares_used_y[y][x] += scent_transfer[abs.x][i];
+            }
+        }
+    }
+
+    for( int x = 1; x < SCENT_RADIUS * 2 + 2; ++x ) {
+        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
+            const point abs( x + scentmap_minx - 1, y + scentmap_miny );
+
+            int squares_used = squares_used_y[y][x - 1] + squares_used_y[y][x] + squares_used_y[y][x + 1];
+            int total = sum_3_scent_y[y][x - 1] + sum_3_scent_y[y][x] + sum_3_scent_y[y][x + 1];
+
+            if( blocked_cache[abs.x][abs.y].nw && scent_transfer[abs.x + 1][abs.y + 1] == 5 ) {
+                squares_used -= 4;
+                total -= 4 * grscent[abs.x + 1][abs.y + 1];
+            }
+            if( blocked_cache[abs.x][abs.y].ne && scent_transfer[abs.x - 1][abs.y + 1] == 5 ) {
+                squares_used -= 4;
+                total -= 4 * grscent[abs.x - 1][abs.y + 1];
+            }
+            if( blocked_cache[abs.x - 1][abs.y - 1].nw && scent_transfer[abs.x - 1][abs.y - 1] == 5 ) {
+                squares_used -= 4;
+                total -= 4 * grscent[abs.x - 1][abs.y - 1];
+            }
+            if( blocked_cache[abs.x + 1][abs.y - 1].ne && scent_transfer[abs.x + 1][abs.y - 1] == 5 ) {
+                squares_used -= 4;
+                total -= 4 * grscent[abs.x + 1][abs.y - 1];
+            }
+
+            int temp_scent = grscent[abs.x][abs.y] * ( 250 - squares_used * scent_transfer[abs.x][abs.y] );
+            temp_scent -= grscent[abs.x][abs.y] * scent_transfer[abs.x][abs.y] * ( 45 - squares_used ) / 5;
+
+            new_scent[y][x] = ( temp_scent + total * scent_transfer[abs.x][abs.y] ) / 250;
+        }
+    }
+    for( int x = 1; x < SCENT_RADIUS * 2 + 2; ++x ) {
+        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
+            if( ( get_map().has_flag( TFLAG_LIQUID, center ) &&
+                  rl_dist( center, tripoint( point( x + scentmap_minx - 1, y + scentmap_miny ),
+                                             g->get_levz() ) ) <= 8 ) ||
+                !get_map().has_flag( TFLAG_LIQUID, point( x + scentmap_minx - 1, y + scentmap_miny ) ) ) {
+                grscent[x + scentmap_minx - 1 ][y + scentmap_miny] = new_scent[y][x];
+            }
+        }
+    }
+}
+
+// Random scent around the player, walls that block and reduce scent and a pond.
+// There's a roof over it all, so no scent rises to the level above.
+static scent_grid scatter_scent( const tripoint &origin )
+{
+    map &here = get_map();
+    for( int x = origin.x - SCENT_RADIUS - 2; x <= origin.x + SCENT_RADIUS + 2; x++ ) {
+        for( int y = origin.y - SCENT_RADIUS - 2; y <= origin.y + SCENT_RADIUS + 2; y++ ) {
+            here.ter_set( tripoint( x, y, origin.z + 1 ), t_floor );
+        }
+    }
+    for( int i = 0; i < 6; i++ ) {
+        here.ter_set( origin + point( -3, i - 3 ), t_brick_wall );
+        here.ter_set( origin + point( 4, i - 3 ), t_rock_wall_half );
+        here.ter_set( origin + point( i + 10, 8 ), t_water_dp );
+    }
+
+    scent_grid expected;
+    for( auto &column : expected ) {
+        column.fill( 0 );
+    }
+    g->scent.reset();
+    for( int x = origin.x - SCENT_RADIUS - 2; x <= origin.x + SCENT_RADIUS + 2; x++ ) {
+        for( int y = origin.y - SCENT_RADIUS - 2; y <= origin.y + SCENT_RADIUS + 2; y++ ) {
+            const int value = rng( 0, 1000 );
+            g->scent.set( tripoint( x, y, origin.z ), value, scenttype_id( "sc_human" ) );
+            expected[x][y] = value;
+        }
+    }
+    return expected;
+}
+
+TEST_CASE( "scent_diffusion_matches_scalar_loops", "[scent]" )
+{
+    clear_all_state();
+    const tripoint origin( 60, 60, 0 );
+    g->place_player( origin );
+    map &here = get_map();
+    scent_grid expected = scatter_scent( origin );
+
+    for( int turn = 0; turn < 3; turn++ ) {
+        g->scent.update( origin, here );
+        scalar_scent_map_update( origin, here, expected );
+    }
+
+    int mismatches = 0;
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            if( g->scent.get( tripoint( x, y, origin.z ) ) != std::max( expected[x][y], 0 ) ) {
+                mismatches++;
+            }
+        }
+    }
+    CHECK( mismatches == 0 );
+}
+
+TEST_CASE( "scent_diffusion_benchmark", "[.][scent][benchmark]" )
+{
+    clear_all_state();
+    const tripoint origin( 60, 60, 0 );
+    g->place_player( origin );
+    map &here = get_map();
+    scent_grid expected = scatter_scent( origin );
+
+    BENCHMARK( "scalar" ) {
+        scalar_scent_map_update( origin, here, expected );
+        return expected[origin.x][origin.y];
+    };
+    BENCHMARK( "vectorized" ) {
+        g->scent.update( origin, here );
+        return g->scent.get( origin );
+    };
+
+    // Open air above and a basement below, all of them with scent on them
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            here.ter_set( tripoint( x, y, origin.z + 1 ), t_open_air );
+            g->scent.set( tripoint( x, y, origin.z + 1 ), rng( 0, 1000 ) );
+            g->scent.set( tripoint( x, y, origin.z - 1 ), rng( 0, 1000 ) );
+        }
+    }
+    here.ter_set( origin + tripoint_east, t_stairs_down );
+    here.ter_set( origin + tripoint( 1, 0, -1 ), t_stairs_up );
+    BENCHMARK( "vectorized, three z-levels" ) {
+        g->scent.update( origin, here );
+        return g->scent.get( origin );
+    };
+}
+
+TEST_CASE( "scent_spreads_between_z_levels", "[scent]" )
+{
+    clear_all_state();
+    const tripoint origin( 60, 60, 0 );
+    const tripoint stairs = origin + point( 5, 0 );
+    const tripoint upstairs = stairs + tripoint_above;
+    // Far from the stairs, but close enough to the player for scent to reach it
+    const tripoint far_upstairs = origin + tripoint( -5, 0, 1 );
+    g->place_player( origin );
+    map &here = get_map();
+
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            here.ter_set( tripoint( x, y, origin.z ), t_floor );
+            here.ter_set( tripoint( x, y, origin.z + 1 ), t_floor );
+        }
+    }
+    g->scent.reset();
+
+    const auto lay_scent = [&]() {
+        for( int turn = 0; turn < 20; turn++ ) {
+            g->scent.set( origin, 500, scenttype_id( "sc_human" ) );
+            g->scent.update( origin, here );
+        }
+    };
+
+    WHEN( "the levels aren't connected" ) {
+        lay_scent();
+        THEN( "the level above has no scent" ) {
+            CHECK( g->scent.get( stairs ) > 0 );
+            CHECK( g->scent.get( upstairs ) == 0 );
+            CHECK( g->scent.get( far_upstairs ) == 0 );
+        }
+    }
+    WHEN( "stairs lead up" ) {
+        here.ter_set( stairs, t_stairs_up );
+        here.ter_set( upstairs, t_stairs_down );
+        lay_scent();
+        THEN( "scent goes up the stairs and spreads from there" ) {
+            CHECK( g->scent.get( upstairs ) > 0 );
+            CHECK( g->scent.get( upstairs ) < g->scent.get( stairs ) );
+            CHECK( g->scent.get( upstairs + point_east ) > 0 );
+            CHECK( g->scent.get( far_upstairs ) < g->scent.get( upstairs ) );
+            CHECK( g->scent.get_type( upstairs ) == scenttype_id( "sc_human" ) );
+        }
+    }
+    WHEN( "the level above is open air" ) {
+        for( int x = 0; x < MAPSIZE_X; x++ ) {
+            for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                here.ter_set( tripoint( x, y, origin.z + 1 ), t_open_air );
+            }
+        }
+        lay_scent();
+        THEN( "scent rises above the player" ) {
+            CHECK( g->scent.get( origin + tripoint_above ) > 0 );
+            CHECK( g->scent.get( far_upstairs ) > 0 );
+        }
+    }
+}
+
+TEST_CASE( "scent_layers_survive_saving_and_decay", "[scent]" )
+{
+    clear_all_state();
+    scent_map &scent = g->scent;
+    scent.reset();
+    const tripoint surface( 60, 60, 0 );
+    const tripoint basement( 30, 90, -3 );
+    scent.set( surface, 5, scenttype_id( "sc_human" ) );
+    scent.set( basement, 2 );
+
+    scent_map loaded( *g );
+    loaded.deserialize( scent.serialize() );
+    loaded.deserialize( scent.serialize( true ), true );
+    CHECK( loaded.get( surface ) == 5 );
+    CHECK( loaded.get( basement ) == 2 );
+    CHECK( loaded.get( surface + tripoint_above ) == 0 );
+    CHECK( loaded.get( basement + point_east ) == 0 );
+
+    for( int turn = 0; turn < 2; turn++ ) {
+        loaded.decay();
+    }
+    CHECK( loaded.get( surface ) == 3 );
+    CHECK( loaded.get( basement ) == 0 );
+    loaded.shift( point_east );
+    CHECK( loaded.get( surface + point_west ) == 3 );
+
+    // Layers emptied by decay take scent again
+    loaded.set( basement, 4 );
+    loaded.decay();
+    CHECK( loaded.get( basement ) == 3 );
+}
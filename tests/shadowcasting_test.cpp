@@ -1,13 +1,18 @@
 #include "catch/catch.hpp"
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <cstdio>
+#include <cstring>
 #include <functional>
 #include <memory>
 #include <random>
+#include <type_traits>
 #include <vector>
 
+#include "cached_options.h"
+#include "cata_utility.h"
 #include "game_constants.h"
 #include "lightmap.h"
 #include "line.h" // For rl_dist.
@@ -664,6 +669,100 @@ TEST_CASE( "shadowcasting_float_quad_performance", "[.]" )
     shadowcasting_float_quad( 1000000, 100 );
 }
 
+TEST_CASE( "shadowcasting_run_length_simd_matches_scalar", "[shadowcasting]" )
+{
+    restore_on_out_of_scope<bool> restore_simd( simd_shadowcasting );
+    // Runs of a few values, so that runs end at every position within a group of four
+    std::vector<float> values( 400 );
+    std::uniform_int_distribution<int> distribution( 0, 7 );
+    for( float &value : values ) {
+        const int roll = distribution( rng_get_engine() );
+        value = roll == 0 ? LIGHT_TRANSPARENCY_SOLID : roll == 1 ? 0.5f : LIGHT_TRANSPARENCY_OPEN_AIR;
+    }
+
+    int mismatches = 0;
+    for( int start = 20; start < 380; start++ ) {
+        for( const int stride : { 1, -1, 3 } ) {
+            for( const int max_count : { 0, 1, 3, 4, 5, 8, 13, 20 } ) {
+                for( const float value : { values[start], LIGHT_TRANSPARENCY_SOLID } ) {
+                    simd_shadowcasting = true;
+                    const int simd = shadowcasting_run_length( &values[start], stride, max_count, value );
+                    simd_shadowcasting = false;
+                    const int scalar = shadowcasting_run_length( &values[start], stride, max_count, value );
+                    if( simd != scalar ) {
+                        mismatches++;
+                    }
+                }
+            }
+        }
+    }
+    CHECK( mismatches == 0 );
+}
+
+template<typename Out>
+static void cast_light_with_and_without_simd( Out( &simd )[MAPSIZE_X][MAPSIZE_Y],
+        Out( &scalar )[MAPSIZE_X][MAPSIZE_Y],
+        const float ( &transparency_cache )[MAPSIZE_X][MAPSIZE_Y],
+        const diagonal_blocks( &blocked_cache )[MAPSIZE_X][MAPSIZE_Y], const point &offset )
+{
+    restore_on_out_of_scope<bool> restore_simd( simd_shadowcasting );
+    const auto cast = [&]( Out( &output )[MAPSIZE_X][MAPSIZE_Y] ) {
+        std::fill_n( &output[0][0], MAPSIZE_X * MAPSIZE_Y, Out( 0.0f ) );
+        if constexpr( std::is_same_v<Out, float> ) {
+            castLightAll<float, float, sight_calc, sight_check, update_light, accumulate_transparency>(
+                output, transparency_cache, blocked_cache, offset );
+        } else {
+            castLightAllWithLookup<float, four_quadrants, sight_calc, sight_check, update_light_quadrants,
+                                   accumulate_transparency, sight_from_lookup>(
+                                       output, transparency_cache, blocked_cache, offset );
+        }
+    };
+    simd_shadowcasting = true;
+    cast( simd );
+    simd_shadowcasting = false;
+    cast( scalar );
+}
+
+TEST_CASE( "shadowcasting_simd_matches_scalar", "[shadowcasting]" )
+{
+    clear_all_state();
+    float transparency_cache[MAPSIZE_X][MAPSIZE_Y] = {{0}};
+    diagonal_blocks blocked_cache[MAPSIZE_X][MAPSIZE_Y] = {{{false, false}}};
+    randomly_fill_transparency( transparency_cache );
+    // Some partly transparent tiles and blocked diagonals, so that runs end for all kinds of reasons
+    std::uniform_int_distribution<int> distribution( 0, 15 );
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            const int roll = distribution( rng_get_engine() );
+            if( roll == 0 ) {
+                transparency_cache[x][y] = 0.2f;
+            } else if( roll == 1 ) {
+                blocked_cache[x][y] = { true, false };
+            } else if( roll == 2 ) {
+                blocked_cache[x][y] = { false, true };
+            }
+        }
+    }
+
+    for( const point &offset : {
+             point( 65, 65 ), point( 3, 70 ), point( 128, 9 )
+         } ) {
+        CAPTURE( offset );
+        {
+            static float simd[MAPSIZE_X][MAPSIZE_Y];
+            static float scalar[MAPSIZE_X][MAPSIZE_Y];
+            cast_light_with_and_without_simd( simd, scalar, transparency_cache, blocked_cache, offset );
+            CHECK( std::memcmp( simd, scalar, sizeof( simd ) ) == 0 );
+        }
+        {
+            static four_quadrants simd[MAPSIZE_X][MAPSIZE_Y];
+            static four_quadrants scalar[MAPSIZE_X][MAPSIZE_Y];
+            cast_light_with_and_without_simd( simd, scalar, transparency_cache, blocked_cache, offset );
+            CHECK( std::memcmp( simd, scalar, sizeof( simd ) ) == 0 );
+        }
+    }
+}
+
 // I'm not sure this will ever work.
 TEST_CASE( "bresenham_vs_shadowcasting", "[.]" )
 {
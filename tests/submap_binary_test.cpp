@@ -0,0 +1,85 @@
+#include "catch/catch.hpp"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "calendar.h"
+#include "coordinate_conversions.h"
+#include "game_constants.h"
+#include "item.h"
+#include "mapdata.h"
+#include "point.h"
+#include "submap.h"
+#include "submap_binary.h"
+#include "trap.h"
+
+static void check_same_tiles( const submap &expected, const submap &actual )
+{
+    int mismatches = 0;
+    for( int x = 0; x < SEEX; x++ ) {
+        for( int y = 0; y < SEEY; y++ ) {
+            const point p( x, y );
+            if( expected.get_ter( p ) != actual.get_ter( p ) ||
+                expected.get_furn( p ) != actual.get_furn( p ) ||
+                expected.get_trap( p ) != actual.get_trap( p ) ||
+                expected.get_radiation( p ) != actual.get_radiation( p ) ||
+                expected.get_items( p ).size() != actual.get_items( p ).size() ) {
+                mismatches++;
+            }
+        }
+    }
+    CHECK( mismatches == 0 );
+}
+
+TEST_CASE( "submap_binary_quad_roundtrip", "[submap][savegame]" )
+{
+    const tripoint first_pos( 10, 20, 0 );
+    const tripoint second_pos = first_pos + point_south;
+
+    submap first( sm_to_ms_copy( first_pos ) );
+    first.set_all_ter( t_dirt );
+    first.set_ter( point( 3, 4 ), t_wall );
+    first.set_ter( point( 11, 11 ), t_floor );
+    first.set_furn( point( 3, 5 ), f_chair );
+    first.set_trap( point( 7, 2 ), tr_beartrap );
+    first.set_radiation( point( 5, 5 ), 30 );
+    first.get_items( point( 2, 9 ) ).push_back( item::spawn( "rock" ) );
+    first.set_temperature( 42 );
+    first.last_touched = calendar::turn_zero + 5_days;
+
+    submap second( sm_to_ms_copy( second_pos ) );
+    second.set_all_ter( t_floor );
+    second.set_furn( point( 0, 0 ), f_chair );
+    second.set_radiation( point( 11, 0 ), 7 );
+
+    std::ostringstream out;
+    serialize_submap_quad( out, { { first_pos, &first }, { second_pos, &second } } );
+
+    SECTION( "submaps come back unchanged" ) {
+        std::istringstream in( out.str() );
+        std::vector<std::pair<tripoint, std::unique_ptr<submap>>> loaded = deserialize_submap_quad( in );
+        REQUIRE( loaded.size() == 2 );
+        CHECK( loaded[0].first == first_pos );
+        CHECK( loaded[1].first == second_pos );
+        check_same_tiles( first, *loaded[0].second );
+        check_same_tiles( second, *loaded[1].second );
+        CHECK( loaded[0].second->get_temperature() == 42 );
+        CHECK( loaded[0].second->last_touched == first.last_touched );
+        REQUIRE( loaded[0].second->get_items( point( 2, 9 ) ).size() == 1 );
+        CHECK( loaded[0].second->get_items( point( 2, 9 ) ).front()->typeId() == itype_id( "rock" ) );
+    }
+
+    SECTION( "truncated data is rejected" ) {
+        const std::string data = out.str();
+        std::istringstream in( data.substr( 0, data.size() / 2 ) );
+        CHECK_THROWS( deserialize_submap_quad( in ) );
+    }
+
+    SECTION( "other data is rejected" ) {
+        std::istringstream in( "[{\"version\":33}]" );
+        CHECK_THROWS( deserialize_submap_quad( in ) );
+    }
+}
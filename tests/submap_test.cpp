@@ -1,6 +1,8 @@
 #include "catch/catch.hpp"
 
 #include "submap.h"
+#include "calendar.h"
+#include "field_type.h"
 #include "game_constants.h"
 #include "int_id.h"
 #include "point.h"
@@ -90,3 +92,50 @@ TEST_CASE( "submap rotation", "[submap]" )
         }
     }
 }
+
+TEST_CASE( "submap_field_tiles_follow_processing_order", "[submap][field]" )
+{
+    field_tile_set tiles;
+    CHECK( tiles.next( 0 ) == -1 );
+
+    // Column by column, like the loop they replace
+    const point first( 0, SEEY - 1 );
+    const point second( 1, 0 );
+    const point last( SEEX - 1, SEEY - 1 );
+    tiles.mark( last );
+    tiles.mark( second );
+    tiles.mark( first );
+
+    int tile = tiles.next( 0 );
+    CHECK( field_tile_set::tile( tile ) == first );
+    // Marked during iteration, ahead of it
+    tiles.mark( point( 1, 5 ) );
+    tile = tiles.next( tile + 1 );
+    CHECK( field_tile_set::tile( tile ) == second );
+    tiles.unmark( second );
+    tile = tiles.next( tile + 1 );
+    CHECK( field_tile_set::tile( tile ) == point( 1, 5 ) );
+    tile = tiles.next( tile + 1 );
+    CHECK( field_tile_set::tile( tile ) == last );
+    CHECK( tiles.next( tile + 1 ) == -1 );
+
+    GIVEN( "a submap with a field in one corner" ) {
+        submap sm( tripoint_zero );
+        const point corner( SEEX - 1, 0 );
+        REQUIRE( sm.get_field( corner ).add_field( field_type_id( "fd_blood" ), 1, 0_turns ) );
+        sm.field_count = 1;
+        sm.field_tiles.mark( corner );
+
+        WHEN( "it gets rotated" ) {
+            sm.rotate( 1 );
+
+            THEN( "only the tile the field moved to is marked" ) {
+                const point rotated = corner.rotate( 1, { SEEX, SEEY } );
+                REQUIRE( sm.get_field( rotated ).displayed_field_type() );
+                CHECK( sm.field_tiles.is_marked( rotated ) );
+                CHECK_FALSE( sm.field_tiles.is_marked( corner ) );
+                CHECK( sm.field_tiles.next( field_tile_set::index( rotated ) + 1 ) == -1 );
+            }
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#include "catch/catch.hpp"
+
+#include <vector>
+
+#include "vehicle.h"
+#include "vehicle_move_queue.h"
+
+TEST_CASE( "vehicle_move_queue_picks_most_movement_left", "[vehicle]" )
+{
+    vehicle slow;
+    vehicle fast;
+    vehicle tied;
+    vehicle parked;
+    slow.of_turn = 1.0f;
+    fast.of_turn = 3.0f;
+    tied.of_turn = 1.0f;
+    parked.of_turn = 0.0f;
+
+    vehicle_move_queue queue;
+    queue.assign( { &slow, &fast, &tied, &parked } );
+
+    // Moving doesn't touch the queue, the lowered key is noticed when it comes up
+    CHECK( queue.next() == &fast );
+    fast.of_turn = 2.0f;
+    CHECK( queue.next() == &fast );
+    fast.of_turn = 0.5f;
+
+    // Ties go to the vehicle queued first
+    CHECK( queue.next() == &slow );
+    slow.of_turn = 0.0f;
+    CHECK( queue.next() == &tied );
+    tied.of_turn = 0.25f;
+
+    // Raised keys have to be announced
+    parked.of_turn = 0.75f;
+    CHECK( queue.next() == &fast );
+    queue.update( parked );
+    CHECK( queue.next() == &parked );
+    parked.of_turn = 0.0f;
+    CHECK( queue.next() == &fast );
+    fast.of_turn = 0.0f;
+    CHECK( queue.next() == &tied );
+    tied.of_turn = 0.0f;
+
+    CHECK( queue.next() == nullptr );
+    CHECK( queue.empty() );
+}
@@ -16,6 +16,7 @@
 #include "point.h"
 #include "state_helpers.h"
 #include "type_id.h"
+#include "veh_type.h"
 #include "vehicle.h"
 #include "vehicle_part.h"
 #include "vehicle_selector.h"
@@ -240,3 +241,40 @@ TEST_CASE( "Vehicle charging station", "[vehicle][power]" )
     }
 
 }
+
+TEST_CASE( "vehicle accessory drain follows toggles and removal", "[vehicle][power]" )
+{
+    clear_all_state();
+    build_test_map( ter_id( "t_pavement" ) );
+    map &here = get_map();
+
+    vehicle *veh_ptr = here.add_vehicle( vproto_id( "solar_panel_test" ), tripoint( 5, 5, 0 ),
+                                         0_degrees, 0, 0 );
+    REQUIRE( veh_ptr != nullptr );
+    REQUIRE( veh_ptr->total_accessory_epower_w() == 0 );
+
+    const int light = veh_ptr->install_part( point_zero, vpart_id( "aisle_lights" ), true );
+    REQUIRE( light >= 0 );
+    vehicle_part &pt = veh_ptr->part( light );
+    const int drain = pt.info().epower;
+    REQUIRE( drain < 0 );
+
+    pt.enabled = false;
+    CHECK( veh_ptr->total_accessory_epower_w() == 0 );
+    pt.enabled = true;
+    CHECK( veh_ptr->total_accessory_epower_w() == drain );
+
+    // The enabled light is drawn from the battery every turn
+    veh_ptr->charge_battery( 100, false );
+    const int charge = veh_ptr->fuel_left( fuel_type_battery );
+    REQUIRE( charge > 0 );
+    for( int i = 0; i < to_turns<int>( 1_hours ); i++ ) {
+        veh_ptr->power_parts();
+    }
+    CHECK( veh_ptr->fuel_left( fuel_type_battery ) < charge );
+
+    REQUIRE( veh_ptr->remove_part( light ) );
+    CHECK( veh_ptr->total_accessory_epower_w() == 0 );
+    veh_ptr->part_removal_cleanup();
+    CHECK( veh_ptr->total_accessory_epower_w() == 0 );
+}